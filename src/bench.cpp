@@ -0,0 +1,655 @@
+//Reproducible microbenchmarks for the forward, backward and json paths
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>   //getrusage()
+#include <chrono>           //std::chrono::steady_clock
+#include <functional>       //std::function
+#include <algorithm>        //std::sort()
+#include <string>           //std::string
+#include <vector>           //std::vector
+
+#include "neural_net/network.hpp"
+#include "neural_net/kernels.hpp"
+#include "neural_net/reader.hpp"
+#include "neural_net/writer.hpp"
+#include "neural_net/stream_reader.hpp"
+#include "neural_net/stream_writer.hpp"
+#include "neural_net/quantized_network.hpp"
+#include "neural_net/activation.hpp"
+#include "neural_net/hogwild_trainer.hpp"
+
+//Seed for the weights and samples so every run measures the same network
+#define BENCH_SEED 1
+//Distinct samples the forward and backward passes cycle through
+#define BENCH_SAMPLES 16
+//Times each measurement is repeated, the median repeat is reported
+#define BENCH_REPEATS 5
+//Shortest time in seconds a single repeat runs for
+#define BENCH_REPEAT_TIME 0.1
+//Graph storage is only measured on networks with at most this many connections
+#define BENCH_GRAPH_CONNECTIONS 100000
+//Percent of connections kept in sparse networks, the rest are treated as pruned
+#define BENCH_SPARSE_DENSITY 10
+//Json is only measured on networks with at most this many connections
+#define BENCH_JSON_CONNECTIONS 500000
+//Precision reported for quantized networks, past the NEURAL_PRECISION_* identifiers
+#define BENCH_PRECISION_INT8 3
+//Sums each activation is timed over, spread across the range where outputs are not yet saturated
+#define BENCH_ACTIVATION_VALUES 4096
+#define BENCH_ACTIVATION_RANGE  6.0
+//Spacing of the sums an activation's error is checked at, from -BENCH_ERROR_RANGE to BENCH_ERROR_RANGE
+#define BENCH_ERROR_STEP  1e-5
+#define BENCH_ERROR_RANGE 20.0
+//Most threads lock-free training is measured on, starting from 1 and doubling
+#define BENCH_HOGWILD_THREADS 64
+
+#define TRAINING_RATE     0.15
+#define TRAINING_MOMENTUM 0.5
+static double deltaInputWeight(double neuronGradient_in, double weight_in, double deltaWeight_in, double inputNeuronValue_in)
+{
+  return TRAINING_RATE * inputNeuronValue_in * neuronGradient_in + TRAINING_MOMENTUM * deltaWeight_in;
+}
+
+static double activation(double value_in)
+{
+  return tanh(value_in);
+}
+
+static double activationDerivative(double value_in)
+{
+  return 1.0 - value_in * value_in;
+}
+
+//Topologies measured when none are given on the command line, smallest first so peak memory tracks the current network
+static const char* defaultTopologies[] = {
+  "3-4-3",
+  "64-64-10",
+  "256-256-10",
+  "784-512-10",
+  "1024-1024-100",
+  "4096-4096-1000",
+  NULL
+};
+
+//Printable names of the NEURAL_STORAGE_* and NEURAL_PRECISION_* identifiers
+static const char* storageName(unsigned storage_in)
+{
+  if (storage_in == NEURAL_STORAGE_DENSE) {
+    return "dense";
+  }
+  if (storage_in == NEURAL_STORAGE_SPARSE) {
+    return "sparse";
+  }
+  return "graph";
+}
+
+static const char* precisionName(unsigned precision_in)
+{
+  if (precision_in == NEURAL_PRECISION_FLOAT) {
+    return "float";
+  }
+  if (precision_in == NEURAL_PRECISION_MIXED) {
+    return "mixed";
+  }
+  if (precision_in == BENCH_PRECISION_INT8) {
+    return "int8";
+  }
+  return "double";
+}
+
+//Parses a topology of dash separated non-bias layer sizes
+static std::vector<unsigned> parseTopology(const char* text_in)
+{
+  std::vector<unsigned> topology;
+  char* end;
+  unsigned long size;
+
+  while (true) {
+    size = strtoul(text_in, &end, 10);
+    if (end == text_in || size == 0) {
+      throw std::runtime_error("Topologies are dash separated layer sizes such as 784-512-10");
+    }
+    topology.push_back(size);
+    if (*end == '\0') {
+      break;
+    }
+    if (*end != '-') {
+      throw std::runtime_error("Topologies are dash separated layer sizes such as 784-512-10");
+    }
+    text_in = end + 1;
+  }
+  if (topology.size() < 2) {
+    throw std::runtime_error("Topologies need at least an input and an output layer");
+  }
+  return topology;
+}
+
+//Counts the connections into every layer, bias neurons included as inputs
+static unsigned long long countConnections(const std::vector<unsigned> &topology_in)
+{
+  unsigned long long connections;
+  unsigned layerIterator;
+
+  connections = 0;
+  for (layerIterator = 1; layerIterator < topology_in.size(); ++layerIterator) {
+    connections += (unsigned long long) (topology_in[layerIterator - 1] + NEURAL_BIAS_NEURONS) * topology_in[layerIterator];
+  }
+  return connections;
+}
+
+//Bytes of one weight as held by a network
+static unsigned weightSize(unsigned storage_in, unsigned precision_in)
+{
+  if (storage_in == NEURAL_STORAGE_DENSE && precision_in != NEURAL_PRECISION_DOUBLE) {
+    return sizeof(float);
+  }
+  return sizeof(double);
+}
+
+//Largest resident set of the process so far in kilobytes
+static long peakResident()
+{
+  struct rusage usage;
+
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+//Seconds elapsed since a point in time
+static double secondsSince(std::chrono::steady_clock::time_point start_in)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_in).count();
+}
+
+/****************
+* Times an operation repeated enough times to outlast the clock
+* @param run_in      Runs the operation the requested number of times and returns the seconds spent on it
+* @param samples_out Location to store how many times each repeat ran the operation
+* @return Median seconds taken by a single run of the operation
+****************/
+static double measure(const std::function<double(unsigned)> &run_in, unsigned* samples_out)
+{
+  std::vector<double> repeats;
+  unsigned samples;
+  unsigned repeatIterator;
+  double seconds;
+
+  //Warm the caches and find how many runs fill a repeat
+  samples = 1;
+  while ((seconds = run_in(samples)) < BENCH_REPEAT_TIME) {
+    samples = seconds <= 0 ? samples * 2 : (unsigned) (samples * 1.2 * BENCH_REPEAT_TIME / seconds) + 1;
+  }
+
+  //Keep the median repeat so a single preemption does not skew the result
+  for (repeatIterator = 0; repeatIterator < BENCH_REPEATS; ++repeatIterator) {
+    repeats.push_back(run_in(samples) / samples);
+  }
+  std::sort(repeats.begin(), repeats.end());
+
+  *samples_out = samples;
+  return repeats[BENCH_REPEATS / 2];
+}
+
+/****************
+* Prints one measurement as a line of json
+* @param bench_in     Name of the measured operation
+* @param topology_in  Topology the network was built from
+* @param storage_in   NEURAL_STORAGE_* of the network
+* @param precision_in NEURAL_PRECISION_* of the network
+* @param samples_in   Runs of the operation in each repeat
+* @param seconds_in   Median seconds a single run took
+* @param bytes_in     Bytes of weights or json a single run moves
+* @param threads_in   Threads the operation ran on
+****************/
+static void report(const char* bench_in, const char* topology_in, unsigned storage_in, unsigned precision_in, unsigned samples_in, double seconds_in, double bytes_in, unsigned threads_in = 1)
+{
+  printf("{\"bench\":\"%s\",\"topology\":\"%s\",\"storage\":\"%s\",\"precision\":\"%s\",\"kernel\":\"%s\",\"threads\":%u,"
+         "\"samples\":%u,\"ns_per_sample\":%.1f,\"samples_per_sec\":%.1f,\"bytes_per_sample\":%.0f,\"gb_per_sec\":%.3f,\"peak_rss_kb\":%ld}\n",
+         bench_in, topology_in, storageName(storage_in), precisionName(precision_in), neural::kernels::name(neural::kernels::selected()), threads_in,
+         samples_in, seconds_in * 1e9, 1.0 / seconds_in, bytes_in, bytes_in / seconds_in / 1e9, peakResident());
+  fflush(stdout);
+}
+
+//Measures the forward and backward passes of one network
+static void benchPasses(const char* name_in, const std::vector<unsigned> &topology_in, unsigned storage_in, unsigned precision_in)
+{
+  std::vector<std::vector<double> > inputs;
+  std::vector<std::vector<double> > targets;
+  std::vector<double> results;
+  unsigned sampleIterator;
+  unsigned valueIterator;
+  unsigned samples;
+  unsigned layerIterator;
+  unsigned neuronIterator;
+  unsigned inputIterator;
+  unsigned rowInputs;
+  unsigned long long connections;
+  bool connected;
+  double seconds;
+  double weightBytes;
+  double backwardBytes;
+
+  srand(BENCH_SEED);
+  neural::Network net(topology_in, activation, activationDerivative, deltaInputWeight, storage_in, precision_in);
+
+  //Sparse networks keep a random share of the connections, and at least one per neuron so small layers are not left empty
+  if (storage_in == NEURAL_STORAGE_SPARSE) {
+    for (layerIterator = 1; layerIterator < topology_in.size(); ++layerIterator) {
+      rowInputs = topology_in[layerIterator - 1] + NEURAL_BIAS_NEURONS;
+      for (neuronIterator = 1; neuronIterator <= topology_in[layerIterator]; ++neuronIterator) {
+        connected = false;
+        for (inputIterator = 1; inputIterator <= rowInputs; ++inputIterator) {
+          if (rand() % 100 < BENCH_SPARSE_DENSITY) {
+            net.createConnection(layerIterator - 1, inputIterator, layerIterator, neuronIterator);
+            connected = true;
+          }
+        }
+        if (!connected) {
+          net.createConnection(layerIterator - 1, 1 + rand() % rowInputs, layerIterator, neuronIterator);
+        }
+      }
+      net.getLayer(layerIterator + 1)->compressSparse();
+    }
+  }
+
+  //Fixed samples spread over the range of the activation
+  inputs.resize(BENCH_SAMPLES);
+  targets.resize(BENCH_SAMPLES);
+  for (sampleIterator = 0; sampleIterator < BENCH_SAMPLES; ++sampleIterator) {
+    for (valueIterator = 0; valueIterator < topology_in.front(); ++valueIterator) {
+      inputs[sampleIterator].push_back(2.0 * rand() / RAND_MAX - 1.0);
+    }
+    for (valueIterator = 0; valueIterator < topology_in.back(); ++valueIterator) {
+      targets[sampleIterator].push_back(2.0 * rand() / RAND_MAX - 1.0);
+    }
+  }
+
+  //The forward pass reads every weight once, sparse weights are read along with their column
+  connections = countConnections(topology_in);
+  weightBytes = (double) connections * weightSize(storage_in, precision_in);
+  if (storage_in == NEURAL_STORAGE_SPARSE) {
+    weightBytes = 0;
+    for (layerIterator = 2; layerIterator <= net.numLayers(); ++layerIterator) {
+      weightBytes += (double) net.getLayer(layerIterator)->numConnections() * (sizeof(double) + sizeof(unsigned));
+    }
+  }
+
+  seconds = measure([&](unsigned samples_in) {
+    unsigned runIterator;
+    std::chrono::steady_clock::time_point start;
+
+    start = std::chrono::steady_clock::now();
+    for (runIterator = 0; runIterator < samples_in; ++runIterator) {
+      net.feedForward(inputs[runIterator % BENCH_SAMPLES]);
+    }
+    return secondsSince(start);
+  }, &samples);
+  report("forward", name_in, storage_in, precision_in, samples, seconds, weightBytes);
+
+  //Dense double networks are also measured quantized, calibrated on the same samples
+  if (storage_in == NEURAL_STORAGE_DENSE && precision_in == NEURAL_PRECISION_DOUBLE) {
+    neural::QuantizedNetwork quantized(&net, inputs, activation);
+
+    seconds = measure([&](unsigned samples_in) {
+      unsigned runIterator;
+      std::chrono::steady_clock::time_point start;
+
+      start = std::chrono::steady_clock::now();
+      for (runIterator = 0; runIterator < samples_in; ++runIterator) {
+        quantized.feedForward(inputs[runIterator % BENCH_SAMPLES]);
+      }
+      return secondsSince(start);
+    }, &samples);
+    report("forward", name_in, storage_in, BENCH_PRECISION_INT8, samples, seconds, quantized.weightBytes());
+  }
+
+  //Frozen copies keep only the weights and evaluate into caller owned scratch space
+  if (storage_in != NEURAL_STORAGE_GRAPH && precision_in == NEURAL_PRECISION_DOUBLE) {
+    neural::FrozenNetwork frozen = net.freeze();
+    std::vector<double> scratch(frozen.scratchSize());
+
+    seconds = measure([&](unsigned samples_in) {
+      unsigned runIterator;
+      std::chrono::steady_clock::time_point start;
+
+      start = std::chrono::steady_clock::now();
+      for (runIterator = 0; runIterator < samples_in; ++runIterator) {
+        frozen.feedForward(inputs[runIterator % BENCH_SAMPLES].data(), scratch.data());
+      }
+      return secondsSince(start);
+    }, &samples);
+    report("frozen_forward", name_in, storage_in, precision_in, samples, seconds, frozen.weightBytes());
+  }
+
+  //The backward pass reads and writes every weight and delta weight, and reads all but the first layer's weights for the gradients
+  backwardBytes = 4.0 * weightBytes;
+  for (layerIterator = 2; layerIterator < topology_in.size(); ++layerIterator) {
+    if (storage_in == NEURAL_STORAGE_SPARSE) {
+      backwardBytes += (double) net.getLayer(layerIterator + 1)->numConnections() * (sizeof(double) + sizeof(unsigned));
+      continue;
+    }
+    backwardBytes += (double) (topology_in[layerIterator - 1] + NEURAL_BIAS_NEURONS) * topology_in[layerIterator] * weightSize(storage_in, precision_in);
+  }
+
+  seconds = measure([&](unsigned samples_in) {
+    unsigned runIterator;
+    double spent;
+    std::chrono::steady_clock::time_point start;
+
+    //Each backward pass needs its own forward pass, which is left out of the time
+    spent = 0;
+    for (runIterator = 0; runIterator < samples_in; ++runIterator) {
+      net.feedForward(inputs[runIterator % BENCH_SAMPLES]);
+      start = std::chrono::steady_clock::now();
+      net.backPropagation(targets[runIterator % BENCH_SAMPLES]);
+      spent += secondsSince(start);
+    }
+    return spent;
+  }, &samples);
+  report("backward", name_in, storage_in, precision_in, samples, seconds, backwardBytes);
+
+  //Keep the results alive so the passes cannot be optimized away
+  net.getResults(results);
+  if (std::isnan(results[0])) {
+    fprintf(stderr, "%s produced NaN\n", name_in);
+  }
+}
+
+/****************
+* Measures lock-free training of one dense network on 1, 2, 4 ... BENCH_HOGWILD_THREADS threads
+*   Each thread count starts from the same weights, samples_per_sec is what should grow with the threads
+****************/
+static void benchHogwild(const char* name_in, const std::vector<unsigned> &topology_in, unsigned precision_in)
+{
+  std::vector<std::vector<double> > inputs;
+  std::vector<std::vector<double> > targets;
+  std::vector<const double*> valueRows;
+  std::vector<const double*> targetRows;
+  unsigned threads;
+  unsigned sampleIterator;
+  unsigned valueIterator;
+  unsigned samples;
+  double seconds;
+  double bytes;
+
+  //Fixed samples spread over the range of the activation
+  srand(BENCH_SEED);
+  inputs.resize(BENCH_SAMPLES);
+  targets.resize(BENCH_SAMPLES);
+  for (sampleIterator = 0; sampleIterator < BENCH_SAMPLES; ++sampleIterator) {
+    for (valueIterator = 0; valueIterator < topology_in.front(); ++valueIterator) {
+      inputs[sampleIterator].push_back(2.0 * rand() / RAND_MAX - 1.0);
+    }
+    for (valueIterator = 0; valueIterator < topology_in.back(); ++valueIterator) {
+      targets[sampleIterator].push_back(2.0 * rand() / RAND_MAX - 1.0);
+    }
+  }
+
+  //Every sample reads the weights forward and back and reads and writes them with their deltas in the update
+  bytes = 6.0 * countConnections(topology_in) * weightSize(NEURAL_STORAGE_DENSE, precision_in);
+
+  for (threads = 1; threads <= BENCH_HOGWILD_THREADS; threads *= 2) {
+    neural::Network net(topology_in, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_DENSE, precision_in);
+    neural::HogwildTrainer trainer(&net, threads);
+
+    seconds = measure([&](unsigned samples_in) {
+      unsigned rowIterator;
+      std::chrono::steady_clock::time_point start;
+
+      //Cycle through the fixed samples, pointing at them in place
+      valueRows.resize(samples_in);
+      targetRows.resize(samples_in);
+      for (rowIterator = 0; rowIterator < samples_in; ++rowIterator) {
+        valueRows[rowIterator] = inputs[rowIterator % BENCH_SAMPLES].data();
+        targetRows[rowIterator] = targets[rowIterator % BENCH_SAMPLES].data();
+      }
+      start = std::chrono::steady_clock::now();
+      trainer.train(valueRows.data(), targetRows.data(), samples_in);
+      return secondsSince(start);
+    }, &samples);
+    report("hogwild_train", name_in, NEURAL_STORAGE_DENSE, precision_in, samples, seconds, bytes, threads);
+  }
+}
+
+/****************
+* Measures the throughput and largest error of one activation policy against the exact function
+* @param name_in    Name printed for the policy
+* @param sigmoid_in Whether the policy approximates the logistic function instead of tanh
+****************/
+template<class Activation> static void benchActivation(const char* name_in, bool sigmoid_in)
+{
+  std::vector<double> sums;
+  std::vector<double> outputs;
+  unsigned samples;
+  unsigned valueIterator;
+  double seconds;
+  double sum;
+  double exact;
+  double largest;
+
+  //Sums spread evenly over both sides of the curve
+  for (valueIterator = 0; valueIterator < BENCH_ACTIVATION_VALUES; ++valueIterator) {
+    sums.push_back(BENCH_ACTIVATION_RANGE * (2.0 * valueIterator / (BENCH_ACTIVATION_VALUES - 1) - 1.0));
+  }
+  outputs.resize(BENCH_ACTIVATION_VALUES);
+
+  seconds = measure([&](unsigned samples_in) {
+    unsigned runIterator;
+    unsigned entryIterator;
+    std::chrono::steady_clock::time_point start;
+
+    start = std::chrono::steady_clock::now();
+    for (runIterator = 0; runIterator < samples_in; ++runIterator) {
+      for (entryIterator = 0; entryIterator < BENCH_ACTIVATION_VALUES; ++entryIterator) {
+        outputs[entryIterator] = Activation::value(sums[entryIterator]);
+      }
+    }
+    return secondsSince(start);
+  }, &samples);
+
+  //Largest distance from the exact function, tanh and the logistic function saturate well inside the range checked
+  largest = 0;
+  for (sum = -BENCH_ERROR_RANGE; sum <= BENCH_ERROR_RANGE; sum += BENCH_ERROR_STEP) {
+    exact = sigmoid_in ? 1.0 / (1.0 + exp(-sum)) : tanh(sum);
+    largest = std::max(largest, fabs(Activation::value(sum) - exact));
+  }
+
+  printf("{\"bench\":\"activation\",\"function\":\"%s\",\"samples\":%u,\"ns_per_value\":%.3f,\"values_per_sec\":%.1f,\"max_error\":%.3g}\n",
+         name_in, samples, seconds * 1e9 / BENCH_ACTIVATION_VALUES, BENCH_ACTIVATION_VALUES / seconds, largest);
+  fflush(stdout);
+}
+
+//Measures reading and writing one dense network as json
+static void benchJson(const char* name_in, const std::vector<unsigned> &topology_in, unsigned precision_in)
+{
+  FILE* file;
+  unsigned samples;
+  double seconds;
+  double bytes;
+
+  srand(BENCH_SEED);
+  neural::Network net(topology_in, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_DENSE, precision_in);
+
+  //Json every reader parses
+  file = tmpfile();
+  if (file == NULL) {
+    throw std::runtime_error("Unable to create a temporary file");
+  }
+  StreamWriter(file).write(&net);
+  fflush(file);
+  bytes = ftell(file);
+
+  //Document reader, walking every entry it parsed
+  seconds = measure([&](unsigned samples_in) {
+    unsigned runIterator;
+    neuron_data neuron;
+    connection_data connection;
+    std::chrono::steady_clock::time_point start;
+
+    start = std::chrono::steady_clock::now();
+    for (runIterator = 0; runIterator < samples_in; ++runIterator) {
+      rewind(file);
+      Reader reader(file);
+      while (reader.hasLayer()) {
+        reader.getLayer();
+      }
+      while (reader.hasNeuron()) {
+        reader.getNeuron(&neuron);
+      }
+      while (reader.hasConnection()) {
+        reader.getConnection(&connection);
+      }
+    }
+    return secondsSince(start);
+  }, &samples);
+  report("json_read", name_in, NEURAL_STORAGE_DENSE, precision_in, samples, seconds, bytes);
+
+  //Streaming reader, building the network as it parses
+  seconds = measure([&](unsigned samples_in) {
+    unsigned runIterator;
+    std::chrono::steady_clock::time_point start;
+
+    start = std::chrono::steady_clock::now();
+    for (runIterator = 0; runIterator < samples_in; ++runIterator) {
+      neural::Network loaded;
+      rewind(file);
+      StreamReader(file).read(&loaded, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_DENSE);
+    }
+    return secondsSince(start);
+  }, &samples);
+  report("json_stream_read", name_in, NEURAL_STORAGE_DENSE, precision_in, samples, seconds, bytes);
+
+  //Document writer, fed the same entries the streaming writer visits
+  seconds = measure([&](unsigned samples_in) {
+    unsigned runIterator;
+    unsigned layerIterator;
+    unsigned neuronIterator;
+    unsigned inputIterator;
+    neural::Layer* layer;
+    neuron_data neuron;
+    connection_data connection;
+    std::chrono::steady_clock::time_point start;
+
+    start = std::chrono::steady_clock::now();
+    for (runIterator = 0; runIterator < samples_in; ++runIterator) {
+      rewind(file);
+      Writer writer(file);
+      for (layerIterator = 1; layerIterator <= net.numLayers(); ++layerIterator) {
+        writer.addLayer(net.getLayer(layerIterator)->numNeurons());
+      }
+      for (layerIterator = 1; layerIterator <= net.numLayers(); ++layerIterator) {
+        layer = net.getLayer(layerIterator);
+        neuron.neuron.layer = layerIterator - 1;
+        for (neuronIterator = 1; neuronIterator <= layer->numNeurons(); ++neuronIterator) {
+          neuron.neuron.neuron = neuronIterator - 1;
+          layer->getNeuron(neuronIterator)->getData(&neuron);
+          writer.addNeuron(neuron);
+        }
+      }
+      for (layerIterator = 2; layerIterator <= net.numLayers(); ++layerIterator) {
+        layer = net.getLayer(layerIterator);
+        connection.source.layer = layerIterator - 2;
+        connection.destination.layer = layerIterator - 1;
+        for (neuronIterator = 0; neuronIterator < layer->numNeurons() - layer->numBias(); ++neuronIterator) {
+          connection.destination.neuron = neuronIterator;
+          for (inputIterator = 0; inputIterator < layer->numInputs(); ++inputIterator) {
+            connection.source.neuron = inputIterator;
+            connection.weight = layer->getWeight(neuronIterator, inputIterator);
+            connection.deltaWeight = layer->getDeltaWeight(neuronIterator, inputIterator);
+            writer.addConnection(connection);
+          }
+        }
+      }
+      writer.commitTopology();
+      writer.commitNeurons();
+      writer.commitConnections();
+      writer.write();
+      fflush(file);
+    }
+    return secondsSince(start);
+  }, &samples);
+  report("json_write", name_in, NEURAL_STORAGE_DENSE, precision_in, samples, seconds, bytes);
+
+  //Streaming writer
+  seconds = measure([&](unsigned samples_in) {
+    unsigned runIterator;
+    std::chrono::steady_clock::time_point start;
+
+    start = std::chrono::steady_clock::now();
+    for (runIterator = 0; runIterator < samples_in; ++runIterator) {
+      rewind(file);
+      StreamWriter(file).write(&net);
+      fflush(file);
+    }
+    return secondsSince(start);
+  }, &samples);
+  report("json_stream_write", name_in, NEURAL_STORAGE_DENSE, precision_in, samples, seconds, bytes);
+
+  fclose(file);
+}
+
+//Runs every benchmark over a matrix of topologies, printing one json object per line
+int main(int argc, char** argv)
+{
+  std::vector<const char*> names;
+  std::vector<unsigned> topology;
+  unsigned precision;
+  unsigned long long connections;
+  unsigned argIterator;
+  unsigned nameIterator;
+
+  //Arguments pick the weight precision and replace the default topologies
+  precision = NEURAL_PRECISION_DOUBLE;
+  for (argIterator = 1; argIterator < (unsigned) argc; ++argIterator) {
+    if (strcmp(argv[argIterator], "double") == 0) {
+      precision = NEURAL_PRECISION_DOUBLE;
+    } else if (strcmp(argv[argIterator], "float") == 0) {
+      precision = NEURAL_PRECISION_FLOAT;
+    } else if (strcmp(argv[argIterator], "mixed") == 0) {
+      precision = NEURAL_PRECISION_MIXED;
+    } else {
+      names.push_back(argv[argIterator]);
+    }
+  }
+  if (names.empty()) {
+    for (nameIterator = 0; defaultTopologies[nameIterator] != NULL; ++nameIterator) {
+      names.push_back(defaultTopologies[nameIterator]);
+    }
+  }
+
+  try {
+    //Activations are measured once, they do not depend on the topology
+    benchActivation<neural::activation::Tanh>("tanh", false);
+    benchActivation<neural::activation::TanhRational>("tanh_rational", false);
+    benchActivation<neural::activation::TanhRationalFine>("tanh_rational_fine", false);
+    benchActivation<neural::activation::TanhTable>("tanh_table", false);
+    benchActivation<neural::activation::Sigmoid>("sigmoid", true);
+    benchActivation<neural::activation::SigmoidRational>("sigmoid_rational", true);
+    benchActivation<neural::activation::SigmoidRationalFine>("sigmoid_rational_fine", true);
+    benchActivation<neural::activation::SigmoidTable>("sigmoid_table", true);
+
+    for (nameIterator = 0; nameIterator < names.size(); ++nameIterator) {
+      topology = parseTopology(names[nameIterator]);
+      connections = countConnections(topology);
+
+      //Dense storage is the default, graph storage is only practical on small networks
+      benchPasses(names[nameIterator], topology, NEURAL_STORAGE_DENSE, precision);
+      if (precision == NEURAL_PRECISION_DOUBLE) {
+        benchPasses(names[nameIterator], topology, NEURAL_STORAGE_SPARSE, precision);
+      }
+      if (connections <= BENCH_GRAPH_CONNECTIONS && precision == NEURAL_PRECISION_DOUBLE) {
+        benchPasses(names[nameIterator], topology, NEURAL_STORAGE_GRAPH, precision);
+      }
+      if (connections <= BENCH_JSON_CONNECTIONS) {
+        benchJson(names[nameIterator], topology, precision);
+      }
+      benchHogwild(names[nameIterator], topology, precision);
+    }
+  } catch (std::exception& error) {
+    fprintf(stderr, "%s\n", error.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "neural_net/binary_model.hpp"
+#include "neural_net/sample_reader.hpp"
+#include "neural_net/sample_writer.hpp"
+
+/****************
+* Converts csv samples into binary samples
+* @param argc Number of arguments
+* @param argv Program name, csv input, binary output, inputs, targets and optionally float or double
+****************/
+static int convertSamples(int argc, char** argv)
+{
+  FILE* file_in;
+  FILE* file_out;
+  unsigned scalarSize;
+  std::vector<double> inputs;
+  std::vector<double> targets;
+
+  if (argc != 5 && argc != 6) {
+    fprintf(stderr, "Usage: %s <samples.csv> <output> <inputs> <targets> [float|double]\n", argv[0]);
+    return 1;
+  }
+  scalarSize = argc == 6 && strcmp(argv[5], "double") == 0 ? sizeof(double) : sizeof(float);
+
+  file_in = fopen(argv[1], "r");
+  if (file_in == NULL) {
+    fprintf(stderr, "Unable to open %s\n", argv[1]);
+    return 1;
+  }
+  file_out = fopen(argv[2], "wb");
+  if (file_out == NULL) {
+    fprintf(stderr, "Unable to open %s\n", argv[2]);
+    fclose(file_in);
+    return 1;
+  }
+
+  try {
+    neural::SampleReader reader(file_in, NEURAL_SAMPLES_CSV, atoi(argv[3]), atoi(argv[4]));
+    neural::SampleWriter writer(file_out, reader.numInputs(), reader.numTargets(), scalarSize);
+
+    //Copy each sample across then record how many there were
+    inputs.resize(reader.numInputs());
+    targets.resize(reader.numTargets());
+    while (reader.read(inputs.data(), targets.data())) {
+      writer.write(inputs.data(), targets.data());
+    }
+    writer.finish();
+  } catch (std::exception& error) {
+    fprintf(stderr, "%s\n", error.what());
+    fclose(file_in);
+    fclose(file_out);
+    return 1;
+  }
+
+  fclose(file_in);
+  fclose(file_out);
+  return 0;
+}
+
+//Converts between json and binary networks based on the input file's extension, and csv samples into binary samples
+int main(int argc, char** argv)
+{
+  FILE* file_in;
+  FILE* file_out;
+  size_t length;
+  unsigned precision;
+
+  if (argc > 1 && neural::SampleReader::formatOf(argv[1]) == NEURAL_SAMPLES_CSV) {
+    return convertSamples(argc, argv);
+  }
+  if (argc != 3 && argc != 4) {
+    fprintf(stderr, "Usage: %s <input.json|input.bin> <output> [double|float|mixed]\n", argv[0]);
+    fprintf(stderr, "       %s <samples.csv> <output> <inputs> <targets> [float|double]\n", argv[0]);
+    return 1;
+  }
+
+  //Json converted to binary can be narrowed to single precision weights
+  precision = NEURAL_PRECISION_DOUBLE;
+  if (argc == 4) {
+    if (strcmp(argv[3], "float") == 0) {
+      precision = NEURAL_PRECISION_FLOAT;
+    } else if (strcmp(argv[3], "mixed") == 0) {
+      precision = NEURAL_PRECISION_MIXED;
+    } else if (strcmp(argv[3], "double") != 0) {
+      fprintf(stderr, "Unknown precision %s\n", argv[3]);
+      return 1;
+    }
+  }
+
+  file_out = fopen(argv[2], "wb");
+  if (file_out == NULL) {
+    fprintf(stderr, "Unable to open %s\n", argv[2]);
+    return 1;
+  }
+
+  try {
+    length = strlen(argv[1]);
+    //Json input is converted to binary, anything else is treated as binary
+    if (length > 5 && strcmp(argv[1] + length - 5, ".json") == 0) {
+      file_in = fopen(argv[1], "r");
+      if (file_in == NULL) {
+        throw std::runtime_error("Unable to open input file");
+      }
+      BinaryModel::fromJson(file_in, file_out, precision);
+      fclose(file_in);
+    } else {
+      BinaryModel::toJson(argv[1], file_out);
+    }
+  } catch (std::exception& error) {
+    fprintf(stderr, "%s\n", error.what());
+    fclose(file_out);
+    return 1;
+  }
+
+  fclose(file_out);
+  return 0;
+}
@@ -1,9 +1,14 @@
 #include "neural_net/reader.hpp"
-#include "neural_net/writer.hpp"
+#include "neural_net/stream_reader.hpp"
+#include "neural_net/stream_writer.hpp"
 #include "neural_net/network.hpp"
+#include "neural_net/sample_reader.hpp"
+#include "neural_net/dataset.hpp"
+#include "neural_net/mapped_samples.hpp"
 
 #define TRAINING_RATE     0.15
 #define TRAINING_MOMENTUM 0.5
+#define TRAINING_BATCH    32
 static double deltaInputWeight(double neuronGradient_in, double weight_in, double deltaWeight_in, double inputNeuronValue_in)
 {
   return TRAINING_RATE * inputNeuronValue_in * neuronGradient_in + TRAINING_MOMENTUM * deltaWeight_in;
@@ -21,41 +26,15 @@ static double activationDerivative(double value_in)
 
 void readNetwork(char* fileName, neural::Network* network_in)
 {
-  std::vector<unsigned> topology; //Defines the amount of layers, and amount of nodes at each layer
   FILE* file_in;                  //File to read network specifications from
-  neuron_data pn;
-  connection_data pc;
 
   //Open input file
-  file_in = fopen("net1.json", "r");
+  file_in = fopen(fileName, "r");
   //Create reader
-  Reader reader(file_in);
+  StreamReader reader(file_in);
 
-  //Read topology from file
-  while (reader.hasLayer()) {
-    topology.push_back(reader.getLayer());
-  }
-
-  //Create neural network from read topology
-  *network_in = neural::Network(topology, activation, activationDerivative, deltaInputWeight);
-
-  //Read file for neurons
-  while (reader.hasNeuron()) {
-    //Get the next unprocessed neuron
-    reader.getNeuron(&pn);
-    //Add new neuron to network
-    network_in->setNeuron(pn);
-  }  
-
-  //Read file for connections
-  while (reader.hasConnection()) {
-    //Get the next unprocessed connection
-    reader.getConnection(&pc);
-    //Add new connection to network
-    network_in->createConnection(pc);
-  }
-
-  
+  //Construct the network from the topology and fill in neurons and connections as they are parsed
+  reader.read(network_in, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_DENSE);
 
   fclose(file_in);
 }
@@ -63,42 +42,85 @@ void readNetwork(char* fileName, neural::Network* network_in)
 void writeNetwork(char* fileName, neural::Network* network_in)
 {
   FILE* file_out;
-  unsigned layerIterator;
-  unsigned neuronIterator;
-  unsigned layerSize;
-  neuron_data neuron;
 
   //Open output file
-  file_out = fopen("save1.json", "w");
+  file_out = fopen(fileName, "w");
   //Create writer
-  Writer writer(file_out);
-  
-  //Hit each layer
-  for (layerIterator = 1; layerIterator <= network_in->numLayers(); ++layerIterator) {
-    neuron.neuron.layer = layerIterator;
-    //Extract the size of the layer
-    layerSize = network_in->getLayer(layerIterator)->numNeurons();
-    //Add this layer to the topology
-    writer.addLayer(layerSize);
-    //Hit each neuron in the layer
-    for (neuronIterator = 1; neuronIterator <= layerSize ; ++neuronIterator) {
-      neuron.neuron.neuron = neuronIterator;
-      //Extract the data from the neuron
-      network_in->getLayer(layerIterator)->getNeuron(neuronIterator)->getData(&neuron);
-      writer.addNeuron(neuron);
+  StreamWriter writer(file_out);
+
+  //Write the topology, neurons and connections as they are visited
+  writer.write(network_in);
+
+  fclose(file_out);
+}
+
+void trainMappedNetwork(char* fileName, unsigned epochs_in, neural::Network* network_in)
+{
+  const sample_batch* batch;      //Batch of rows pointing into the mapped file
+  unsigned epochIterator;
+
+  try {
+    neural::MappedSamples samples(fileName, TRAINING_BATCH);
+    if (samples.numInputs() != network_in->inputLayer()->numNeurons() - network_in->inputLayer()->numBias() || samples.numTargets() != network_in->outputLayer()->numNeurons() - network_in->outputLayer()->numBias()) {
+      throw std::runtime_error("Sample file does not match the network");
+    }
+
+    //Train on every batch of every epoch, drawing a new order each epoch
+    for (epochIterator = 0; epochIterator < epochs_in; ++epochIterator) {
+      if (epochIterator > 0) {
+        samples.restart();
+      }
+      while ((batch = samples.next()) != NULL) {
+        network_in->trainBatch(batch);
+      }
+      printf("Epoch %u error %f\n", epochIterator + 1, network_in->getError());
     }
+  } catch (std::exception& error) {
+    fprintf(stderr, "%s\n", error.what());
   }
+}
 
-  //Commit the topology and neurons for writing
-  writer.commitTopology();
-  writer.commitNeurons();
-  //Write data to file
-  writer.write();
+void trainNetwork(char* fileName, unsigned epochs_in, neural::Network* network_in)
+{
+  FILE* file_in;                  //File to read training samples from
+  const sample_batch* batch;      //Batch of samples read ahead on the dataset's thread
+  unsigned epochIterator;
+
+  //Binary files are mapped and shuffled whole instead of streamed
+  if (neural::SampleReader::formatOf(fileName) == NEURAL_SAMPLES_BINARY) {
+    trainMappedNetwork(fileName, epochs_in, network_in);
+    return;
+  }
 
-  fclose(file_out);
+  //Open csv sample file
+  file_in = fopen(fileName, "rb");
+  if (file_in == NULL) {
+    fprintf(stderr, "Unable to open %s\n", fileName);
+    return;
+  }
+
+  try {
+    neural::SampleReader reader(file_in, NEURAL_SAMPLES_CSV, network_in->inputLayer()->numNeurons() - network_in->inputLayer()->numBias(), network_in->outputLayer()->numNeurons() - network_in->outputLayer()->numBias());
+    neural::Dataset dataset(&reader, TRAINING_BATCH);
+
+    //Train on every batch of every epoch in place
+    for (epochIterator = 0; epochIterator < epochs_in; ++epochIterator) {
+      if (epochIterator > 0) {
+        dataset.restart();
+      }
+      while ((batch = dataset.next()) != NULL) {
+        network_in->trainBatch(batch);
+      }
+      printf("Epoch %u error %f\n", epochIterator + 1, network_in->getError());
+    }
+  } catch (std::exception& error) {
+    fprintf(stderr, "%s\n", error.what());
+  }
+
+  fclose(file_in);
 }
 
-int main()
+int main(int argc, char** argv)
 {
   neural::Network net;
 
@@ -106,19 +128,13 @@ int main()
   char outFile[] = "test1.json";
 
   readNetwork(inFile, &net);
+
+  //Train on a csv or binary sample file when one is given: net <samples> [epochs]
+  if (argc > 1) {
+    trainNetwork(argv[1], argc > 2 ? atoi(argv[2]) : 1, &net);
+  }
+
   writeNetwork(outFile, &net);
-  
-  /*
-  std::vector<double>   inputValues;  //Values to train neural network input with forward-propagation
-  std::vector<double>   targetValues; //Values to train neural network output with back-propagation
-  std::vector<double>   resultValues; //Holds output from neural net  
-  
-  //Train network
-  myNet.feedForward(inputValues);      //Input on input training data 
-  myNet.backPropagation(targetValues); //Train on expected output with backpropagation
-
-  myNet.getResults(resultValues);
-  */
 
   return 0;
 }
\ No newline at end of file
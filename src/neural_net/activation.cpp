@@ -0,0 +1,25 @@
+//Activation function policies
+#include "activation.hpp"
+
+namespace neural
+{
+  namespace activation
+  {
+    double tanhTable[NEURAL_TANH_TABLE_SIZE + 2];
+
+    //Fills the tanh table before main runs
+    static bool fillTanhTable()
+    {
+      unsigned entryIterator;
+
+      for (entryIterator = 0; entryIterator <= NEURAL_TANH_TABLE_SIZE; ++entryIterator) {
+        tanhTable[entryIterator] = tanh(entryIterator * (NEURAL_TANH_TABLE_RANGE / NEURAL_TANH_TABLE_SIZE));
+      }
+      //Sums past the range land on the last interval with nothing left to interpolate
+      tanhTable[NEURAL_TANH_TABLE_SIZE + 1] = tanhTable[NEURAL_TANH_TABLE_SIZE];
+      return true;
+    }
+
+    static bool tanhTableFilled = fillTanhTable();
+  }
+}
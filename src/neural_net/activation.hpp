@@ -0,0 +1,163 @@
+/***********************************************
+* Activation function policies resolved at compile time.
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified:
+*   October 17, 2026 - Created Initially
+*   October 17, 2026 - Added approximate tanh and sigmoid
+*
+* The approximate policies avoid calling libm and have no branches, so
+* loops over them can be vectorized (the table through gathers). Largest absolute error against
+* std::tanh (and the exact logistic function) over all doubles:
+*   TanhRational      7.1e-5    SigmoidRational      3.5e-5
+*   TanhRationalFine  5.0e-6    SigmoidRationalFine  2.5e-6
+*   TanhTable         1.5e-6    SigmoidTable         7.3e-7
+* Each policy's value can also be passed to Network as a function pointer.
+***********************************************/
+
+#ifndef _H_NEURAL_ACTIVATION
+#define _H_NEURAL_ACTIVATION
+
+#include <cmath>      //tanh()    exp()    copysign()
+#include <algorithm>  //std::min()    std::max()
+
+//Slope of the leaky ReLU for negative sums
+#define NEURAL_LEAKY_SLOPE 0.01
+
+//Sums past which the rational approximations are held at their value, where they are closest to tanh saturating
+#define NEURAL_TANH_RATIONAL_LIMIT      4.79
+#define NEURAL_TANH_RATIONAL_FINE_LIMIT 6.11
+//Intervals in the tanh table and the largest sum it covers, tanh is within 2.3e-7 of 1 past it
+#define NEURAL_TANH_TABLE_SIZE  2048
+#define NEURAL_TANH_TABLE_RANGE 8.0
+
+namespace neural
+{
+  namespace activation
+  {
+    /****************
+    * Every policy provides
+    *   value(sum)         - output of a neuron for the weighted sum of its inputs
+    *   derivative(output) - derivative of value written in terms of the neuron's output
+    ****************/
+
+    /* Hyperbolic tangent, outputs [-1...1] */
+    struct Tanh
+    {
+      static inline double value(double sum_in) { return tanh(sum_in); }
+      static inline double derivative(double output_in) { return 1.0 - output_in * output_in; }
+    };
+
+    /* Logistic function, outputs [0...1] */
+    struct Sigmoid
+    {
+      static inline double value(double sum_in) { return 1.0 / (1.0 + exp(-sum_in)); }
+      static inline double derivative(double output_in) { return output_in * (1.0 - output_in); }
+    };
+
+    /* Rectified linear unit */
+    struct ReLU
+    {
+      static inline double value(double sum_in) { return sum_in > 0.0 ? sum_in : 0.0; }
+      static inline double derivative(double output_in) { return output_in > 0.0 ? 1.0 : 0.0; }
+    };
+
+    /* Rectified linear unit that keeps a small slope for negative sums */
+    struct LeakyReLU
+    {
+      static inline double value(double sum_in) { return sum_in > 0.0 ? sum_in : NEURAL_LEAKY_SLOPE * sum_in; }
+      static inline double derivative(double output_in) { return output_in > 0.0 ? 1.0 : NEURAL_LEAKY_SLOPE; }
+    };
+
+    /* Identity, used for regression outputs */
+    struct Linear
+    {
+      static inline double value(double sum_in) { return sum_in; }
+      static inline double derivative(double output_in) { return 1.0; }
+    };
+
+    /* tanh at evenly spaced sums from 0 to NEURAL_TANH_TABLE_RANGE, the last entry repeated so the end can be interpolated */
+    extern double tanhTable[NEURAL_TANH_TABLE_SIZE + 2];
+
+    /* Hyperbolic tangent from its continued fraction cut to a 7th over 6th order rational */
+    struct TanhRational
+    {
+      static inline double value(double sum_in)
+      {
+        double square;
+
+        sum_in = std::min(std::max(sum_in, -NEURAL_TANH_RATIONAL_LIMIT), NEURAL_TANH_RATIONAL_LIMIT);
+        square = sum_in * sum_in;
+        return sum_in * (135135.0 + square * (17325.0 + square * (378.0 + square))) / (135135.0 + square * (62370.0 + square * (3150.0 + square * 28.0)));
+      }
+      static inline double derivative(double output_in) { return 1.0 - output_in * output_in; }
+    };
+
+    /* Hyperbolic tangent from its continued fraction cut to a 9th over 8th order rational */
+    struct TanhRationalFine
+    {
+      static inline double value(double sum_in)
+      {
+        double square;
+
+        sum_in = std::min(std::max(sum_in, -NEURAL_TANH_RATIONAL_FINE_LIMIT), NEURAL_TANH_RATIONAL_FINE_LIMIT);
+        square = sum_in * sum_in;
+        return sum_in * (34459425.0 + square * (4729725.0 + square * (135135.0 + square * (990.0 + square)))) /
+               (34459425.0 + square * (16216200.0 + square * (945945.0 + square * (13860.0 + square * 45.0))));
+      }
+      static inline double derivative(double output_in) { return 1.0 - output_in * output_in; }
+    };
+
+    /* Hyperbolic tangent interpolated linearly between entries of tanhTable */
+    struct TanhTable
+    {
+      static inline double value(double sum_in)
+      {
+        double position;
+        unsigned entry;
+
+        position = std::min(fabs(sum_in) * (NEURAL_TANH_TABLE_SIZE / NEURAL_TANH_TABLE_RANGE), (double) NEURAL_TANH_TABLE_SIZE);
+        entry = (unsigned) position;
+        position -= entry;
+        return copysign(tanhTable[entry] + position * (tanhTable[entry + 1] - tanhTable[entry]), sum_in);
+      }
+      static inline double derivative(double output_in) { return 1.0 - output_in * output_in; }
+    };
+
+    /* Logistic functions from the approximate tanh, 1 / (1 + e^-x) = (1 + tanh(x / 2)) / 2, so each has half the error */
+    struct SigmoidRational
+    {
+      static inline double value(double sum_in) { return 0.5 + 0.5 * TanhRational::value(0.5 * sum_in); }
+      static inline double derivative(double output_in) { return output_in * (1.0 - output_in); }
+    };
+
+    struct SigmoidRationalFine
+    {
+      static inline double value(double sum_in) { return 0.5 + 0.5 * TanhRationalFine::value(0.5 * sum_in); }
+      static inline double derivative(double output_in) { return output_in * (1.0 - output_in); }
+    };
+
+    struct SigmoidTable
+    {
+      static inline double value(double sum_in) { return 0.5 + 0.5 * TanhTable::value(0.5 * sum_in); }
+      static inline double derivative(double output_in) { return output_in * (1.0 - output_in); }
+    };
+
+    /* Calls activation functions through pointers chosen at runtime */
+    struct Pointer
+    {
+      /* Function to call on neuron data */
+      double (*valueFunction)(double);
+      /* Derivative of the function in terms of the neuron's output */
+      double (*derivativeFunction)(double);
+
+      Pointer(double (*value_in)(double), double (*derivative_in)(double)) : valueFunction(value_in), derivativeFunction(derivative_in) {}
+      inline double value(double sum_in) const { return valueFunction(sum_in); }
+      inline double derivative(double output_in) const { return derivativeFunction(output_in); }
+    };
+  }
+}
+
+#endif
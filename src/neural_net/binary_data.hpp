@@ -0,0 +1,27 @@
+//Simple structures describing the layout of a binary network file
+
+#ifndef _H_NEURAL_BINARY_DATA
+#define _H_NEURAL_BINARY_DATA
+
+#include <stdint.h>   //uint32_t    uint64_t
+
+typedef struct {
+  char magic[8];          //Identifies the file as a binary network
+  uint32_t version;       //Version of the layout
+  uint32_t layers;        //Number of layers in the network
+  uint32_t bias;          //Bias neurons at the end of every layer
+  uint32_t scalarSize;    //Bytes in each stored weight
+  uint64_t size;          //Bytes in the whole file
+  uint32_t precision;     //NEURAL_PRECISION_* the weights are stored for, 0 (double) in older files
+  uint32_t flags;         //Zero, reserved
+  uint64_t reserved[3];   //Zero, pads the header to 64 bytes
+} binary_header;
+
+typedef struct {
+  uint32_t neurons;       //Non-bias neurons in the layer
+  uint32_t inputs;        //Neurons (including bias) in the previous layer, 0 for the input layer
+  uint64_t weights;       //Byte offset of the row-major weights from the start of the file
+  uint64_t deltaWeights;  //Byte offset of the row-major delta weights from the start of the file
+} binary_layer;
+
+#endif
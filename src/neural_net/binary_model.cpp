@@ -0,0 +1,347 @@
+//Binary network file that is memory mapped and used in place
+
+#include "binary_model.hpp"
+#include "network.hpp"
+
+//Maps a binary network file
+BinaryModel::BinaryModel(const char* path_in)
+{
+  int descriptor;
+  struct stat status;
+  unsigned layerIterator;
+  uint64_t arrayBytes;
+  void* mapping;
+
+  //Open the file and find its size
+  descriptor = open(path_in, O_RDONLY);
+  if (descriptor < 0) {
+    throw std::runtime_error("Unable to open binary network");
+  }
+  if (fstat(descriptor, &status) != 0 || (size_t) status.st_size < sizeof(binary_header)) {
+    close(descriptor);
+    throw std::runtime_error("Binary network is too small");
+  }
+  size = status.st_size;
+
+  //Map the file privately so training can write to the weights without changing the file
+  mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+  close(descriptor);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error("Unable to map binary network");
+  }
+  data = (char*) mapping;
+  header = (const binary_header*) data;
+  layers = (const binary_layer*) (data + sizeof(binary_header));
+
+  //Check to make sure the file is valid
+  try {
+    if (memcmp(header->magic, NEURAL_BINARY_MAGIC, sizeof(header->magic)) != 0) {
+      throw std::runtime_error("Not a binary network");
+    }
+    if (header->version != NEURAL_BINARY_VERSION) {
+      throw std::runtime_error("Unsupported binary network version");
+    }
+    if (header->precision > NEURAL_PRECISION_MIXED) {
+      throw std::runtime_error("Unsupported binary network precision");
+    }
+    if (header->scalarSize != scalarSize(header->precision)) {
+      throw std::runtime_error("Binary network scalar size does not match");
+    }
+    if (header->bias != NEURAL_BIAS_NEURONS) {
+      throw std::runtime_error("Binary network bias neurons do not match");
+    }
+    if (header->size != size || header->layers == 0 || sizeof(binary_header) + header->layers * sizeof(binary_layer) > size) {
+      throw std::runtime_error("Binary network is truncated");
+    }
+    for (layerIterator = 1; layerIterator < header->layers; ++layerIterator) {
+      //Each layer takes its inputs from the whole previous layer
+      if (layers[layerIterator].inputs != layers[layerIterator - 1].neurons + header->bias) {
+        throw std::runtime_error("Binary network layers do not line up");
+      }
+      arrayBytes = (uint64_t) layers[layerIterator].neurons * layers[layerIterator].inputs * header->scalarSize;
+      if (layers[layerIterator].weights % NEURAL_BINARY_ALIGNMENT != 0 || layers[layerIterator].deltaWeights % NEURAL_BINARY_ALIGNMENT != 0) {
+        throw std::runtime_error("Binary network arrays are not aligned");
+      }
+      if (layers[layerIterator].weights + arrayBytes > size || layers[layerIterator].deltaWeights + arrayBytes > size) {
+        throw std::runtime_error("Binary network is truncated");
+      }
+    }
+  } catch (...) {
+    munmap(data, size);
+    throw;
+  }
+}
+
+//Unmaps the file
+BinaryModel::~BinaryModel()
+{
+  munmap(data, size);
+}
+
+//Rounds an offset up to the next aligned boundary
+uint64_t BinaryModel::align(uint64_t offset_in)
+{
+  return (offset_in + NEURAL_BINARY_ALIGNMENT - 1) / NEURAL_BINARY_ALIGNMENT * NEURAL_BINARY_ALIGNMENT;
+}
+
+//Returns the bytes each weight is stored in for a precision
+uint32_t BinaryModel::scalarSize(unsigned precision_in)
+{
+  return precision_in == NEURAL_PRECISION_DOUBLE ? sizeof(double) : sizeof(float);
+}
+
+//Writes a header and layer table for the specified topology
+void BinaryModel::writeLayout(FILE* file_out, const std::vector<unsigned> &topology_in, unsigned precision_in, std::vector<binary_layer>* layers_out)
+{
+  binary_header newHeader;
+  unsigned layerIterator;
+  uint64_t offset;
+  uint64_t arrayBytes;
+
+  //Lay the arrays out after the header and layer table
+  layers_out->resize(topology_in.size());
+  offset = align(sizeof(binary_header) + topology_in.size() * sizeof(binary_layer));
+  for (layerIterator = 0; layerIterator < topology_in.size(); ++layerIterator) {
+    (*layers_out)[layerIterator].neurons = topology_in[layerIterator];
+    (*layers_out)[layerIterator].inputs = layerIterator == 0 ? 0 : topology_in[layerIterator - 1] + NEURAL_BIAS_NEURONS;
+    arrayBytes = (uint64_t) (*layers_out)[layerIterator].neurons * (*layers_out)[layerIterator].inputs * scalarSize(precision_in);
+    (*layers_out)[layerIterator].weights = offset;
+    offset = align(offset + arrayBytes);
+    (*layers_out)[layerIterator].deltaWeights = offset;
+    offset = align(offset + arrayBytes);
+  }
+
+  //Fill in the header
+  memset(&newHeader, 0, sizeof(newHeader));
+  memcpy(newHeader.magic, NEURAL_BINARY_MAGIC, sizeof(newHeader.magic));
+  newHeader.version = NEURAL_BINARY_VERSION;
+  newHeader.layers = topology_in.size();
+  newHeader.bias = NEURAL_BIAS_NEURONS;
+  newHeader.scalarSize = scalarSize(precision_in);
+  newHeader.precision = precision_in;
+  newHeader.size = offset;
+
+  if (fwrite(&newHeader, sizeof(newHeader), 1, file_out) != 1 || fwrite(layers_out->data(), sizeof(binary_layer), layers_out->size(), file_out) != layers_out->size()) {
+    throw std::runtime_error("Unable to write binary network");
+  }
+}
+
+//Writes zeros until the file reaches the specified offset then writes the array
+static void writeArray(FILE* file_out, uint64_t offset_in, const void* values_in, size_t bytes_in)
+{
+  static const char padding[NEURAL_BINARY_ALIGNMENT] = {0};
+  long position;
+
+  position = ftell(file_out);
+  if (position < 0 || (uint64_t) position > offset_in || fwrite(padding, 1, offset_in - position, file_out) != offset_in - position) {
+    throw std::runtime_error("Unable to write binary network");
+  }
+  if (fwrite(values_in, 1, bytes_in, file_out) != bytes_in) {
+    throw std::runtime_error("Unable to write binary network");
+  }
+}
+
+//Writes a dense network in the binary format
+void BinaryModel::write(FILE* file_out, neural::Network* network_in)
+{
+  std::vector<unsigned> topology;
+  std::vector<binary_layer> layerTable;
+  neural::Layer* layer;
+  unsigned layerIterator;
+  size_t count;
+
+  if (network_in->getStorage() != NEURAL_STORAGE_DENSE || network_in->hasSparseLayers()) {
+    throw std::runtime_error("Only dense networks can be written as binary");
+  }
+
+  //Extract the non-bias size of each layer
+  for (layerIterator = 1; layerIterator <= network_in->numLayers(); ++layerIterator) {
+    layer = network_in->getLayer(layerIterator);
+    topology.push_back(layer->numNeurons() - layer->numBias());
+  }
+  writeLayout(file_out, topology, network_in->getPrecision(), &layerTable);
+
+  //Copy each weight matrix out as it is laid out in memory
+  for (layerIterator = 1; layerIterator < topology.size(); ++layerIterator) {
+    layer = network_in->getLayer(layerIterator + 1);
+    count = (size_t) layerTable[layerIterator].neurons * layerTable[layerIterator].inputs;
+    if (network_in->getPrecision() == NEURAL_PRECISION_DOUBLE) {
+      writeArray(file_out, layerTable[layerIterator].weights, layer->weightData(), count * sizeof(double));
+      writeArray(file_out, layerTable[layerIterator].deltaWeights, layer->deltaWeightData(), count * sizeof(double));
+    } else {
+      writeArray(file_out, layerTable[layerIterator].weights, layer->singleWeightData(), count * sizeof(float));
+      writeArray(file_out, layerTable[layerIterator].deltaWeights, layer->singleDeltaWeightData(), count * sizeof(float));
+    }
+  }
+  writeArray(file_out, align(ftell(file_out)), NULL, 0);
+}
+
+//Converts a json network into the binary format
+void BinaryModel::fromJson(FILE* file_in, FILE* file_out, unsigned precision_in)
+{
+  std::vector<unsigned> topology;
+  std::vector<binary_layer> layerTable;
+  std::vector<std::vector<double> > weights;
+  std::vector<std::vector<double> > deltaWeights;
+  std::vector<float> singleWeights;
+  connection_data connection;
+  unsigned layerIterator;
+  unsigned layerSize;
+  size_t index;
+
+  Reader reader(file_in);
+
+  //Json layers count their bias neurons
+  while (reader.hasLayer()) {
+    layerSize = reader.getLayer();
+    if (layerSize < NEURAL_BIAS_NEURONS) {
+      throw std::runtime_error("Layer is smaller than its bias neurons");
+    }
+    topology.push_back(layerSize - NEURAL_BIAS_NEURONS);
+  }
+  if (topology.empty()) {
+    throw std::runtime_error("No layers found");
+  }
+
+  //Connections that are not listed do not exist, so start every weight at 0
+  weights.resize(topology.size());
+  deltaWeights.resize(topology.size());
+  for (layerIterator = 1; layerIterator < topology.size(); ++layerIterator) {
+    weights[layerIterator].assign((size_t) topology[layerIterator] * (topology[layerIterator - 1] + NEURAL_BIAS_NEURONS), 0.0);
+    deltaWeights[layerIterator].assign(weights[layerIterator].size(), 0.0);
+  }
+
+  //Place each connection in its layer's matrix
+  while (reader.hasConnection()) {
+    reader.getConnection(&connection);
+    if (connection.destination.layer >= topology.size() || connection.destination.layer != connection.source.layer + 1) {
+      throw std::runtime_error("Binary networks only connect adjacent layers");
+    }
+    if (connection.destination.neuron >= topology[connection.destination.layer] || connection.source.neuron >= topology[connection.source.layer] + NEURAL_BIAS_NEURONS) {
+      throw std::runtime_error("Connection neuron is out of range");
+    }
+    index = (size_t) connection.destination.neuron * (topology[connection.source.layer] + NEURAL_BIAS_NEURONS) + connection.source.neuron;
+    if (! std::isnan(connection.weight)) {
+      weights[connection.destination.layer][index] = connection.weight;
+    }
+    if (! std::isnan(connection.deltaWeight)) {
+      deltaWeights[connection.destination.layer][index] = connection.deltaWeight;
+    }
+  }
+
+  //Write the matrices out, narrowing them for single and mixed precision
+  writeLayout(file_out, topology, precision_in, &layerTable);
+  for (layerIterator = 1; layerIterator < topology.size(); ++layerIterator) {
+    if (precision_in == NEURAL_PRECISION_DOUBLE) {
+      writeArray(file_out, layerTable[layerIterator].weights, weights[layerIterator].data(), weights[layerIterator].size() * sizeof(double));
+      writeArray(file_out, layerTable[layerIterator].deltaWeights, deltaWeights[layerIterator].data(), deltaWeights[layerIterator].size() * sizeof(double));
+      continue;
+    }
+    singleWeights.assign(weights[layerIterator].begin(), weights[layerIterator].end());
+    writeArray(file_out, layerTable[layerIterator].weights, singleWeights.data(), singleWeights.size() * sizeof(float));
+    singleWeights.assign(deltaWeights[layerIterator].begin(), deltaWeights[layerIterator].end());
+    writeArray(file_out, layerTable[layerIterator].deltaWeights, singleWeights.data(), singleWeights.size() * sizeof(float));
+  }
+  writeArray(file_out, align(ftell(file_out)), NULL, 0);
+}
+
+//Converts a binary network into json topology and connections
+void BinaryModel::toJson(const char* path_in, FILE* file_out)
+{
+  BinaryModel model(path_in);
+  StreamWriter writer(file_out);
+  connection_data connection;
+  unsigned layerIterator;
+  unsigned neuronIterator;
+  unsigned inputIterator;
+  size_t weightIterator;
+  const double* weights;
+  const double* deltaWeights;
+  const float* singleWeights;
+  const float* singleDeltaWeights;
+
+  //Single and mixed precision are recorded so reading the json back keeps them
+  writer.addPrecision(model.getPrecision());
+
+  //Json layers count their bias neurons
+  for (layerIterator = 0; layerIterator < model.numLayers(); ++layerIterator) {
+    writer.addLayer(model.numNeurons(layerIterator) + NEURAL_BIAS_NEURONS);
+  }
+
+  //Every entry of every matrix is a connection
+  for (layerIterator = 1; layerIterator < model.numLayers(); ++layerIterator) {
+    //Only the arrays of the file's precision exist
+    weights = NULL;
+    deltaWeights = NULL;
+    singleWeights = NULL;
+    singleDeltaWeights = NULL;
+    if (model.getPrecision() == NEURAL_PRECISION_DOUBLE) {
+      weights = model.getWeights(layerIterator);
+      deltaWeights = model.getDeltaWeights(layerIterator);
+    } else {
+      singleWeights = model.getSingleWeights(layerIterator);
+      singleDeltaWeights = model.getSingleDeltaWeights(layerIterator);
+    }
+    weightIterator = 0;
+    connection.source.layer = layerIterator - 1;
+    connection.destination.layer = layerIterator;
+    for (neuronIterator = 0; neuronIterator < model.numNeurons(layerIterator); ++neuronIterator) {
+      connection.destination.neuron = neuronIterator;
+      for (inputIterator = 0; inputIterator < model.numInputs(layerIterator); ++inputIterator) {
+        connection.source.neuron = inputIterator;
+        if (model.getPrecision() == NEURAL_PRECISION_DOUBLE) {
+          connection.weight = weights[weightIterator];
+          connection.deltaWeight = deltaWeights[weightIterator];
+        } else {
+          connection.weight = singleWeights[weightIterator];
+          connection.deltaWeight = singleDeltaWeights[weightIterator];
+        }
+        ++weightIterator;
+        writer.addConnection(connection);
+      }
+    }
+  }
+
+  writer.finish();
+}
+
+//Returns the weights of a layer in place
+double* BinaryModel::getWeights(unsigned layer_in)
+{
+  if (header->precision != NEURAL_PRECISION_DOUBLE) {
+    throw std::runtime_error("Binary network weights are not double precision");
+  }
+  return (double*) (data + layers[layer_in].weights);
+}
+
+//Returns the delta weights of a layer in place
+double* BinaryModel::getDeltaWeights(unsigned layer_in)
+{
+  if (header->precision != NEURAL_PRECISION_DOUBLE) {
+    throw std::runtime_error("Binary network weights are not double precision");
+  }
+  return (double*) (data + layers[layer_in].deltaWeights);
+}
+
+//Returns the single precision weights of a layer in place
+float* BinaryModel::getSingleWeights(unsigned layer_in)
+{
+  if (header->precision == NEURAL_PRECISION_DOUBLE) {
+    throw std::runtime_error("Binary network weights are not single precision");
+  }
+  return (float*) (data + layers[layer_in].weights);
+}
+
+//Returns the single precision delta weights of a layer in place
+float* BinaryModel::getSingleDeltaWeights(unsigned layer_in)
+{
+  if (header->precision == NEURAL_PRECISION_DOUBLE) {
+    throw std::runtime_error("Binary network weights are not single precision");
+  }
+  return (float*) (data + layers[layer_in].deltaWeights);
+}
+
+unsigned BinaryModel::numLayers() const { return header->layers; }
+unsigned BinaryModel::getPrecision() const { return header->precision; }
+unsigned BinaryModel::numNeurons(unsigned layer_in) const { return layers[layer_in].neurons; }
+unsigned BinaryModel::numInputs(unsigned layer_in) const { return layers[layer_in].inputs; }
@@ -0,0 +1,147 @@
+/***********************************************************
+* Binary network file that is memory mapped and used in place
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*   - Added single and mixed precision weights
+*
+* Layout:
+*   binary_header
+*   binary_layer for every layer
+*   For every layer but the input: weights then delta weights,
+*     each row-major (one row of inputs per non-bias neuron),
+*     stored as doubles or as floats for single and mixed precision
+*     and starting on a NEURAL_BINARY_ALIGNMENT byte boundary
+***********************************************************/
+
+#ifndef _H_NEURAL_BINARY_MODEL
+#define _H_NEURAL_BINARY_MODEL
+
+#include <stdexcept>   //std::runtime_error
+#include <stdio.h>     //FILE    fwrite()
+#include <string.h>    //memcmp()    memcpy()
+#include <vector>      //std::vector
+#include <cmath>       //std::isnan()
+#include <sys/mman.h>  //mmap()    munmap()
+#include <sys/stat.h>  //fstat()
+#include <fcntl.h>     //open()
+#include <unistd.h>    //close()
+
+#include "binary_data.hpp"
+#include "connection_data.hpp"
+#include "reader.hpp"
+#include "stream_writer.hpp"
+
+#define NEURAL_BINARY_MAGIC     "NEURALNB"
+#define NEURAL_BINARY_VERSION   1
+#define NEURAL_BINARY_ALIGNMENT 64
+
+namespace neural
+{
+  class Network;
+}
+
+class BinaryModel
+{
+private:
+  /* Start of the mapped file */
+  char* data;
+
+  /* Bytes mapped */
+  size_t size;
+
+  /* Header at the start of the mapping */
+  const binary_header* header;
+
+  /* Layer table following the header */
+  const binary_layer* layers;
+
+  /*****************
+  * Rounds an offset up to the next aligned boundary
+  * @param offset_in offset to round
+  *****************/
+  static uint64_t align(uint64_t offset_in);
+
+  /*****************
+  * Returns the bytes each weight is stored in for a precision
+  * @param precision_in NEURAL_PRECISION_* of the weights
+  *****************/
+  static uint32_t scalarSize(unsigned precision_in);
+
+  /*****************
+  * Writes a header, layer table and zeroed arrays for the specified topology
+  * @param file_out   file to write to
+  * @param topology_in non-bias neurons in each layer
+  * @param precision_in NEURAL_PRECISION_* the weights are stored for
+  * @param layers_out location to store the layer table that was written
+  *****************/
+  static void writeLayout(FILE* file_out, const std::vector<unsigned> &topology_in, unsigned precision_in, std::vector<binary_layer>* layers_out);
+
+public:
+  /*****************
+  * Maps a binary network file, changes made through the mapping are private to this process
+  * @param path_in location of the file
+  *****************/
+  BinaryModel(const char* path_in);
+
+  /*****************
+  * Unmaps the file
+  *****************/
+  ~BinaryModel();
+
+  /*****************
+  * Writes a dense network in the binary format at the network's precision
+  * @param file_out   file to write to
+  * @param network_in network to write
+  *****************/
+  static void write(FILE* file_out, neural::Network* network_in);
+
+  /*****************
+  * Converts a json network into the binary format, connections the json leaves out have weight 0
+  * @param file_in      json file to read
+  * @param file_out     file to write to
+  * @param precision_in NEURAL_PRECISION_* to store the weights for
+  *****************/
+  static void fromJson(FILE* file_in, FILE* file_out, unsigned precision_in = NEURAL_PRECISION_DOUBLE);
+
+  /*****************
+  * Converts a binary network into json topology and connections
+  * @param path_in  location of the binary file
+  * @param file_out json file to write to
+  *****************/
+  static void toJson(const char* path_in, FILE* file_out);
+
+  /*****************
+  * Returns the weights of a layer in place (double precision files only)
+  * @param layer_in index of the layer
+  *****************/
+  double* getWeights(unsigned layer_in);
+
+  /*****************
+  * Returns the delta weights of a layer in place (double precision files only)
+  * @param layer_in index of the layer
+  *****************/
+  double* getDeltaWeights(unsigned layer_in);
+
+  /*****************
+  * Returns the weights of a layer in place (single and mixed precision files only)
+  * @param layer_in index of the layer
+  *****************/
+  float* getSingleWeights(unsigned layer_in);
+
+  /*****************
+  * Returns the delta weights of a layer in place (single and mixed precision files only)
+  * @param layer_in index of the layer
+  *****************/
+  float* getSingleDeltaWeights(unsigned layer_in);
+
+  unsigned numLayers() const;
+  unsigned getPrecision() const;
+  unsigned numNeurons(unsigned layer_in) const;
+  unsigned numInputs(unsigned layer_in) const;
+};
+
+#endif
@@ -7,6 +7,7 @@ namespace neural
   Connection::Connection(Neuron* start_in, Neuron* const end_in, double weight_in)
   {
     weight = weight_in;
+    deltaWeight = 0.0;
     start = start_in;
     endpoint = end_in;
   }
@@ -14,6 +15,8 @@ namespace neural
   //Creates a new connection
   Connection::Connection(Neuron* start_in, Neuron* end_in)
   {
+    weight = 0.0;
+    deltaWeight = 0.0;
     start = start_in;
     endpoint = end_in;
   }
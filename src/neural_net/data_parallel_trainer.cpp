@@ -0,0 +1,156 @@
+//Reproducible multithreaded mini-batch trainer
+#include "data_parallel_trainer.hpp"
+
+namespace neural
+{
+  //Creates a trainer with one weight sharing copy of the network per thread and one gradient buffer per shard
+  DataParallelTrainer::DataParallelTrainer(Network* network_in, unsigned threads_in, unsigned shards_in)
+  {
+    unsigned threadIterator;
+    unsigned layerIterator;
+    size_t weights;
+
+    if (threads_in == 0 || shards_in == 0) {
+      throw std::runtime_error("Training needs at least one thread and one shard");
+    }
+    network = network_in;
+
+    //Each thread gets its own values and gradients
+    for (threadIterator = 0; threadIterator < threads_in; ++threadIterator) {
+      replicas.push_back(network->share());
+    }
+
+    //Each shard gets a gradient for every weight
+    weights = 0;
+    for (layerIterator = 2; layerIterator <= network->numLayers(); ++layerIterator) {
+      weights += network->getLayer(layerIterator)->numConnections();
+    }
+    sums.resize(shards_in, std::vector<double>(weights));
+    errors.resize(shards_in);
+
+    //Every thread takes exactly one part of each range
+    if (threads_in > 1) {
+      pool = std::make_shared<ThreadPool>(threads_in, 1);
+    }
+  }
+
+  //Runs one shard of a batch through a replica and sums its weight gradients
+  void DataParallelTrainer::runShard(Network* replica_in, unsigned shard_in, const double* const* values_in, const double* const* targets_in, unsigned samples_in)
+  {
+    unsigned first;
+    unsigned count;
+    double error;
+
+    //Shards split the batch the same way whatever the thread count
+    first = (unsigned long long) samples_in * shard_in / sums.size();
+    count = (unsigned long long) samples_in * (shard_in + 1) / sums.size() - first;
+    if (count == 0) {
+      std::fill(sums[shard_in].begin(), sums[shard_in].end(), 0.0);
+      errors[shard_in] = 0.0;
+      return;
+    }
+
+    replica_in->feedForwardBatch(values_in + first, count);
+    replica_in->calculateBatchGradients(targets_in + first);
+    replica_in->sumBatchGradients(sums[shard_in].data());
+
+    //Weight the error by the shard's samples so the shards combine into the batch's error
+    error = replica_in->getError();
+    errors[shard_in] = network->outputLayer()->isSoftmax() ? error * count : error * error * count;
+  }
+
+  //Adds every shard's sums into the first shard's for a range of weights
+  void DataParallelTrainer::reduce(size_t begin_in, size_t end_in)
+  {
+    unsigned stride;
+    unsigned shardIterator;
+    size_t weightIterator;
+    double* sum;
+    const double* other;
+
+    //The tree only depends on the number of shards
+    for (stride = 1; stride < sums.size(); stride *= 2) {
+      for (shardIterator = 0; shardIterator + stride < sums.size(); shardIterator += 2 * stride) {
+        sum = sums[shardIterator].data();
+        other = sums[shardIterator + stride].data();
+        for (weightIterator = begin_in; weightIterator < end_in; ++weightIterator) {
+          sum[weightIterator] += other[weightIterator];
+        }
+      }
+    }
+  }
+
+  //Runs one mini-batch training step
+  double DataParallelTrainer::trainBatch(const double* const* values_in, const double* const* targets_in, unsigned samples_in)
+  {
+    unsigned threads;
+    unsigned shardIterator;
+    size_t weights;
+    double error;
+
+    if (samples_in == 0) {
+      return 0.0;
+    }
+    threads = replicas.size();
+    weights = sums[0].size();
+
+    //Thread t runs shards t, t + threads ... on its own replica
+    auto shardTask = [&](unsigned begin_in, unsigned end_in) {
+      unsigned threadIterator;
+      unsigned shard;
+
+      for (threadIterator = begin_in; threadIterator < end_in; ++threadIterator) {
+        for (shard = threadIterator; shard < sums.size(); shard += threads) {
+          runShard(&replicas[threadIterator], shard, values_in, targets_in, samples_in);
+        }
+      }
+    };
+    //Each thread reduces its own block of weights through the whole tree
+    auto reduceTask = [&](unsigned begin_in, unsigned end_in) {
+      reduce(weights * begin_in / threads, weights * end_in / threads);
+    };
+    if (pool) {
+      pool->run(threads, shardTask);
+      pool->run(threads, reduceTask);
+    } else {
+      shardTask(0, threads);
+      reduceTask(0, threads);
+    }
+
+    //One update for the whole batch
+    network->applyBatchGradients(sums[0].data(), samples_in);
+
+    //Combine the errors in shard order
+    error = 0.0;
+    for (shardIterator = 0; shardIterator < errors.size(); ++shardIterator) {
+      error += errors[shardIterator];
+    }
+    return network->outputLayer()->isSoftmax() ? error / samples_in : sqrt(error / samples_in);
+  }
+
+  //Runs one mini-batch training step from row-major matrices
+  double DataParallelTrainer::trainBatch(const std::vector<double> &values_in, const std::vector<double> &targets_in, unsigned samples_in)
+  {
+    unsigned sampleIterator;
+    unsigned inputWidth;
+    unsigned outputWidth;
+
+    inputWidth = network->inputLayer()->numNeurons() - network->inputLayer()->numBias();
+    outputWidth = network->outputLayer()->numNeurons() - network->outputLayer()->numBias();
+    if (values_in.size() < (size_t) inputWidth * samples_in || targets_in.size() < (size_t) outputWidth * samples_in) {
+      throw std::runtime_error("Training matrices are smaller than the number of samples");
+    }
+
+    //Point a row at each sample
+    valueRows.resize(samples_in);
+    targetRows.resize(samples_in);
+    for (sampleIterator = 0; sampleIterator < samples_in; ++sampleIterator) {
+      valueRows[sampleIterator] = values_in.data() + (size_t) sampleIterator * inputWidth;
+      targetRows[sampleIterator] = targets_in.data() + (size_t) sampleIterator * outputWidth;
+    }
+    return trainBatch(valueRows.data(), targetRows.data(), samples_in);
+  }
+
+  unsigned DataParallelTrainer::numThreads() const { return replicas.size(); }
+  unsigned DataParallelTrainer::numShards() const { return sums.size(); }
+}
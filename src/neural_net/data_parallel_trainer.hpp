@@ -0,0 +1,108 @@
+/***********************************************************
+* Reproducible multithreaded mini-batch trainer
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*
+* Trains a dense network one mini-batch at a time on several
+*   threads without letting the thread count change the result.
+*   Each batch is cut into a fixed number of shards. A thread runs
+*   a shard forward and back through its own Network::share copy
+*   and sums the shard's weight gradients into the shard's buffer,
+*   every sum running over the shard's samples in order. The
+*   buffers are then added in a pairwise tree whose shape depends
+*   only on the number of shards, and the total is applied as one
+*   update per weight through the network's deltaInputWeight. Every
+*   floating point operation happens in the same order whichever
+*   thread runs it, so any number of threads gives bitwise the same
+*   weights. The shard count is part of the result and must stay
+*   the same to reproduce a run.
+***********************************************************/
+
+#ifndef _H_NEURAL_DATA_PARALLEL_TRAINER
+#define _H_NEURAL_DATA_PARALLEL_TRAINER
+
+#include <vector>      //std::vector
+#include <memory>      //std::shared_ptr
+#include <stdexcept>   //std::runtime_error
+#include <cmath>       //sqrt()
+
+#include "network.hpp"
+#include "thread_pool.hpp"
+
+//Shards each batch is cut into unless specified, each holds a full set of weight gradients
+#define NEURAL_TRAINER_SHARDS 8
+
+namespace neural
+{
+  class DataParallelTrainer
+  {
+  private:
+    /* Network whose weights are trained */
+    Network* network;
+    /* Copy of the network for each thread sharing its weights, holding that thread's values and gradients */
+    std::vector<Network> replicas;
+    /* Weight gradients summed over each shard, laid out as Network::sumBatchGradients stores them */
+    std::vector<std::vector<double> > sums;
+    /* Each shard's error, squared for root mean square errors, times the samples in the shard */
+    std::vector<double> errors;
+    /* Threads the shards and the reduction are split between */
+    std::shared_ptr<ThreadPool> pool;
+    /* Locations of each sample when training from row-major matrices */
+    std::vector<const double*> valueRows;
+    std::vector<const double*> targetRows;
+
+    /***********************
+    * Runs one shard of a batch through a replica and sums its weight gradients
+    * @param replica_in Copy of the network to run the shard on
+    * @param shard_in   Index of the shard
+    * @param values_in  input values of every sample in the batch
+    * @param targets_in values to test every sample in the batch against
+    * @param samples_in number of samples in the batch
+    ***********************/
+    void runShard(Network* replica_in, unsigned shard_in, const double* const* values_in, const double* const* targets_in, unsigned samples_in);
+
+    /***********************
+    * Adds every shard's sums into the first shard's for a range of weights
+    *   Shard s takes in shard s + stride for stride 1, 2, 4 ... whichever thread runs the range
+    * @param begin_in First weight to reduce
+    * @param end_in   One past the last weight to reduce
+    ***********************/
+    void reduce(size_t begin_in, size_t end_in);
+
+  public:
+    /***********************
+    * Creates a trainer for a dense network, the network must keep its weight arrays while the trainer is used
+    * @param network_in Network to train, its own thread pool is used to apply the updates
+    * @param threads_in Threads to run the shards on, including the calling thread
+    * @param shards_in  Shards each batch is cut into, fixing the order of every sum
+    ***********************/
+    DataParallelTrainer(Network* network_in, unsigned threads_in, unsigned shards_in = NEURAL_TRAINER_SHARDS);
+
+    /***********************
+    * Runs one mini-batch training step, giving the same weights on any number of threads
+    * @param values_in  values for the input neurons of each sample, read in place
+    * @param targets_in values to test each sample against, read in place
+    * @param samples_in number of samples in the batch
+    * @return Root mean square error of the batch, or mean cross-entropy with a softmax output
+    ***********************/
+    double trainBatch(const double* const* values_in, const double* const* targets_in, unsigned samples_in);
+
+    /***********************
+    * Runs one mini-batch training step, giving the same weights on any number of threads
+    * @param values_in  samples x inputs row-major matrix of input values
+    * @param targets_in samples x outputs row-major matrix of values to test against
+    * @param samples_in number of samples in the batch
+    * @return Root mean square error of the batch, or mean cross-entropy with a softmax output
+    ***********************/
+    double trainBatch(const std::vector<double> &values_in, const std::vector<double> &targets_in, unsigned samples_in);
+
+    unsigned numThreads() const;
+    unsigned numShards() const;
+  };
+}
+
+#endif
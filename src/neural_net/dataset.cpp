@@ -0,0 +1,211 @@
+//Shuffled, batched and prefetched stream of training samples
+#include "dataset.hpp"
+
+namespace neural
+{
+  //Creates a dataset and starts reading the first epoch from the start of the file
+  Dataset::Dataset(SampleReader* reader_in, unsigned batch_in, unsigned shuffle_in, uint64_t seed_in, unsigned prefetch_in)
+    : generator(seed_in)
+  {
+    unsigned slotIterator;
+    unsigned rowIterator;
+    unsigned rowAlignment;
+    dataset_slot* slot;
+    double* base;
+
+    if (batch_in == 0) {
+      throw std::runtime_error("Batches need at least one sample");
+    }
+    reader = reader_in;
+    batchSize = batch_in;
+    shuffleSize = shuffle_in > 1 ? shuffle_in : 1;
+
+    //Pad each row to a whole number of alignments so every row starts on a boundary
+    rowAlignment = NEURAL_DATASET_ALIGNMENT / sizeof(double);
+    inputStride = (reader->numInputs() + rowAlignment - 1) / rowAlignment * rowAlignment;
+    targetStride = (reader->numTargets() + rowAlignment - 1) / rowAlignment * rowAlignment;
+
+    //One slot is handed out while the others are read ahead
+    slots.resize(prefetch_in + 1);
+    for (slotIterator = 0; slotIterator < slots.size(); ++slotIterator) {
+      slot = &slots[slotIterator];
+      slot->storage.resize((size_t) batchSize * (inputStride + targetStride) + rowAlignment);
+      base = slot->storage.data();
+      base += (NEURAL_DATASET_ALIGNMENT - (uintptr_t) base % NEURAL_DATASET_ALIGNMENT) % NEURAL_DATASET_ALIGNMENT / sizeof(double);
+      for (rowIterator = 0; rowIterator < batchSize; ++rowIterator) {
+        slot->inputs.push_back(base + (size_t) rowIterator * inputStride);
+        slot->targets.push_back(base + (size_t) batchSize * inputStride + (size_t) rowIterator * targetStride);
+      }
+      slot->batch.inputs = slot->inputs.data();
+      slot->batch.targets = slot->targets.data();
+      slot->batch.samples = 0;
+    }
+
+    shuffleInputs.resize((size_t) shuffleSize * reader->numInputs());
+    shuffleTargets.resize((size_t) shuffleSize * reader->numTargets());
+    reader->rewind();
+    start();
+  }
+
+  //Stops the background thread
+  Dataset::~Dataset()
+  {
+    stop();
+  }
+
+  //Starts the background thread on a new epoch
+  void Dataset::start()
+  {
+    unsigned slotIterator;
+
+    for (slotIterator = 0; slotIterator < slots.size(); ++slotIterator) {
+      slots[slotIterator].ready = 0;
+    }
+    head = 0;
+    taken = slots.size();
+    stopping = 0;
+    finished = 0;
+    failure = NULL;
+    worker = std::thread(&Dataset::fill, this);
+  }
+
+  //Stops and joins the background thread
+  void Dataset::stop()
+  {
+    if (! worker.joinable()) {
+      return;
+    }
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      stopping = 1;
+    }
+    freed.notify_all();
+    worker.join();
+  }
+
+  //Waits for a slot to be free
+  unsigned Dataset::waitFree(unsigned slot_in)
+  {
+    std::unique_lock<std::mutex> guard(lock);
+
+    //A slot is busy until it has been taken and the batch after it asked for
+    while (! stopping && (slots[slot_in].ready || taken == slot_in)) {
+      freed.wait(guard);
+    }
+    return ! stopping;
+  }
+
+  //Hands a filled slot to the trainer
+  void Dataset::publish(unsigned slot_in, unsigned samples_in)
+  {
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      slots[slot_in].batch.samples = samples_in;
+      slots[slot_in].ready = 1;
+    }
+    filled.notify_one();
+  }
+
+  //Reads the file once through the shuffle buffer into the slots
+  void Dataset::fill()
+  {
+    unsigned inputs;
+    unsigned targets;
+    unsigned buffered;
+    unsigned pick;
+    unsigned slot;
+    unsigned packed;
+
+    inputs = reader->numInputs();
+    targets = reader->numTargets();
+    try {
+      //Fill the shuffle buffer from the start of the file
+      buffered = 0;
+      while (buffered < shuffleSize && reader->read(&shuffleInputs[(size_t) buffered * inputs], &shuffleTargets[(size_t) buffered * targets])) {
+        ++buffered;
+      }
+
+      slot = 0;
+      packed = 0;
+      while (buffered > 0) {
+        if (packed == 0 && ! waitFree(slot)) {
+          return;
+        }
+        //Move a random buffered sample into the batch
+        pick = buffered > 1 ? generator() % buffered : 0;
+        std::copy(&shuffleInputs[(size_t) pick * inputs], &shuffleInputs[(size_t) (pick + 1) * inputs], slots[slot].inputs[packed]);
+        std::copy(&shuffleTargets[(size_t) pick * targets], &shuffleTargets[(size_t) (pick + 1) * targets], slots[slot].targets[packed]);
+        ++packed;
+
+        //Replace it with the next sample of the file, or the last buffered one once the file is done
+        if (! reader->read(&shuffleInputs[(size_t) pick * inputs], &shuffleTargets[(size_t) pick * targets])) {
+          --buffered;
+          if (pick != buffered) {
+            std::copy(&shuffleInputs[(size_t) buffered * inputs], &shuffleInputs[(size_t) (buffered + 1) * inputs], &shuffleInputs[(size_t) pick * inputs]);
+            std::copy(&shuffleTargets[(size_t) buffered * targets], &shuffleTargets[(size_t) (buffered + 1) * targets], &shuffleTargets[(size_t) pick * targets]);
+          }
+        }
+
+        if (packed == batchSize) {
+          publish(slot, packed);
+          slot = (slot + 1) % slots.size();
+          packed = 0;
+        }
+      }
+      //The last batch of the epoch may be short
+      if (packed > 0) {
+        publish(slot, packed);
+      }
+    } catch (...) {
+      std::unique_lock<std::mutex> guard(lock);
+      failure = std::current_exception();
+    }
+
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      finished = 1;
+    }
+    filled.notify_one();
+  }
+
+  //Takes the next batch of the epoch
+  const sample_batch* Dataset::next()
+  {
+    std::exception_ptr thrown;
+    dataset_slot* slot;
+
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      //The batch handed out last time is no longer read
+      taken = slots.size();
+      freed.notify_one();
+      while (! slots[head].ready && ! finished) {
+        filled.wait(guard);
+      }
+      if (! slots[head].ready) {
+        thrown = failure;
+        failure = NULL;
+        slot = NULL;
+      } else {
+        slot = &slots[head];
+        slot->ready = 0;
+        taken = head;
+        head = (head + 1) % slots.size();
+      }
+    }
+    if (thrown) {
+      std::rethrow_exception(thrown);
+    }
+    return slot ? &slot->batch : NULL;
+  }
+
+  //Rewinds the reader and starts another epoch
+  void Dataset::restart()
+  {
+    stop();
+    reader->rewind();
+    start();
+  }
+
+  unsigned Dataset::getBatchSize() const { return batchSize; }
+}
@@ -0,0 +1,161 @@
+/***********************************************************
+* Shuffled, batched and prefetched stream of training samples
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*
+* A background thread reads samples from a SampleReader into a
+*   bounded shuffle buffer, draws them out of it in random order
+*   and packs them into batches ahead of the trainer. Each batch
+*   lives in a slot whose rows start on NEURAL_DATASET_ALIGNMENT
+*   byte boundaries, and next() hands out row pointers into the
+*   slot, so Network::trainBatch and the trainers read the samples
+*   in place. A slot is only refilled after the batch following it
+*   has been taken, so the reader runs up to a few batches ahead
+*   and the trainer only waits when reading is slower than training.
+*
+* The shuffle buffer holds a window of the file, not all of it:
+*   a sample can move at most about the buffer's size from where it
+*   is in the file, so files sorted by class want a buffer that
+*   spans several classes.
+***********************************************************/
+
+#ifndef _H_NEURAL_DATASET
+#define _H_NEURAL_DATASET
+
+#include <stdint.h>             //uint64_t    uintptr_t
+#include <vector>               //std::vector
+#include <thread>               //std::thread
+#include <mutex>                //std::mutex    std::unique_lock
+#include <condition_variable>   //std::condition_variable
+#include <exception>            //std::exception_ptr
+#include <algorithm>            //std::copy()
+#include <random>               //std::mt19937_64
+#include <stdexcept>            //std::runtime_error
+
+#include "sample_data.hpp"
+#include "sample_reader.hpp"
+
+//Samples the shuffle buffer holds unless specified, 1 keeps the file's order
+#define NEURAL_SHUFFLE_BUFFER 4096
+//Batches read ahead of the trainer unless specified
+#define NEURAL_PREFETCH_BATCHES 2
+//Byte boundary every row of a batch starts on
+#define NEURAL_DATASET_ALIGNMENT 64
+//Seed of the shuffle unless specified
+#define NEURAL_DATASET_SEED 0x5eedull
+
+namespace neural
+{
+  class Dataset
+  {
+  private:
+    /* Batch being filled or handed out, its rows point into its own aligned storage */
+    typedef struct {
+      std::vector<double> storage;          //Values of every row, with room to align the first
+      std::vector<double*> inputs;          //Location of each sample's inputs in storage
+      std::vector<double*> targets;         //Location of each sample's targets in storage
+      sample_batch batch;                   //Batch handed to the trainer
+      unsigned ready;                       //Flags if the background thread has filled the slot
+    } dataset_slot;
+
+    /* Reader the samples come from, owned by the caller and only used by the background thread */
+    SampleReader* reader;
+    /* Samples in each full batch */
+    unsigned batchSize;
+    /* Samples the shuffle buffer holds */
+    unsigned shuffleSize;
+    /* Doubles from the start of one row of a slot to the next, a whole number of alignments */
+    unsigned inputStride;
+    unsigned targetStride;
+    /* Batches being filled or waiting to be taken, used in turn */
+    std::vector<dataset_slot> slots;
+    /* Slot the next batch is taken from */
+    unsigned head;
+    /* Slot handed out by the last call to next(), refilled once the following batch is taken */
+    unsigned taken;
+    /* Inputs and targets of the samples in the shuffle buffer, one row each */
+    std::vector<double> shuffleInputs;
+    std::vector<double> shuffleTargets;
+    /* Draws which buffered sample goes next */
+    std::mt19937_64 generator;
+    /* Thread reading and packing samples */
+    std::thread worker;
+    /* Guards every member below */
+    std::mutex lock;
+    /* Signals the background thread that a slot is free or it is stopping */
+    std::condition_variable freed;
+    /* Signals the trainer that a slot is ready or the epoch has ended */
+    std::condition_variable filled;
+    /* Flags the background thread to exit */
+    unsigned stopping;
+    /* Flags that the background thread has packed the last batch of the epoch */
+    unsigned finished;
+    /* First error the background thread hit */
+    std::exception_ptr failure;
+
+    /****************
+    * Reads the file once through the shuffle buffer into the slots, run on the background thread
+    ****************/
+    void fill();
+
+    /****************
+    * Waits for the slot after the last one filled to be free
+    * @param slot_in Slot to wait for
+    * @return 0 if the dataset is stopping
+    ****************/
+    unsigned waitFree(unsigned slot_in);
+
+    /****************
+    * Hands a filled slot to the trainer
+    * @param slot_in Slot that was filled
+    * @param samples_in Samples packed into it
+    ****************/
+    void publish(unsigned slot_in, unsigned samples_in);
+
+    /****************
+    * Starts the background thread on a new epoch
+    ****************/
+    void start();
+
+    /****************
+    * Stops and joins the background thread
+    ****************/
+    void stop();
+
+  public:
+    /****************
+    * Creates a dataset and starts reading the first epoch from the start of the reader's file
+    * @param reader_in   Reader of the samples, kept alive by the caller and not used by it until the dataset is gone
+    * @param batch_in    Samples in each batch, only the last batch of an epoch may be smaller
+    * @param shuffle_in  Samples the shuffle buffer holds, 1 keeps the file's order
+    * @param seed_in     Seed of the shuffle, the same seed gives the same batches
+    * @param prefetch_in Batches read ahead of the trainer
+    ****************/
+    Dataset(SampleReader* reader_in, unsigned batch_in, unsigned shuffle_in = NEURAL_SHUFFLE_BUFFER, uint64_t seed_in = NEURAL_DATASET_SEED, unsigned prefetch_in = NEURAL_PREFETCH_BATCHES);
+
+    /****************
+    * Stops the background thread
+    ****************/
+    ~Dataset();
+
+    /****************
+    * Takes the next batch of the epoch, waiting only if it has not been read yet
+    *   The batch's rows stay valid until the following call
+    * @return The batch, NULL once every sample of the epoch has been handed out
+    ****************/
+    const sample_batch* next();
+
+    /****************
+    * Rewinds the reader and starts another epoch, the shuffle carries on from the last
+    ****************/
+    void restart();
+
+    unsigned getBatchSize() const;
+  };
+}
+
+#endif
@@ -0,0 +1,18 @@
+//Simple structure describing where a frozen layer's arrays start
+
+#ifndef _H_NEURAL_FROZEN_DATA
+#define _H_NEURAL_FROZEN_DATA
+
+#include <stddef.h>   //size_t
+
+typedef struct {
+  unsigned neurons;       //Non-bias neurons in the layer
+  unsigned inputs;        //Non-bias neurons in the previous layer
+  unsigned sparse;        //Whether the weights are compressed sparse rows instead of a row-major matrix
+  size_t weights;         //Index of the layer's first weight
+  size_t biases;          //Index of the layer's first bias
+  size_t rowStarts;       //Index of the layer's first row start, sparse layers only
+  size_t columns;         //Index of the layer's first column, sparse layers only
+} frozen_layer;
+
+#endif
@@ -0,0 +1,161 @@
+//Read-only network for serving predictions
+#include "frozen_network.hpp"
+#include "network.hpp"
+
+namespace neural
+{
+  //Copies the weights out of a dense or sparse network
+  FrozenNetwork::FrozenNetwork(Network* network_in, double (*activationFunction_in)(double))
+  {
+    unsigned layerIterator;
+    unsigned neuronIterator;
+    unsigned inputIterator;
+    unsigned entryIterator;
+    unsigned biasIterator;
+    unsigned kept;
+    Layer* layer;
+    frozen_layer frozen;
+    const unsigned* layerRowStarts;
+    const unsigned* layerColumns;
+
+    //Graph connections are spread across the neurons
+    if (network_in->getStorage() == NEURAL_STORAGE_GRAPH) {
+      throw std::runtime_error("Freezing requires dense or sparse storage");
+    }
+    activationFunction = activationFunction_in;
+    softmax = network_in->outputLayer()->isSoftmax();
+    inputs = network_in->inputLayer()->numNeurons() - NEURAL_BIAS_NEURONS;
+    width = inputs;
+
+    for (layerIterator = 2; layerIterator <= network_in->numLayers(); ++layerIterator) {
+      layer = network_in->getLayer(layerIterator);
+      frozen.neurons = layer->numNeurons() - NEURAL_BIAS_NEURONS;
+      frozen.inputs = layer->numInputs() - NEURAL_BIAS_NEURONS;
+      frozen.sparse = layer->isSparse();
+      frozen.weights = weights.size();
+      frozen.biases = biases.size();
+      frozen.rowStarts = rowStarts.size();
+      frozen.columns = columns.size();
+      width = std::max(width, frozen.neurons);
+      //Pending sparse connections only get their weights once compressed
+      if (frozen.sparse) {
+        layer->compressSparse();
+      }
+
+      //Bias neurons always fire the same value so their connections fold into one bias
+      for (neuronIterator = 0; neuronIterator < frozen.neurons; ++neuronIterator) {
+        biases.push_back(0);
+        for (biasIterator = 0; biasIterator < NEURAL_BIAS_NEURONS; ++biasIterator) {
+          biases.back() += layer->getWeight(neuronIterator, frozen.inputs + biasIterator) * NEURAL_BIAS_VALUE;
+        }
+      }
+
+      if (frozen.sparse) {
+        //Copy the compressed rows, leaving out the bias entries that were folded in
+        layerRowStarts = layer->sparseRowStarts();
+        layerColumns = layer->sparseColumns();
+        kept = 0;
+        for (neuronIterator = 0; neuronIterator < frozen.neurons; ++neuronIterator) {
+          rowStarts.push_back(kept);
+          for (entryIterator = layerRowStarts[neuronIterator]; entryIterator < layerRowStarts[neuronIterator + 1]; ++entryIterator) {
+            if (layerColumns[entryIterator] < frozen.inputs) {
+              weights.push_back(layer->getWeight(neuronIterator, layerColumns[entryIterator]));
+              columns.push_back(layerColumns[entryIterator]);
+              ++kept;
+            }
+          }
+        }
+        rowStarts.push_back(kept);
+      } else {
+        //Copy the matrix without its bias columns
+        for (neuronIterator = 0; neuronIterator < frozen.neurons; ++neuronIterator) {
+          for (inputIterator = 0; inputIterator < frozen.inputs; ++inputIterator) {
+            weights.push_back(layer->getWeight(neuronIterator, inputIterator));
+          }
+        }
+      }
+      layers.push_back(frozen);
+    }
+
+    //Release the room left over from growing the arrays
+    std::vector<double>(weights).swap(weights);
+    std::vector<double>(biases).swap(biases);
+    std::vector<unsigned>(rowStarts).swap(rowStarts);
+    std::vector<unsigned>(columns).swap(columns);
+  }
+
+  //Returns the doubles of scratch space each concurrent feedForward needs
+  size_t FrozenNetwork::scratchSize() const
+  {
+    //Layers alternate between two halves of the scratch space
+    return 2 * (size_t) width;
+  }
+
+  //Feeds values through the network using the caller's scratch space
+  const double* FrozenNetwork::feedForward(const double* values_in, double* scratch_in) const
+  {
+    unsigned layerIterator;
+    unsigned neuronIterator;
+    const frozen_layer* layer;
+    const double* values;
+    const double* layerWeights;
+    const unsigned* layerRowStarts;
+    const unsigned* layerColumns;
+    double* nextValues;
+    double sum;
+
+    values = values_in;
+    nextValues = scratch_in;
+    for (layerIterator = 0; layerIterator < layers.size(); ++layerIterator) {
+      layer = &layers[layerIterator];
+      layerWeights = weights.data() + layer->weights;
+      for (neuronIterator = 0; neuronIterator < layer->neurons; ++neuronIterator) {
+        if (layer->sparse) {
+          layerRowStarts = rowStarts.data() + layer->rowStarts;
+          layerColumns = columns.data() + layer->columns;
+          sum = kernels::dotSparse(layerWeights + layerRowStarts[neuronIterator], layerColumns + layerRowStarts[neuronIterator], values, layerRowStarts[neuronIterator + 1] - layerRowStarts[neuronIterator]);
+        } else {
+          sum = kernels::dot(layerWeights + (size_t) neuronIterator * layer->inputs, values, layer->inputs);
+        }
+        nextValues[neuronIterator] = sum + biases[layer->biases + neuronIterator];
+      }
+      //Softmax outputs are normalized together, every other layer calls the activation function
+      if (softmax && layerIterator + 1 == layers.size()) {
+        Layer::normalizeSoftmax(nextValues, layer->neurons);
+      } else {
+        for (neuronIterator = 0; neuronIterator < layer->neurons; ++neuronIterator) {
+          nextValues[neuronIterator] = activationFunction(nextValues[neuronIterator]);
+        }
+      }
+      //The outputs become the next layer's inputs and the other half of the scratch space is written next
+      values = nextValues;
+      nextValues = nextValues == scratch_in ? scratch_in + width : scratch_in;
+    }
+    return values;
+  }
+
+  //Feeds values through the network, growing the caller's scratch space as needed
+  void FrozenNetwork::feedForward(const std::vector<double> &values_in, std::vector<double> &resultValues_out, std::vector<double> &scratch_in) const
+  {
+    const double* results;
+
+    if (values_in.size() != inputs) {
+      throw std::runtime_error("Input values do not match the input layer");
+    }
+    if (scratch_in.size() < scratchSize()) {
+      scratch_in.resize(scratchSize());
+    }
+    results = feedForward(values_in.data(), scratch_in.data());
+    resultValues_out.assign(results, results + numOutputs());
+  }
+
+  //Returns the bytes held by the weights, biases and sparse indexes
+  size_t FrozenNetwork::weightBytes() const
+  {
+    return (weights.size() + biases.size()) * sizeof(double) + (rowStarts.size() + columns.size()) * sizeof(unsigned);
+  }
+
+  unsigned FrozenNetwork::numLayers() const { return layers.size() + 1; }
+  unsigned FrozenNetwork::numInputs() const { return inputs; }
+  unsigned FrozenNetwork::numOutputs() const { return layers.empty() ? inputs : layers.back().neurons; }
+}
@@ -0,0 +1,103 @@
+/***********************************************************
+* Read-only network for serving predictions
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*   - Kept softmax output layers
+*
+* Keeps only the weights of a network, with the bias connections
+*   folded into one bias per neuron, in a few contiguous arrays
+*   shared by every layer. Nothing is written after construction
+*   and each caller evaluates into its own scratch space, so any
+*   number of threads may call feedForward on one instance at once
+*   without locking.
+***********************************************************/
+
+#ifndef _H_NEURAL_FROZEN_NETWORK
+#define _H_NEURAL_FROZEN_NETWORK
+
+#include <stdexcept>   //std::runtime_error
+#include <vector>      //std::vector
+#include <algorithm>   //std::max()
+
+#include "kernels.hpp"
+#include "frozen_data.hpp"
+
+namespace neural
+{
+  class Network;
+
+  class FrozenNetwork
+  {
+  private:
+    /* Function used when neurons fire, must not keep state between calls */
+    double (*activationFunction)(double);
+
+    /* Flags if the output layer is a softmax over its sums instead of calling the activation function */
+    unsigned softmax;
+
+    /* Location of each layer's arrays, the input layer is not stored */
+    std::vector<frozen_layer> layers;
+
+    /* Non-bias neurons in the input layer */
+    unsigned inputs;
+
+    /* Most non-bias neurons in any layer */
+    unsigned width;
+
+    /* Row-major weights of dense layers and row entries of sparse layers */
+    std::vector<double> weights;
+
+    /* Sum of the bias connections of every neuron */
+    std::vector<double> biases;
+
+    /* Entry each sparse row starts at, relative to the layer, one past the last row included */
+    std::vector<unsigned> rowStarts;
+
+    /* Input each sparse entry reads */
+    std::vector<unsigned> columns;
+
+  public:
+    /*****************
+    * Copies the weights out of a dense or sparse network, the network is left unchanged
+    * @param network_in            network to freeze
+    * @param activationFunction_in function used when neurons fire
+    *****************/
+    FrozenNetwork(Network* network_in, double (*activationFunction_in)(double));
+
+    /*****************
+    * Returns the doubles of scratch space each concurrent feedForward needs
+    *****************/
+    size_t scratchSize() const;
+
+    /*****************
+    * Feeds values through the network using the caller's scratch space
+    * @param values_in  values for the input neurons
+    * @param scratch_in at least scratchSize() doubles owned by the calling thread
+    * @return the output neuron values, stored in the scratch space
+    *****************/
+    const double* feedForward(const double* values_in, double* scratch_in) const;
+
+    /*****************
+    * Feeds values through the network using the caller's scratch space
+    * @param values_in        values for the input neurons
+    * @param resultValues_out location to store the output neuron values
+    * @param scratch_in       scratch space owned by the calling thread, grown as needed
+    *****************/
+    void feedForward(const std::vector<double> &values_in, std::vector<double> &resultValues_out, std::vector<double> &scratch_in) const;
+
+    /*****************
+    * Returns the bytes held by the weights, biases and sparse indexes
+    *****************/
+    size_t weightBytes() const;
+
+    unsigned numLayers() const;
+    unsigned numInputs() const;
+    unsigned numOutputs() const;
+  };
+}
+
+#endif
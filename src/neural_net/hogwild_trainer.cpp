@@ -0,0 +1,100 @@
+//Lock-free multithreaded trainer
+#include "hogwild_trainer.hpp"
+
+namespace neural
+{
+  //Creates a trainer with one weight sharing copy of the network per thread
+  HogwildTrainer::HogwildTrainer(Network* network_in, unsigned threads_in)
+  {
+    unsigned threadIterator;
+
+    if (threads_in == 0) {
+      throw std::runtime_error("Training needs at least one thread");
+    }
+    network = network_in;
+
+    //Each thread gets its own values, gradients and sample
+    for (threadIterator = 0; threadIterator < threads_in; ++threadIterator) {
+      replicas.push_back(network->share());
+    }
+    inputs.resize(threads_in);
+    targets.resize(threads_in);
+    errors.resize(threads_in);
+
+    //Every thread takes exactly one replica
+    if (threads_in > 1) {
+      pool = std::make_shared<ThreadPool>(threads_in, 1);
+    }
+  }
+
+  //Trains on every sample once split between the threads
+  double HogwildTrainer::train(const double* const* values_in, const double* const* targets_in, unsigned samples_in)
+  {
+    unsigned threads;
+    unsigned threadIterator;
+    unsigned inputWidth;
+    unsigned outputWidth;
+    double error;
+
+    threads = replicas.size();
+    inputWidth = network->inputLayer()->numNeurons() - network->inputLayer()->numBias();
+    outputWidth = network->outputLayer()->numNeurons() - network->outputLayer()->numBias();
+
+    //Each part of the range is a single thread, which trains its replica on every threads-th sample
+    auto task = [&](unsigned begin_in, unsigned end_in) {
+      unsigned replicaIterator;
+      unsigned sampleIterator;
+      double sum;
+
+      for (replicaIterator = begin_in; replicaIterator < end_in; ++replicaIterator) {
+        sum = 0.0;
+        for (sampleIterator = replicaIterator; sampleIterator < samples_in; sampleIterator += threads) {
+          inputs[replicaIterator].assign(values_in[sampleIterator], values_in[sampleIterator] + inputWidth);
+          targets[replicaIterator].assign(targets_in[sampleIterator], targets_in[sampleIterator] + outputWidth);
+          replicas[replicaIterator].feedForward(inputs[replicaIterator]);
+          replicas[replicaIterator].backPropagation(targets[replicaIterator]);
+          sum += replicas[replicaIterator].getError();
+        }
+        //Written once so threads do not keep pulling the shared line back and forth
+        errors[replicaIterator] = sum;
+      }
+    };
+    if (pool) {
+      pool->run(threads, task);
+    } else {
+      task(0, threads);
+    }
+
+    //Combine the errors in thread order
+    error = 0.0;
+    for (threadIterator = 0; threadIterator < threads; ++threadIterator) {
+      error += errors[threadIterator];
+    }
+    return samples_in ? error / samples_in : 0.0;
+  }
+
+  //Trains on every sample of row-major matrices once split between the threads
+  double HogwildTrainer::train(const std::vector<double> &values_in, const std::vector<double> &targets_in, unsigned samples_in)
+  {
+    unsigned sampleIterator;
+    unsigned inputWidth;
+    unsigned outputWidth;
+
+    inputWidth = network->inputLayer()->numNeurons() - network->inputLayer()->numBias();
+    outputWidth = network->outputLayer()->numNeurons() - network->outputLayer()->numBias();
+    if (values_in.size() < (size_t) inputWidth * samples_in || targets_in.size() < (size_t) outputWidth * samples_in) {
+      throw std::runtime_error("Training matrices are smaller than the number of samples");
+    }
+
+    //Point a row at each sample
+    valueRows.resize(samples_in);
+    targetRows.resize(samples_in);
+    for (sampleIterator = 0; sampleIterator < samples_in; ++sampleIterator) {
+      valueRows[sampleIterator] = values_in.data() + (size_t) sampleIterator * inputWidth;
+      targetRows[sampleIterator] = targets_in.data() + (size_t) sampleIterator * outputWidth;
+    }
+    return train(valueRows.data(), targetRows.data(), samples_in);
+  }
+
+  unsigned HogwildTrainer::numThreads() const { return replicas.size(); }
+}
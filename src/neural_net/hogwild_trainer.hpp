@@ -0,0 +1,83 @@
+/***********************************************************
+* Lock-free multithreaded trainer
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*
+* Trains a dense network with stochastic gradient descent on
+*   several threads at once in the style of Hogwild. Each thread
+*   owns a copy of the network made by Network::share, so the
+*   values, gradients and current sample are private to it while
+*   every copy updates the one set of weights (and delta weights)
+*   in place without locking. Updates from different threads may
+*   overwrite each other now and then; with sparse enough gradients
+*   against large enough layers this costs little accuracy and
+*   lets the samples per second grow with the threads.
+***********************************************************/
+
+#ifndef _H_NEURAL_HOGWILD_TRAINER
+#define _H_NEURAL_HOGWILD_TRAINER
+
+#include <vector>      //std::vector
+#include <memory>      //std::shared_ptr
+#include <stdexcept>   //std::runtime_error
+
+#include "network.hpp"
+#include "thread_pool.hpp"
+
+namespace neural
+{
+  class HogwildTrainer
+  {
+  private:
+    /* Network whose weights every thread trains */
+    Network* network;
+    /* Copy of the network for each thread sharing its weights, holding that thread's values and gradients */
+    std::vector<Network> replicas;
+    /* Input values of the sample each thread is training on */
+    std::vector<std::vector<double> > inputs;
+    /* Target values of the sample each thread is training on */
+    std::vector<std::vector<double> > targets;
+    /* Error summed over the samples each thread trained on in the last call */
+    std::vector<double> errors;
+    /* Threads the samples are split between, each takes one replica */
+    std::shared_ptr<ThreadPool> pool;
+    /* Locations of each sample when training from row-major matrices */
+    std::vector<const double*> valueRows;
+    std::vector<const double*> targetRows;
+
+  public:
+    /***********************
+    * Creates a trainer for a dense network, the network must keep its weight arrays while the trainer is used
+    * @param network_in Network to train, its layers must not be resized or reloaded afterwards
+    * @param threads_in Threads to train on, including the calling thread
+    ***********************/
+    HogwildTrainer(Network* network_in, unsigned threads_in);
+
+    /***********************
+    * Trains on every sample once, one forward and backward pass each, split between the threads
+    *   Thread t takes samples t, t + threads, ... so every thread sees the whole range
+    * @param values_in  values for the input neurons of each sample, read in place
+    * @param targets_in values to test each sample against, read in place
+    * @param samples_in number of samples
+    * @return Mean error of the samples as each was trained on
+    ***********************/
+    double train(const double* const* values_in, const double* const* targets_in, unsigned samples_in);
+
+    /***********************
+    * Trains on every sample once, split between the threads
+    * @param values_in  samples x inputs row-major matrix of input values
+    * @param targets_in samples x outputs row-major matrix of values to test against
+    * @param samples_in number of samples
+    * @return Mean error of the samples as each was trained on
+    ***********************/
+    double train(const std::vector<double> &values_in, const std::vector<double> &targets_in, unsigned samples_in);
+
+    unsigned numThreads() const;
+  };
+}
+
+#endif
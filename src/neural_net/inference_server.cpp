@@ -0,0 +1,422 @@
+//Dynamically batching inference server
+#include "inference_server.hpp"
+
+namespace neural
+{
+  //Creates the socket and starts answering on it
+  InferenceServer::InferenceServer(Network* network_in, const char* path_in, unsigned batch_in, unsigned latency_in)
+    : latency(latency_in)
+  {
+    struct sockaddr_un address;
+    struct stat status;
+    mode_t mask;
+
+    if (batch_in == 0) {
+      throw std::runtime_error("Batches need at least one prediction");
+    }
+    if (strlen(path_in) >= sizeof(address.sun_path)) {
+      throw std::runtime_error("Socket path is too long");
+    }
+    //Every batch runs through feedForwardBatch, which only dense layers support
+    if (network_in->getStorage() != NEURAL_STORAGE_DENSE || network_in->hasSparseLayers()) {
+      throw std::runtime_error("Serving requires dense storage");
+    }
+    network = network_in;
+    inputWidth = network->inputLayer()->numNeurons() - network->inputLayer()->numBias();
+    outputWidth = network->outputLayer()->numNeurons() - network->outputLayer()->numBias();
+    batchSize = batch_in;
+    path = path_in;
+
+    //Only replace what an earlier server left behind
+    if (lstat(path_in, &status) == 0) {
+      if (! S_ISSOCK(status.st_mode)) {
+        throw std::runtime_error("Socket path exists and is not a socket");
+      }
+      unlink(path_in);
+    }
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+      throw std::runtime_error("Unable to create socket");
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path_in);
+
+    //Only the owner may connect
+    mask = umask(0077);
+    if (bind(listener, (struct sockaddr*) &address, sizeof(address)) != 0) {
+      umask(mask);
+      close(listener);
+      throw std::runtime_error("Unable to bind socket");
+    }
+    umask(mask);
+    if (listen(listener, NEURAL_SERVER_BACKLOG) != 0) {
+      close(listener);
+      unlink(path_in);
+      throw std::runtime_error("Unable to listen on socket");
+    }
+
+    open = 0;
+    stopping = 0;
+    batching = 1;
+    requests = 0;
+    batches = 0;
+    rejected = 0;
+    failed = 0;
+    latencies.resize(NEURAL_SERVER_LATENCY_WINDOW);
+    started = std::chrono::steady_clock::now();
+    batcher = std::thread(&InferenceServer::runBatches, this);
+    acceptor = std::thread(&InferenceServer::acceptConnections, this);
+  }
+
+  //Stops the server
+  InferenceServer::~InferenceServer()
+  {
+    stop();
+  }
+
+  //Closes every connection, joins every thread and removes the socket
+  void InferenceServer::stop()
+  {
+    std::list<server_connection>::iterator connectionIterator;
+
+    if (! acceptor.joinable()) {
+      return;
+    }
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      stopping = 1;
+    }
+    arrived.notify_all();
+
+    //Wake the accepting thread out of accept()
+    shutdown(listener, SHUT_RDWR);
+    acceptor.join();
+
+    //The batch running now finishes before its connections are released
+    batcher.join();
+
+    //Wake every connection out of read() and wait for it to return
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      for (connectionIterator = connections.begin(); connectionIterator != connections.end(); ++connectionIterator) {
+        shutdown(connectionIterator->socket, SHUT_RDWR);
+      }
+    }
+    for (connectionIterator = connections.begin(); connectionIterator != connections.end(); ++connectionIterator) {
+      connectionIterator->thread.join();
+      close(connectionIterator->socket);
+    }
+    connections.clear();
+
+    close(listener);
+    unlink(path.c_str());
+  }
+
+  //Accepts connections until the server stops
+  void InferenceServer::acceptConnections()
+  {
+    int client;
+    server_connection* connection;
+
+    while (true) {
+      client = accept(listener, NULL, NULL);
+      std::unique_lock<std::mutex> guard(lock);
+      if (stopping) {
+        if (client >= 0) {
+          close(client);
+        }
+        return;
+      }
+      if (client < 0) {
+        continue;
+      }
+      reapConnections();
+
+      //Each connection gets its own thread
+      connections.push_back(server_connection());
+      connection = &connections.back();
+      connection->socket = client;
+      connection->finished = 0;
+      ++open;
+      connection->thread = std::thread(&InferenceServer::serve, this, connection);
+    }
+  }
+
+  //Joins and closes connections whose thread has returned
+  void InferenceServer::reapConnections()
+  {
+    std::list<server_connection>::iterator connectionIterator;
+
+    connectionIterator = connections.begin();
+    while (connectionIterator != connections.end()) {
+      if (connectionIterator->finished) {
+        connectionIterator->thread.join();
+        close(connectionIterator->socket);
+        connectionIterator = connections.erase(connectionIterator);
+      } else {
+        ++connectionIterator;
+      }
+    }
+  }
+
+  //Answers one connection's requests until it closes or the server stops
+  void InferenceServer::serve(server_connection* connection_in)
+  {
+    server_request request;
+    server_response response;
+    server_stats stats;
+    server_pending pending;
+    std::vector<double> inputs;
+    std::vector<double> outputs;
+    char discard[256];
+    size_t remaining;
+
+    inputs.resize(inputWidth);
+    outputs.resize(outputWidth);
+    pending.inputs = inputs.data();
+    pending.outputs = outputs.data();
+
+    while (readAll(connection_in->socket, &request, sizeof(request))) {
+      if (request.kind == NEURAL_SERVER_STATS && request.bytes == 0) {
+        getStats(&stats);
+        response.status = NEURAL_SERVER_OK;
+        response.bytes = sizeof(stats);
+        if (! writeAll(connection_in->socket, &response, sizeof(response)) || ! writeAll(connection_in->socket, &stats, sizeof(stats))) {
+          break;
+        }
+        continue;
+      }
+
+      //Refuse anything but a prediction of the network's inputs, skipping what was sent with it
+      if (request.kind != NEURAL_SERVER_PREDICT || request.bytes != inputWidth * sizeof(double)) {
+        for (remaining = request.bytes; remaining > 0; remaining -= std::min(remaining, sizeof(discard))) {
+          if (! readAll(connection_in->socket, discard, std::min(remaining, sizeof(discard)))) {
+            break;
+          }
+        }
+        {
+          std::unique_lock<std::mutex> guard(lock);
+          ++rejected;
+        }
+        response.status = NEURAL_SERVER_ERROR;
+        response.bytes = 0;
+        if (remaining > 0 || ! writeAll(connection_in->socket, &response, sizeof(response))) {
+          break;
+        }
+        continue;
+      }
+
+      if (! readAll(connection_in->socket, inputs.data(), request.bytes)) {
+        break;
+      }
+      pending.arrival = std::chrono::steady_clock::now();
+      if (! predict(&pending)) {
+        break;
+      }
+      //A batch that could not run has no outputs to send
+      if (pending.failed) {
+        response.status = NEURAL_SERVER_ERROR;
+        response.bytes = 0;
+        if (! writeAll(connection_in->socket, &response, sizeof(response))) {
+          break;
+        }
+        continue;
+      }
+      response.status = NEURAL_SERVER_OK;
+      response.bytes = outputWidth * sizeof(double);
+      if (! writeAll(connection_in->socket, &response, sizeof(response)) || ! writeAll(connection_in->socket, outputs.data(), response.bytes)) {
+        break;
+      }
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    connection_in->finished = 1;
+    --open;
+    //One fewer connection can join the batch being held open
+    arrived.notify_one();
+  }
+
+  //Queues one prediction and waits for its batch to run
+  unsigned InferenceServer::predict(server_pending* pending_in)
+  {
+    std::unique_lock<std::mutex> guard(lock);
+
+    if (stopping) {
+      return 0;
+    }
+    pending_in->done = 0;
+    pending_in->failed = 0;
+    queue.push_back(pending_in);
+    arrived.notify_one();
+
+    //Only the batching thread returning can leave a prediction behind, never while it is running it
+    while (! pending_in->done && batching) {
+      completed.wait(guard);
+    }
+    return pending_in->done;
+  }
+
+  //Takes predictions off the queue and runs them in batches until the server stops
+  void InferenceServer::runBatches()
+  {
+    std::vector<server_pending*> running;
+    std::vector<const double*> rows;
+    std::vector<double> results;
+    std::chrono::steady_clock::time_point deadline;
+    std::chrono::steady_clock::time_point finished;
+    unsigned pendingIterator;
+    unsigned samples;
+    unsigned batchFailed;
+
+    std::unique_lock<std::mutex> guard(lock);
+    while (! stopping) {
+      if (queue.empty()) {
+        arrived.wait(guard);
+        continue;
+      }
+
+      //Hold the batch open until it is full, nobody else can join it or the oldest prediction is out of time
+      deadline = queue.front()->arrival + latency;
+      while (! stopping && queue.size() < batchSize && queue.size() < open && std::chrono::steady_clock::now() < deadline) {
+        arrived.wait_until(guard, deadline);
+      }
+      if (stopping) {
+        break;
+      }
+      samples = std::min((size_t) batchSize, queue.size());
+      running.assign(queue.begin(), queue.begin() + samples);
+      queue.erase(queue.begin(), queue.begin() + samples);
+      guard.unlock();
+
+      //Run the whole batch in one pass, a failure is answered to every prediction in it and the server carries on
+      rows.resize(samples);
+      for (pendingIterator = 0; pendingIterator < samples; ++pendingIterator) {
+        rows[pendingIterator] = running[pendingIterator]->inputs;
+      }
+      batchFailed = 0;
+      try {
+        network->feedForwardBatch(rows.data(), samples);
+        network->getBatchResults(results);
+        for (pendingIterator = 0; pendingIterator < samples; ++pendingIterator) {
+          std::copy(&results[(size_t) pendingIterator * outputWidth], &results[(size_t) (pendingIterator + 1) * outputWidth], running[pendingIterator]->outputs);
+        }
+      } catch (std::exception& error) {
+        batchFailed = 1;
+      }
+      finished = std::chrono::steady_clock::now();
+
+      //Hand the outputs back and record how long each prediction took
+      guard.lock();
+      for (pendingIterator = 0; pendingIterator < samples; ++pendingIterator) {
+        running[pendingIterator]->done = 1;
+        running[pendingIterator]->failed = batchFailed;
+      }
+      if (batchFailed) {
+        failed += samples;
+        completed.notify_all();
+        continue;
+      }
+      for (pendingIterator = 0; pendingIterator < samples; ++pendingIterator) {
+        latencies[(requests + pendingIterator) % latencies.size()] = std::chrono::duration<double, std::micro>(finished - running[pendingIterator]->arrival).count();
+      }
+      requests += samples;
+      ++batches;
+      completed.notify_all();
+    }
+
+    //Predictions still queued are never run
+    batching = 0;
+    completed.notify_all();
+  }
+
+  //Finds the counters since the server started
+  void InferenceServer::getStats(server_stats* stats_out)
+  {
+    std::vector<double> window;
+    std::unique_lock<std::mutex> guard(lock);
+
+    stats_out->requests = requests;
+    stats_out->batches = batches;
+    stats_out->rejected = rejected;
+    stats_out->failed = failed;
+    stats_out->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    stats_out->requestsPerSec = stats_out->seconds > 0.0 ? requests / stats_out->seconds : 0.0;
+    stats_out->meanBatch = batches > 0 ? (double) requests / batches : 0.0;
+
+    //Percentiles of the latest predictions
+    window.assign(latencies.begin(), latencies.begin() + std::min((uint64_t) latencies.size(), requests));
+    guard.unlock();
+    stats_out->p50Micros = 0.0;
+    stats_out->p99Micros = 0.0;
+    if (! window.empty()) {
+      std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+      stats_out->p50Micros = window[window.size() / 2];
+      std::nth_element(window.begin(), window.begin() + window.size() * 99 / 100, window.end());
+      stats_out->p99Micros = window[window.size() * 99 / 100];
+    }
+  }
+
+  //Reads exactly the given bytes from a socket
+  unsigned InferenceServer::readAll(int socket_in, void* data_out, size_t bytes_in)
+  {
+    ssize_t received;
+
+    while (bytes_in > 0) {
+      received = read(socket_in, data_out, bytes_in);
+      if (received < 0 && errno == EINTR) {
+        continue;
+      }
+      if (received <= 0) {
+        return 0;
+      }
+      data_out = (char*) data_out + received;
+      bytes_in -= received;
+    }
+    return 1;
+  }
+
+  //Writes all of the given bytes to a socket
+  unsigned InferenceServer::writeAll(int socket_in, const void* data_in, size_t bytes_in)
+  {
+    ssize_t sent;
+
+    while (bytes_in > 0) {
+      //A client that hung up is an error on this socket, not a signal to the process
+      sent = send(socket_in, data_in, bytes_in, MSG_NOSIGNAL);
+      if (sent < 0 && errno == EINTR) {
+        continue;
+      }
+      if (sent <= 0) {
+        return 0;
+      }
+      data_in = (const char*) data_in + sent;
+      bytes_in -= sent;
+    }
+    return 1;
+  }
+
+  //Connects to a server
+  int InferenceServer::connectTo(const char* path_in)
+  {
+    struct sockaddr_un address;
+    int client;
+
+    if (strlen(path_in) >= sizeof(address.sun_path)) {
+      throw std::runtime_error("Socket path is too long");
+    }
+    client = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (client < 0) {
+      throw std::runtime_error("Unable to create socket");
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path_in);
+    if (connect(client, (struct sockaddr*) &address, sizeof(address)) != 0) {
+      close(client);
+      throw std::runtime_error("Unable to connect to server");
+    }
+    return client;
+  }
+}
@@ -0,0 +1,213 @@
+/***********************************************************
+* Dynamically batching inference server
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*   - Refused networks that can not be batched and answered failed batches with an error
+*
+* Answers predictions over a Unix domain socket, which only
+*   processes on the same machine can reach, created so that only
+*   its owner may connect. Each connection gets a thread that reads
+*   one request at a time and queues it. A batching thread takes the
+*   queue once it holds NEURAL_SERVER_BATCH predictions, once every
+*   connection is waiting on an answer, or once the oldest prediction
+*   has waited the latency budget, whichever is first. The batch goes
+*   through one Network::feedForwardBatch, so concurrent clients
+*   share the weight reads instead of each paying for them. A
+*   batch that fails is answered with NEURAL_SERVER_ERROR.
+*
+* Every message starts with a server_request or server_response
+*   (see server_data.hpp) giving the bytes that follow, in the
+*   host's byte order:
+*   NEURAL_SERVER_PREDICT  the input values as doubles, answered
+*                          with the output values as doubles
+*   NEURAL_SERVER_STATS    nothing, answered with a server_stats
+***********************************************************/
+
+#ifndef _H_NEURAL_INFERENCE_SERVER
+#define _H_NEURAL_INFERENCE_SERVER
+
+#include <stdint.h>             //uint64_t
+#include <errno.h>              //errno    EINTR
+#include <string.h>             //strlen()    strcpy()    memset()
+#include <string>               //std::string
+#include <vector>               //std::vector
+#include <deque>                //std::deque
+#include <list>                 //std::list
+#include <thread>               //std::thread
+#include <mutex>                //std::mutex    std::unique_lock
+#include <condition_variable>   //std::condition_variable
+#include <chrono>               //std::chrono::steady_clock
+#include <algorithm>            //std::nth_element()    std::min()
+#include <stdexcept>            //std::runtime_error
+#include <sys/socket.h>         //socket()    bind()    listen()    accept()    connect()    shutdown()    send()
+#include <sys/stat.h>           //lstat()    umask()
+#include <sys/un.h>             //sockaddr_un
+#include <unistd.h>             //read()    close()    unlink()
+
+#include "network.hpp"
+#include "server_data.hpp"
+
+//Message kinds and statuses
+#define NEURAL_SERVER_PREDICT 0
+#define NEURAL_SERVER_STATS   1
+#define NEURAL_SERVER_OK      0
+#define NEURAL_SERVER_ERROR   1
+//Predictions in the largest batch unless specified
+#define NEURAL_SERVER_BATCH 64
+//Microseconds a prediction may wait for others to batch with unless specified
+#define NEURAL_SERVER_LATENCY 1000
+//Latest predictions the latency percentiles are taken over
+#define NEURAL_SERVER_LATENCY_WINDOW 8192
+//Connections the kernel holds waiting to be accepted
+#define NEURAL_SERVER_BACKLOG 128
+
+namespace neural
+{
+  class InferenceServer
+  {
+  private:
+    /* Prediction waiting in the queue or running in a batch */
+    typedef struct {
+      const double* inputs;                             //Input values, owned by the connection
+      double* outputs;                                  //Where the output values go, owned by the connection
+      std::chrono::steady_clock::time_point arrival;    //When the last of the request was read
+      unsigned done;                                    //Flags that the batch has finished with the prediction
+      unsigned failed;                                  //Flags that the batch could not run, so there are no outputs
+    } server_pending;
+
+    /* Client connected to the server */
+    typedef struct {
+      int socket;                                       //Socket of the connection, closed once its thread is joined
+      std::thread thread;                               //Thread answering the connection
+      unsigned finished;                                //Flags that the thread has returned
+    } server_connection;
+
+    /* Network every batch runs through, only used by the batching thread */
+    Network* network;
+    /* Input and output values of each prediction */
+    unsigned inputWidth;
+    unsigned outputWidth;
+    /* Predictions in the largest batch */
+    unsigned batchSize;
+    /* Longest a prediction waits for others to batch with */
+    std::chrono::microseconds latency;
+    /* Location of the socket */
+    std::string path;
+    /* Socket connections are accepted on */
+    int listener;
+    /* Thread accepting connections */
+    std::thread acceptor;
+    /* Thread running the batches */
+    std::thread batcher;
+    /* Guards every member below */
+    std::mutex lock;
+    /* Signals the batching thread that a prediction arrived or the server is stopping */
+    std::condition_variable arrived;
+    /* Signals the connections that a batch has finished or the batching thread has returned */
+    std::condition_variable completed;
+    /* Predictions waiting for a batch, oldest first */
+    std::deque<server_pending*> queue;
+    /* Every connection not yet joined */
+    std::list<server_connection> connections;
+    /* Connections whose thread has not returned */
+    unsigned open;
+    /* Flags the threads to return */
+    unsigned stopping;
+    /* Flags that the batching thread is still running */
+    unsigned batching;
+    /* When the server started */
+    std::chrono::steady_clock::time_point started;
+    /* Counters since the server started */
+    uint64_t requests;
+    uint64_t batches;
+    uint64_t rejected;
+    uint64_t failed;
+    /* Microseconds each of the latest predictions took, written in turn */
+    std::vector<double> latencies;
+
+    /****************
+    * Accepts connections until the server stops, run on the accepting thread
+    ****************/
+    void acceptConnections();
+
+    /****************
+    * Answers one connection's requests until it closes or the server stops
+    * @param connection_in Connection to answer
+    ****************/
+    void serve(server_connection* connection_in);
+
+    /****************
+    * Queues one prediction and waits for its batch to run
+    * @param pending_in Prediction with its inputs read
+    * @return 0 if the server stopped before it ran
+    ****************/
+    unsigned predict(server_pending* pending_in);
+
+    /****************
+    * Takes predictions off the queue and runs them in batches until the server stops, run on the batching thread
+    ****************/
+    void runBatches();
+
+    /****************
+    * Joins and closes connections whose thread has returned, lock must be held
+    ****************/
+    void reapConnections();
+
+  public:
+    /****************
+    * Creates the socket and starts answering on it
+    * @param network_in Network to predict with in dense storage, not used by anything else until the server stops
+    * @param path_in    Location of the socket, a stale socket there is replaced
+    * @param batch_in   Predictions in the largest batch
+    * @param latency_in Microseconds a prediction may wait for others to batch with
+    ****************/
+    InferenceServer(Network* network_in, const char* path_in, unsigned batch_in = NEURAL_SERVER_BATCH, unsigned latency_in = NEURAL_SERVER_LATENCY);
+
+    /****************
+    * Stops the server
+    ****************/
+    ~InferenceServer();
+
+    /****************
+    * Closes every connection, joins every thread and removes the socket
+    ****************/
+    void stop();
+
+    /****************
+    * Finds the counters since the server started
+    * @param stats_out Location to store the counters
+    ****************/
+    void getStats(server_stats* stats_out);
+
+    /****************
+    * Reads exactly the given bytes from a socket, for the server and its clients
+    * @param socket_in Socket to read from
+    * @param data_out  Location to store the bytes
+    * @param bytes_in  Bytes to read
+    * @return 0 if the socket closed or failed first
+    ****************/
+    static unsigned readAll(int socket_in, void* data_out, size_t bytes_in);
+
+    /****************
+    * Writes all of the given bytes to a socket, for the server and its clients
+    * @param socket_in Socket to write to
+    * @param data_in   Bytes to write
+    * @param bytes_in  Bytes to write
+    * @return 0 if the socket closed or failed first
+    ****************/
+    static unsigned writeAll(int socket_in, const void* data_in, size_t bytes_in);
+
+    /****************
+    * Connects to a server
+    * @param path_in Location of the server's socket
+    * @return The connected socket
+    ****************/
+    static int connectTo(const char* path_in);
+  };
+}
+
+#endif
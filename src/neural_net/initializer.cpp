@@ -0,0 +1,136 @@
+//Seeded weight initialization
+#include "initializer.hpp"
+
+namespace neural
+{
+  //Creates an initializer
+  Initializer::Initializer(unsigned method_in, uint64_t seed_in)
+  {
+    if (method_in != NEURAL_INIT_UNIFORM && method_in != NEURAL_INIT_XAVIER && method_in != NEURAL_INIT_HE) {
+      throw std::runtime_error("Unsupported weight initialization method");
+    }
+    method = method_in;
+    seed = seed_in;
+    stream = 0;
+    scale = 1.0;
+  }
+
+  //Returns a copy that draws the weights of one layer
+  Initializer Initializer::forLayer(unsigned stream_in, unsigned fanIn_in, unsigned fanOut_in) const
+  {
+    Initializer layer(method, seed);
+
+    layer.stream = stream_in;
+    //Pick the range or deviation that keeps the variance of the sums steady from layer to layer
+    if (method == NEURAL_INIT_XAVIER && fanIn_in + fanOut_in > 0) {
+      layer.scale = sqrt(6.0 / (fanIn_in + fanOut_in));
+    }
+    if (method == NEURAL_INIT_HE && fanIn_in > 0) {
+      layer.scale = sqrt(2.0 / fanIn_in);
+    }
+    return layer;
+  }
+
+  //Turns the four random words of a block into its two weights
+  void Initializer::weights(uint32_t word0_in, uint32_t word1_in, uint32_t word2_in, uint32_t word3_in, double* weights_out) const
+  {
+    double first;
+    double second;
+    double radius;
+
+    //53 bits from each pair of words make a double in [0, 1), converted as signed since that is a single instruction
+    first = (int64_t) ((((uint64_t) word0_in << 32) | word1_in) >> 11) * (1.0 / 9007199254740992.0);
+    second = (int64_t) ((((uint64_t) word2_in << 32) | word3_in) >> 11) * (1.0 / 9007199254740992.0);
+    //Uniform ranges are [0, 1) stretched to their width and moved to their low end
+    if (method != NEURAL_INIT_HE) {
+      weights_out[0] = first * (method == NEURAL_INIT_XAVIER ? 2.0 * scale : 1.0) + (method == NEURAL_INIT_XAVIER ? -scale : 0.0);
+      weights_out[1] = second * (method == NEURAL_INIT_XAVIER ? 2.0 * scale : 1.0) + (method == NEURAL_INIT_XAVIER ? -scale : 0.0);
+      return;
+    }
+    //Box-Muller turns the two uniforms into two normals, the first kept out of 0 for the log
+    radius = sqrt(-2.0 * log(1.0 - first)) * scale;
+    weights_out[0] = radius * cos(2.0 * M_PI * second);
+    weights_out[1] = radius * sin(2.0 * M_PI * second);
+  }
+
+  //Returns the weight at a position in the layer
+  double Initializer::weight(size_t index_in) const
+  {
+    uint32_t words[4];
+    double pair[2];
+
+    //The position of the weight's pair and the layer are the counter, so every pair has its own block
+    words[0] = (uint32_t) (index_in / 2);
+    words[1] = (uint32_t) ((uint64_t) (index_in / 2) >> 32);
+    words[2] = stream;
+    words[3] = 0;
+    kernels::philox(words, (uint32_t) seed, (uint32_t) (seed >> 32), 1);
+    weights(words[0], words[1], words[2], words[3], pair);
+    return pair[index_in % 2];
+  }
+
+  //Fills a run of weights at consecutive positions
+  template<class Weight> void Initializer::fillRun(Weight* weights_out, size_t first_in, size_t count_in) const
+  {
+    uint32_t words[4 * NEURAL_INIT_LANES];
+    double pair[2];
+    double width;
+    double low;
+    size_t weightIterator;
+    size_t pairIterator;
+    unsigned laneIterator;
+
+    width = method == NEURAL_INIT_XAVIER ? 2.0 * scale : 1.0;
+    low = method == NEURAL_INIT_XAVIER ? -scale : 0.0;
+
+    //A run starting on the second weight of a pair takes that one weight alone
+    weightIterator = 0;
+    if (count_in > 0 && first_in % 2 == 1) {
+      weights_out[weightIterator++] = (Weight) weight(first_in);
+    }
+    //Whole groups of pairs share one call to the kernel
+    for (; weightIterator + 2 * NEURAL_INIT_LANES <= count_in; weightIterator += 2 * NEURAL_INIT_LANES) {
+      pairIterator = (first_in + weightIterator) / 2;
+      for (laneIterator = 0; laneIterator < NEURAL_INIT_LANES; ++laneIterator) {
+        words[laneIterator] = (uint32_t) (pairIterator + laneIterator);
+        words[NEURAL_INIT_LANES + laneIterator] = (uint32_t) ((uint64_t) (pairIterator + laneIterator) >> 32);
+        words[2 * NEURAL_INIT_LANES + laneIterator] = stream;
+        words[3 * NEURAL_INIT_LANES + laneIterator] = 0;
+      }
+      kernels::philox(words, (uint32_t) seed, (uint32_t) (seed >> 32), NEURAL_INIT_LANES);
+      //Uniform weights are converted in a plain loop the compiler can keep in registers, the same way weights() does
+      if (method != NEURAL_INIT_HE) {
+        for (laneIterator = 0; laneIterator < NEURAL_INIT_LANES; ++laneIterator) {
+          weights_out[weightIterator + 2 * laneIterator] = (Weight) ((int64_t) ((((uint64_t) words[laneIterator] << 32) | words[NEURAL_INIT_LANES + laneIterator]) >> 11) * (1.0 / 9007199254740992.0) * width + low);
+          weights_out[weightIterator + 2 * laneIterator + 1] = (Weight) ((int64_t) ((((uint64_t) words[2 * NEURAL_INIT_LANES + laneIterator] << 32) | words[3 * NEURAL_INIT_LANES + laneIterator]) >> 11) * (1.0 / 9007199254740992.0) * width + low);
+        }
+        continue;
+      }
+      for (laneIterator = 0; laneIterator < NEURAL_INIT_LANES; ++laneIterator) {
+        weights(words[laneIterator], words[NEURAL_INIT_LANES + laneIterator], words[2 * NEURAL_INIT_LANES + laneIterator], words[3 * NEURAL_INIT_LANES + laneIterator], pair);
+        weights_out[weightIterator + 2 * laneIterator] = (Weight) pair[0];
+        weights_out[weightIterator + 2 * laneIterator + 1] = (Weight) pair[1];
+      }
+    }
+    //The rest are drawn one at a time
+    for (; weightIterator < count_in; ++weightIterator) {
+      weights_out[weightIterator] = (Weight) weight(first_in + weightIterator);
+    }
+  }
+
+  //Fills a run of weights at consecutive positions
+  void Initializer::fill(double* weights_out, size_t first_in, size_t count_in) const
+  {
+    fillRun(weights_out, first_in, count_in);
+  }
+
+  //Fills a run of single precision weights at consecutive positions
+  void Initializer::fill(float* weights_out, size_t first_in, size_t count_in) const
+  {
+    fillRun(weights_out, first_in, count_in);
+  }
+
+  //Getters
+  unsigned Initializer::getMethod() const { return method; }
+  uint64_t Initializer::getSeed() const { return seed; }
+}
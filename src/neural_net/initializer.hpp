@@ -0,0 +1,105 @@
+/***********************************************************
+* Seeded weight initialization
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*   - Refused unknown distributions
+*
+* Draws weights from a Philox 4x32-10 counter-based generator.
+*   Each block of the generator gives two neighbouring weights, and
+*   the blocks of a run are generated together on the vectorized
+*   random number kernel.
+*   Each weight is a pure function of the seed, the layer and its
+*   position in the layer (the row-major index it would have in a
+*   dense matrix), so weights can be drawn in any order on any
+*   number of threads and still come out the same, and graph,
+*   dense and sparse networks built from one seed start alike.
+***********************************************************/
+
+#ifndef _H_NEURAL_INITIALIZER
+#define _H_NEURAL_INITIALIZER
+
+#include <stdint.h>   //uint32_t    uint64_t    int64_t
+#include <stddef.h>   //size_t
+#include <cmath>      //sqrt()    log()    cos()    sin()
+#include <stdexcept>  //std::runtime_error
+
+#include "kernels.hpp"
+
+//Uniform in [0, 1), how weights have always been drawn
+#define NEURAL_INIT_UNIFORM 0
+//Xavier / Glorot, uniform in +-sqrt(6 / (fan in + fan out)), suited to tanh and sigmoid
+#define NEURAL_INIT_XAVIER  1
+//He, normal with mean 0 and deviation sqrt(2 / fan in), suited to rectifiers
+#define NEURAL_INIT_HE      2
+
+//Seed used when none is given
+#define NEURAL_INIT_SEED 0x5eedull
+
+//Generator blocks run together on the random number kernel when filling a run of weights, each block gives two weights
+#define NEURAL_INIT_LANES 64
+
+namespace neural
+{
+  class Initializer
+  {
+  private:
+    /* NEURAL_INIT_* distribution weights are drawn from */
+    unsigned method;
+    /* Seed the generator is keyed with */
+    uint64_t seed;
+    /* Layer the weights are drawn for, each layer has its own stream */
+    unsigned stream;
+    /* Half width of the uniform range or deviation of the normal distribution */
+    double scale;
+
+    /***********************
+    * Turns the four random words of a block into its two weights
+    ***********************/
+    void weights(uint32_t word0_in, uint32_t word1_in, uint32_t word2_in, uint32_t word3_in, double* weights_out) const;
+
+    /***********************
+    * Fills a run of weights of either precision, a group of pairs at a time
+    ***********************/
+    template<class Weight> void fillRun(Weight* weights_out, size_t first_in, size_t count_in) const;
+
+  public:
+    /***********************
+    * Creates an initializer, the layer and fans are set by forLayer
+    * @param method_in NEURAL_INIT_* distribution to draw from, anything else throws
+    * @param seed_in   Seed for the generator
+    ***********************/
+    Initializer(unsigned method_in = NEURAL_INIT_UNIFORM, uint64_t seed_in = NEURAL_INIT_SEED);
+
+    /***********************
+    * Returns a copy that draws the weights of one layer
+    * @param stream_in Index of the layer in its network
+    * @param fanIn_in  Number of inputs (including bias) of each neuron in the layer
+    * @param fanOut_in Number of neurons each neuron in the layer outputs to
+    ***********************/
+    Initializer forLayer(unsigned stream_in, unsigned fanIn_in, unsigned fanOut_in) const;
+
+    /***********************
+    * Returns the weight at a position in the layer
+    * @param index_in Row-major position of the weight, neuron times inputs plus input
+    ***********************/
+    double weight(size_t index_in) const;
+
+    /***********************
+    * Fills a run of weights at consecutive positions
+    * @param weights_out Location of the first weight
+    * @param first_in    Position of the first weight
+    * @param count_in    Number of weights
+    ***********************/
+    void fill(double* weights_out, size_t first_in, size_t count_in) const;
+    void fill(float* weights_out, size_t first_in, size_t count_in) const;
+
+    unsigned getMethod() const;
+    uint64_t getSeed() const;
+  };
+}
+
+#endif
@@ -0,0 +1,920 @@
+//Vectorized inner loops shared by the dense layers
+#include "kernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NEURAL_KERNEL_X86
+#include <immintrin.h>   //SSE2    AVX2    AVX-512 intrinsics
+#endif
+
+//Philox 4x32 multipliers and key increments
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+namespace neural
+{
+  namespace kernels
+  {
+    //Sums the products of two arrays
+    double dotScalar(const double* a_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      double sum;
+
+      sum = 0.0;
+      for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+        sum += a_in[valueIterator] * b_in[valueIterator];
+      }
+      return sum;
+    }
+
+    //Adds a multiple of one array into another
+    void axpyScalar(double scale_in, const double* x_in, double* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+
+      for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+        y_in[valueIterator] += x_in[valueIterator] * scale_in;
+      }
+    }
+
+    //Sums the products of two arrays
+    float dotFloatScalar(const float* a_in, const float* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      float sum;
+
+      sum = 0.0f;
+      for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+        sum += a_in[valueIterator] * b_in[valueIterator];
+      }
+      return sum;
+    }
+
+    //Adds a multiple of one array into another
+    void axpyFloatScalar(float scale_in, const float* x_in, float* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+
+      for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+        y_in[valueIterator] += x_in[valueIterator] * scale_in;
+      }
+    }
+
+    //Sums the products of single precision weights and double precision values
+    double dotMixedScalar(const float* a_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      double sum;
+
+      sum = 0.0;
+      for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+        sum += (double) a_in[valueIterator] * b_in[valueIterator];
+      }
+      return sum;
+    }
+
+    //Adds a multiple of single precision weights into double precision values
+    void axpyMixedScalar(double scale_in, const float* x_in, double* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+
+      for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+        y_in[valueIterator] += (double) x_in[valueIterator] * scale_in;
+      }
+    }
+
+    //Sums the products of a sparse row's entries and the values they index
+    double dotSparseScalar(const double* a_in, const unsigned* index_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      double sum;
+
+      sum = 0.0;
+      for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+        sum += a_in[valueIterator] * b_in[index_in[valueIterator]];
+      }
+      return sum;
+    }
+
+    //Sums the products of two arrays of 8 bit integers
+    int32_t dotInt8Scalar(const int8_t* a_in, const int8_t* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      int32_t sum;
+
+      sum = 0;
+      for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+        sum += (int32_t) a_in[valueIterator] * b_in[valueIterator];
+      }
+      return sum;
+    }
+
+    //Runs the Philox rounds on a range of the counters, the rows are stride_in words apart
+    static void philoxRange(uint32_t* words_in, unsigned stride_in, unsigned first_in, unsigned last_in, uint32_t key0_in, uint32_t key1_in)
+    {
+      unsigned laneIterator;
+      unsigned roundIterator;
+      uint32_t key0;
+      uint32_t key1;
+      uint64_t product0;
+      uint64_t product1;
+      uint32_t word1;
+
+      for (laneIterator = first_in; laneIterator < last_in; ++laneIterator) {
+        key0 = key0_in;
+        key1 = key1_in;
+        for (roundIterator = 0; roundIterator < PHILOX_ROUNDS; ++roundIterator) {
+          product0 = (uint64_t) PHILOX_M0 * words_in[laneIterator];
+          product1 = (uint64_t) PHILOX_M1 * words_in[2 * stride_in + laneIterator];
+          word1 = words_in[stride_in + laneIterator];
+          words_in[stride_in + laneIterator] = (uint32_t) product1;
+          words_in[laneIterator] = (uint32_t) (product1 >> 32) ^ word1 ^ key0;
+          word1 = words_in[3 * stride_in + laneIterator];
+          words_in[3 * stride_in + laneIterator] = (uint32_t) product0;
+          words_in[2 * stride_in + laneIterator] = (uint32_t) (product0 >> 32) ^ word1 ^ key1;
+          key0 += PHILOX_W0;
+          key1 += PHILOX_W1;
+        }
+      }
+    }
+
+    //Runs the Philox rounds on a group of counters
+    void philoxScalar(uint32_t* words_in, uint32_t key0_in, uint32_t key1_in, unsigned length_in)
+    {
+      philoxRange(words_in, length_in, 0, length_in, key0_in, key1_in);
+    }
+
+#ifdef NEURAL_KERNEL_X86
+    //SSE2 kernels, two accumulators to hide the add latency
+    static double dotSSE2(const double* a_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m128d sum0;
+      __m128d sum1;
+      double lanes[2];
+
+      sum0 = _mm_setzero_pd();
+      sum1 = _mm_setzero_pd();
+      for (valueIterator = 0; valueIterator + 4 <= length_in; valueIterator += 4) {
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(a_in + valueIterator), _mm_loadu_pd(b_in + valueIterator)));
+        sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(a_in + valueIterator + 2), _mm_loadu_pd(b_in + valueIterator + 2)));
+      }
+      _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+      return lanes[0] + lanes[1] + dotScalar(a_in + valueIterator, b_in + valueIterator, length_in - valueIterator);
+    }
+
+    static void axpySSE2(double scale_in, const double* x_in, double* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m128d scale;
+
+      scale = _mm_set1_pd(scale_in);
+      for (valueIterator = 0; valueIterator + 2 <= length_in; valueIterator += 2) {
+        _mm_storeu_pd(y_in + valueIterator, _mm_add_pd(_mm_loadu_pd(y_in + valueIterator), _mm_mul_pd(_mm_loadu_pd(x_in + valueIterator), scale)));
+      }
+      axpyScalar(scale_in, x_in + valueIterator, y_in + valueIterator, length_in - valueIterator);
+    }
+
+    static float dotFloatSSE2(const float* a_in, const float* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m128 sum0;
+      __m128 sum1;
+      float lanes[4];
+
+      sum0 = _mm_setzero_ps();
+      sum1 = _mm_setzero_ps();
+      for (valueIterator = 0; valueIterator + 8 <= length_in; valueIterator += 8) {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a_in + valueIterator), _mm_loadu_ps(b_in + valueIterator)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a_in + valueIterator + 4), _mm_loadu_ps(b_in + valueIterator + 4)));
+      }
+      _mm_storeu_ps(lanes, _mm_add_ps(sum0, sum1));
+      return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dotFloatScalar(a_in + valueIterator, b_in + valueIterator, length_in - valueIterator);
+    }
+
+    static void axpyFloatSSE2(float scale_in, const float* x_in, float* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m128 scale;
+
+      scale = _mm_set1_ps(scale_in);
+      for (valueIterator = 0; valueIterator + 4 <= length_in; valueIterator += 4) {
+        _mm_storeu_ps(y_in + valueIterator, _mm_add_ps(_mm_loadu_ps(y_in + valueIterator), _mm_mul_ps(_mm_loadu_ps(x_in + valueIterator), scale)));
+      }
+      axpyFloatScalar(scale_in, x_in + valueIterator, y_in + valueIterator, length_in - valueIterator);
+    }
+
+    static double dotMixedSSE2(const float* a_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m128 weights;
+      __m128d sum0;
+      __m128d sum1;
+      double lanes[2];
+
+      sum0 = _mm_setzero_pd();
+      sum1 = _mm_setzero_pd();
+      for (valueIterator = 0; valueIterator + 4 <= length_in; valueIterator += 4) {
+        //Widen four weights to two pairs of doubles
+        weights = _mm_loadu_ps(a_in + valueIterator);
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_cvtps_pd(weights), _mm_loadu_pd(b_in + valueIterator)));
+        sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(weights, weights)), _mm_loadu_pd(b_in + valueIterator + 2)));
+      }
+      _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+      return lanes[0] + lanes[1] + dotMixedScalar(a_in + valueIterator, b_in + valueIterator, length_in - valueIterator);
+    }
+
+    static void axpyMixedSSE2(double scale_in, const float* x_in, double* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m128d scale;
+      __m128 weights;
+
+      scale = _mm_set1_pd(scale_in);
+      for (valueIterator = 0; valueIterator + 4 <= length_in; valueIterator += 4) {
+        weights = _mm_loadu_ps(x_in + valueIterator);
+        _mm_storeu_pd(y_in + valueIterator, _mm_add_pd(_mm_loadu_pd(y_in + valueIterator), _mm_mul_pd(_mm_cvtps_pd(weights), scale)));
+        _mm_storeu_pd(y_in + valueIterator + 2, _mm_add_pd(_mm_loadu_pd(y_in + valueIterator + 2), _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(weights, weights)), scale)));
+      }
+      axpyMixedScalar(scale_in, x_in + valueIterator, y_in + valueIterator, length_in - valueIterator);
+    }
+
+    //SSE2 has no gather, two accumulators still let the indexed loads overlap
+    static double dotSparseSSE2(const double* a_in, const unsigned* index_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m128d sum0;
+      __m128d sum1;
+      double lanes[2];
+
+      sum0 = _mm_setzero_pd();
+      sum1 = _mm_setzero_pd();
+      for (valueIterator = 0; valueIterator + 4 <= length_in; valueIterator += 4) {
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(a_in + valueIterator), _mm_setr_pd(b_in[index_in[valueIterator]], b_in[index_in[valueIterator + 1]])));
+        sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(a_in + valueIterator + 2), _mm_setr_pd(b_in[index_in[valueIterator + 2]], b_in[index_in[valueIterator + 3]])));
+      }
+      _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+      return lanes[0] + lanes[1] + dotSparseScalar(a_in + valueIterator, index_in + valueIterator, b_in, length_in - valueIterator);
+    }
+
+    //Sign extends each half of 16 bytes to 16 bit lanes, pairs of products are summed into 32 bit lanes without overflow
+    static int32_t dotInt8SSE2(const int8_t* a_in, const int8_t* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m128i a;
+      __m128i b;
+      __m128i sum;
+      int32_t lanes[4];
+
+      sum = _mm_setzero_si128();
+      for (valueIterator = 0; valueIterator + 16 <= length_in; valueIterator += 16) {
+        a = _mm_loadu_si128((const __m128i*) (a_in + valueIterator));
+        b = _mm_loadu_si128((const __m128i*) (b_in + valueIterator));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_srai_epi16(_mm_unpacklo_epi8(a, a), 8), _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8)));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_srai_epi16(_mm_unpackhi_epi8(a, a), 8), _mm_srai_epi16(_mm_unpackhi_epi8(b, b), 8)));
+      }
+      _mm_storeu_si128((__m128i*) lanes, sum);
+      return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dotInt8Scalar(a_in + valueIterator, b_in + valueIterator, length_in - valueIterator);
+    }
+
+    //Philox rounds on four counters at once, the 32 bit halves of each product are split out of two 64 bit multiplies
+    static void philoxSSE2(uint32_t* words_in, uint32_t key0_in, uint32_t key1_in, unsigned length_in)
+    {
+      unsigned laneIterator;
+      unsigned roundIterator;
+      __m128i word0;
+      __m128i word1;
+      __m128i word2;
+      __m128i word3;
+      __m128i key0;
+      __m128i key1;
+      __m128i even;
+      __m128i odd;
+      __m128i high0;
+      __m128i low0;
+      __m128i high1;
+      __m128i low1;
+      __m128i lowHalves;
+
+      lowHalves = _mm_set1_epi64x(0xFFFFFFFFll);
+      for (laneIterator = 0; laneIterator + 4 <= length_in; laneIterator += 4) {
+        word0 = _mm_loadu_si128((__m128i*) (words_in + laneIterator));
+        word1 = _mm_loadu_si128((__m128i*) (words_in + length_in + laneIterator));
+        word2 = _mm_loadu_si128((__m128i*) (words_in + 2 * length_in + laneIterator));
+        word3 = _mm_loadu_si128((__m128i*) (words_in + 3 * length_in + laneIterator));
+        key0 = _mm_set1_epi32((int) key0_in);
+        key1 = _mm_set1_epi32((int) key1_in);
+        for (roundIterator = 0; roundIterator < PHILOX_ROUNDS; ++roundIterator) {
+          even = _mm_mul_epu32(word0, _mm_set1_epi32((int) PHILOX_M0));
+          odd = _mm_mul_epu32(_mm_srli_epi64(word0, 32), _mm_set1_epi32((int) PHILOX_M0));
+          high0 = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(lowHalves, odd));
+          low0 = _mm_or_si128(_mm_and_si128(even, lowHalves), _mm_slli_epi64(odd, 32));
+          even = _mm_mul_epu32(word2, _mm_set1_epi32((int) PHILOX_M1));
+          odd = _mm_mul_epu32(_mm_srli_epi64(word2, 32), _mm_set1_epi32((int) PHILOX_M1));
+          high1 = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(lowHalves, odd));
+          low1 = _mm_or_si128(_mm_and_si128(even, lowHalves), _mm_slli_epi64(odd, 32));
+          word0 = _mm_xor_si128(_mm_xor_si128(high1, word1), key0);
+          word2 = _mm_xor_si128(_mm_xor_si128(high0, word3), key1);
+          word1 = low1;
+          word3 = low0;
+          key0 = _mm_add_epi32(key0, _mm_set1_epi32((int) PHILOX_W0));
+          key1 = _mm_add_epi32(key1, _mm_set1_epi32((int) PHILOX_W1));
+        }
+        _mm_storeu_si128((__m128i*) (words_in + laneIterator), word0);
+        _mm_storeu_si128((__m128i*) (words_in + length_in + laneIterator), word1);
+        _mm_storeu_si128((__m128i*) (words_in + 2 * length_in + laneIterator), word2);
+        _mm_storeu_si128((__m128i*) (words_in + 3 * length_in + laneIterator), word3);
+      }
+      philoxRange(words_in, length_in, laneIterator, length_in, key0_in, key1_in);
+    }
+
+    //GCC 12's AVX2 and AVX-512 headers fill the lanes a gather, shift, widen or extract ignores from a vector initialized
+    //from itself, which -Wuninitialized reports wherever those intrinsics are inlined, so it is silenced for these kernels only
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+    //AVX2 kernels, four fused multiply-add accumulators to cover the FMA latency
+    __attribute__((target("avx2,fma")))
+    static double dotAVX2(const double* a_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m256d sum0;
+      __m256d sum1;
+      __m256d sum2;
+      __m256d sum3;
+      __m128d half;
+
+      sum0 = _mm256_setzero_pd();
+      sum1 = _mm256_setzero_pd();
+      sum2 = _mm256_setzero_pd();
+      sum3 = _mm256_setzero_pd();
+      for (valueIterator = 0; valueIterator + 16 <= length_in; valueIterator += 16) {
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a_in + valueIterator), _mm256_loadu_pd(b_in + valueIterator), sum0);
+        sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(a_in + valueIterator + 4), _mm256_loadu_pd(b_in + valueIterator + 4), sum1);
+        sum2 = _mm256_fmadd_pd(_mm256_loadu_pd(a_in + valueIterator + 8), _mm256_loadu_pd(b_in + valueIterator + 8), sum2);
+        sum3 = _mm256_fmadd_pd(_mm256_loadu_pd(a_in + valueIterator + 12), _mm256_loadu_pd(b_in + valueIterator + 12), sum3);
+      }
+      for (; valueIterator + 4 <= length_in; valueIterator += 4) {
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a_in + valueIterator), _mm256_loadu_pd(b_in + valueIterator), sum0);
+      }
+      sum0 = _mm256_add_pd(_mm256_add_pd(sum0, sum1), _mm256_add_pd(sum2, sum3));
+      half = _mm_add_pd(_mm256_castpd256_pd128(sum0), _mm256_extractf128_pd(sum0, 1));
+      half = _mm_add_sd(half, _mm_unpackhi_pd(half, half));
+      return _mm_cvtsd_f64(half) + dotScalar(a_in + valueIterator, b_in + valueIterator, length_in - valueIterator);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void axpyAVX2(double scale_in, const double* x_in, double* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m256d scale;
+      __m256i tail;
+
+      scale = _mm256_set1_pd(scale_in);
+      for (valueIterator = 0; valueIterator + 4 <= length_in; valueIterator += 4) {
+        _mm256_storeu_pd(y_in + valueIterator, _mm256_fmadd_pd(_mm256_loadu_pd(x_in + valueIterator), scale, _mm256_loadu_pd(y_in + valueIterator)));
+      }
+      //Finish with a masked fused multiply-add so every element rounds the same way wherever the array was split
+      if (valueIterator < length_in) {
+        tail = _mm256_cmpgt_epi64(_mm256_set1_epi64x(length_in - valueIterator), _mm256_setr_epi64x(0, 1, 2, 3));
+        _mm256_maskstore_pd(y_in + valueIterator, tail, _mm256_fmadd_pd(_mm256_maskload_pd(x_in + valueIterator, tail), scale, _mm256_maskload_pd(y_in + valueIterator, tail)));
+      }
+    }
+
+    __attribute__((target("avx2,fma")))
+    static float dotFloatAVX2(const float* a_in, const float* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m256 sum0;
+      __m256 sum1;
+      __m128 half;
+
+      sum0 = _mm256_setzero_ps();
+      sum1 = _mm256_setzero_ps();
+      for (valueIterator = 0; valueIterator + 16 <= length_in; valueIterator += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a_in + valueIterator), _mm256_loadu_ps(b_in + valueIterator), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a_in + valueIterator + 8), _mm256_loadu_ps(b_in + valueIterator + 8), sum1);
+      }
+      sum0 = _mm256_add_ps(sum0, sum1);
+      half = _mm_add_ps(_mm256_castps256_ps128(sum0), _mm256_extractf128_ps(sum0, 1));
+      half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+      half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+      return _mm_cvtss_f32(half) + dotFloatScalar(a_in + valueIterator, b_in + valueIterator, length_in - valueIterator);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void axpyFloatAVX2(float scale_in, const float* x_in, float* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m256 scale;
+      __m256i tail;
+
+      scale = _mm256_set1_ps(scale_in);
+      for (valueIterator = 0; valueIterator + 8 <= length_in; valueIterator += 8) {
+        _mm256_storeu_ps(y_in + valueIterator, _mm256_fmadd_ps(_mm256_loadu_ps(x_in + valueIterator), scale, _mm256_loadu_ps(y_in + valueIterator)));
+      }
+      //Finish with a masked fused multiply-add so every element rounds the same way wherever the array was split
+      if (valueIterator < length_in) {
+        tail = _mm256_cmpgt_epi32(_mm256_set1_epi32(length_in - valueIterator), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        _mm256_maskstore_ps(y_in + valueIterator, tail, _mm256_fmadd_ps(_mm256_maskload_ps(x_in + valueIterator, tail), scale, _mm256_maskload_ps(y_in + valueIterator, tail)));
+      }
+    }
+
+    __attribute__((target("avx2,fma")))
+    static double dotMixedAVX2(const float* a_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m256d sum0;
+      __m256d sum1;
+      __m128d half;
+
+      sum0 = _mm256_setzero_pd();
+      sum1 = _mm256_setzero_pd();
+      for (valueIterator = 0; valueIterator + 8 <= length_in; valueIterator += 8) {
+        sum0 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a_in + valueIterator)), _mm256_loadu_pd(b_in + valueIterator), sum0);
+        sum1 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a_in + valueIterator + 4)), _mm256_loadu_pd(b_in + valueIterator + 4), sum1);
+      }
+      sum0 = _mm256_add_pd(sum0, sum1);
+      half = _mm_add_pd(_mm256_castpd256_pd128(sum0), _mm256_extractf128_pd(sum0, 1));
+      half = _mm_add_sd(half, _mm_unpackhi_pd(half, half));
+      return _mm_cvtsd_f64(half) + dotMixedScalar(a_in + valueIterator, b_in + valueIterator, length_in - valueIterator);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static void axpyMixedAVX2(double scale_in, const float* x_in, double* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m256d scale;
+      __m256i tail;
+
+      scale = _mm256_set1_pd(scale_in);
+      for (valueIterator = 0; valueIterator + 4 <= length_in; valueIterator += 4) {
+        _mm256_storeu_pd(y_in + valueIterator, _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(x_in + valueIterator)), scale, _mm256_loadu_pd(y_in + valueIterator)));
+      }
+      //Finish with a masked fused multiply-add so every element rounds the same way wherever the array was split
+      if (valueIterator < length_in) {
+        tail = _mm256_cmpgt_epi64(_mm256_set1_epi64x(length_in - valueIterator), _mm256_setr_epi64x(0, 1, 2, 3));
+        _mm256_maskstore_pd(y_in + valueIterator, tail, _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_maskload_ps(x_in + valueIterator, _mm_cmpgt_epi32(_mm_set1_epi32(length_in - valueIterator), _mm_setr_epi32(0, 1, 2, 3)))), scale, _mm256_maskload_pd(y_in + valueIterator, tail)));
+      }
+    }
+
+    __attribute__((target("avx2,fma")))
+    static double dotSparseAVX2(const double* a_in, const unsigned* index_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m256d sum0;
+      __m256d sum1;
+      __m128d half;
+
+      sum0 = _mm256_setzero_pd();
+      sum1 = _mm256_setzero_pd();
+      for (valueIterator = 0; valueIterator + 8 <= length_in; valueIterator += 8) {
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a_in + valueIterator), _mm256_i32gather_pd(b_in, _mm_loadu_si128((const __m128i*) (index_in + valueIterator)), 8), sum0);
+        sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(a_in + valueIterator + 4), _mm256_i32gather_pd(b_in, _mm_loadu_si128((const __m128i*) (index_in + valueIterator + 4)), 8), sum1);
+      }
+      sum0 = _mm256_add_pd(sum0, sum1);
+      half = _mm_add_pd(_mm256_castpd256_pd128(sum0), _mm256_extractf128_pd(sum0, 1));
+      half = _mm_add_sd(half, _mm_unpackhi_pd(half, half));
+      return _mm_cvtsd_f64(half) + dotSparseScalar(a_in + valueIterator, index_in + valueIterator, b_in, length_in - valueIterator);
+    }
+
+    __attribute__((target("avx2")))
+    static int32_t dotInt8AVX2(const int8_t* a_in, const int8_t* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m256i sum0;
+      __m256i sum1;
+      __m128i half;
+
+      sum0 = _mm256_setzero_si256();
+      sum1 = _mm256_setzero_si256();
+      for (valueIterator = 0; valueIterator + 32 <= length_in; valueIterator += 32) {
+        sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (a_in + valueIterator))), _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (b_in + valueIterator)))));
+        sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (a_in + valueIterator + 16))), _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (b_in + valueIterator + 16)))));
+      }
+      sum0 = _mm256_add_epi32(sum0, sum1);
+      half = _mm_add_epi32(_mm256_castsi256_si128(sum0), _mm256_extracti128_si256(sum0, 1));
+      half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+      half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+      return _mm_cvtsi128_si32(half) + dotInt8Scalar(a_in + valueIterator, b_in + valueIterator, length_in - valueIterator);
+    }
+
+    //Philox rounds on eight counters at once
+    __attribute__((target("avx2")))
+    static void philoxAVX2(uint32_t* words_in, uint32_t key0_in, uint32_t key1_in, unsigned length_in)
+    {
+      unsigned laneIterator;
+      unsigned roundIterator;
+      __m256i word0;
+      __m256i word1;
+      __m256i word2;
+      __m256i word3;
+      __m256i key0;
+      __m256i key1;
+      __m256i even;
+      __m256i odd;
+      __m256i high0;
+      __m256i low0;
+      __m256i high1;
+      __m256i low1;
+      __m256i lowHalves;
+
+      lowHalves = _mm256_set1_epi64x(0xFFFFFFFFll);
+      for (laneIterator = 0; laneIterator + 8 <= length_in; laneIterator += 8) {
+        word0 = _mm256_loadu_si256((__m256i*) (words_in + laneIterator));
+        word1 = _mm256_loadu_si256((__m256i*) (words_in + length_in + laneIterator));
+        word2 = _mm256_loadu_si256((__m256i*) (words_in + 2 * length_in + laneIterator));
+        word3 = _mm256_loadu_si256((__m256i*) (words_in + 3 * length_in + laneIterator));
+        key0 = _mm256_set1_epi32((int) key0_in);
+        key1 = _mm256_set1_epi32((int) key1_in);
+        for (roundIterator = 0; roundIterator < PHILOX_ROUNDS; ++roundIterator) {
+          even = _mm256_mul_epu32(word0, _mm256_set1_epi32((int) PHILOX_M0));
+          odd = _mm256_mul_epu32(_mm256_srli_epi64(word0, 32), _mm256_set1_epi32((int) PHILOX_M0));
+          high0 = _mm256_or_si256(_mm256_srli_epi64(even, 32), _mm256_andnot_si256(lowHalves, odd));
+          low0 = _mm256_or_si256(_mm256_and_si256(even, lowHalves), _mm256_slli_epi64(odd, 32));
+          even = _mm256_mul_epu32(word2, _mm256_set1_epi32((int) PHILOX_M1));
+          odd = _mm256_mul_epu32(_mm256_srli_epi64(word2, 32), _mm256_set1_epi32((int) PHILOX_M1));
+          high1 = _mm256_or_si256(_mm256_srli_epi64(even, 32), _mm256_andnot_si256(lowHalves, odd));
+          low1 = _mm256_or_si256(_mm256_and_si256(even, lowHalves), _mm256_slli_epi64(odd, 32));
+          word0 = _mm256_xor_si256(_mm256_xor_si256(high1, word1), key0);
+          word2 = _mm256_xor_si256(_mm256_xor_si256(high0, word3), key1);
+          word1 = low1;
+          word3 = low0;
+          key0 = _mm256_add_epi32(key0, _mm256_set1_epi32((int) PHILOX_W0));
+          key1 = _mm256_add_epi32(key1, _mm256_set1_epi32((int) PHILOX_W1));
+        }
+        _mm256_storeu_si256((__m256i*) (words_in + laneIterator), word0);
+        _mm256_storeu_si256((__m256i*) (words_in + length_in + laneIterator), word1);
+        _mm256_storeu_si256((__m256i*) (words_in + 2 * length_in + laneIterator), word2);
+        _mm256_storeu_si256((__m256i*) (words_in + 3 * length_in + laneIterator), word3);
+      }
+      //The compiler leaves the upper halves dirty when the scalar rest is inlined, which slows every later SSE instruction
+      _mm256_zeroupper();
+      philoxRange(words_in, length_in, laneIterator, length_in, key0_in, key1_in);
+    }
+
+    //AVX-512 kernels, masked loads finish the tail without a scalar loop
+    __attribute__((target("avx512f")))
+    static double dotAVX512(const double* a_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m512d sum0;
+      __m512d sum1;
+      __mmask8 tail;
+
+      sum0 = _mm512_setzero_pd();
+      sum1 = _mm512_setzero_pd();
+      for (valueIterator = 0; valueIterator + 16 <= length_in; valueIterator += 16) {
+        sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(a_in + valueIterator), _mm512_loadu_pd(b_in + valueIterator), sum0);
+        sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(a_in + valueIterator + 8), _mm512_loadu_pd(b_in + valueIterator + 8), sum1);
+      }
+      for (; valueIterator < length_in; valueIterator += 8) {
+        tail = length_in - valueIterator >= 8 ? 0xFF : (__mmask8) ((1u << (length_in - valueIterator)) - 1);
+        sum0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, a_in + valueIterator), _mm512_maskz_loadu_pd(tail, b_in + valueIterator), sum0);
+      }
+      return _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+    }
+
+    __attribute__((target("avx512f")))
+    static void axpyAVX512(double scale_in, const double* x_in, double* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m512d scale;
+      __mmask8 tail;
+
+      scale = _mm512_set1_pd(scale_in);
+      for (valueIterator = 0; valueIterator < length_in; valueIterator += 8) {
+        tail = length_in - valueIterator >= 8 ? 0xFF : (__mmask8) ((1u << (length_in - valueIterator)) - 1);
+        _mm512_mask_storeu_pd(y_in + valueIterator, tail, _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, x_in + valueIterator), scale, _mm512_maskz_loadu_pd(tail, y_in + valueIterator)));
+      }
+    }
+
+    __attribute__((target("avx512f")))
+    static float dotFloatAVX512(const float* a_in, const float* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m512 sum0;
+      __mmask16 tail;
+
+      sum0 = _mm512_setzero_ps();
+      for (valueIterator = 0; valueIterator < length_in; valueIterator += 16) {
+        tail = length_in - valueIterator >= 16 ? 0xFFFF : (__mmask16) ((1u << (length_in - valueIterator)) - 1);
+        sum0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(tail, a_in + valueIterator), _mm512_maskz_loadu_ps(tail, b_in + valueIterator), sum0);
+      }
+      return _mm512_reduce_add_ps(sum0);
+    }
+
+    __attribute__((target("avx512f")))
+    static void axpyFloatAVX512(float scale_in, const float* x_in, float* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m512 scale;
+      __mmask16 tail;
+
+      scale = _mm512_set1_ps(scale_in);
+      for (valueIterator = 0; valueIterator < length_in; valueIterator += 16) {
+        tail = length_in - valueIterator >= 16 ? 0xFFFF : (__mmask16) ((1u << (length_in - valueIterator)) - 1);
+        _mm512_mask_storeu_ps(y_in + valueIterator, tail, _mm512_fmadd_ps(_mm512_maskz_loadu_ps(tail, x_in + valueIterator), scale, _mm512_maskz_loadu_ps(tail, y_in + valueIterator)));
+      }
+    }
+
+    __attribute__((target("avx512f")))
+    static double dotMixedAVX512(const float* a_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m512d sum0;
+      __m512d sum1;
+      __mmask8 tail;
+
+      sum0 = _mm512_setzero_pd();
+      sum1 = _mm512_setzero_pd();
+      for (valueIterator = 0; valueIterator + 16 <= length_in; valueIterator += 16) {
+        sum0 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a_in + valueIterator)), _mm512_loadu_pd(b_in + valueIterator), sum0);
+        sum1 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a_in + valueIterator + 8)), _mm512_loadu_pd(b_in + valueIterator + 8), sum1);
+      }
+      for (; valueIterator < length_in; valueIterator += 8) {
+        tail = length_in - valueIterator >= 8 ? 0xFF : (__mmask8) ((1u << (length_in - valueIterator)) - 1);
+        sum0 = _mm512_fmadd_pd(_mm512_maskz_cvtps_pd(tail, _mm512_castps512_ps256(_mm512_maskz_loadu_ps((__mmask16) tail, a_in + valueIterator))), _mm512_maskz_loadu_pd(tail, b_in + valueIterator), sum0);
+      }
+      return _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+    }
+
+    __attribute__((target("avx512f")))
+    static void axpyMixedAVX512(double scale_in, const float* x_in, double* y_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m512d scale;
+      __mmask8 tail;
+
+      scale = _mm512_set1_pd(scale_in);
+      for (valueIterator = 0; valueIterator < length_in; valueIterator += 8) {
+        tail = length_in - valueIterator >= 8 ? 0xFF : (__mmask8) ((1u << (length_in - valueIterator)) - 1);
+        _mm512_mask_storeu_pd(y_in + valueIterator, tail, _mm512_fmadd_pd(_mm512_maskz_cvtps_pd(tail, _mm512_castps512_ps256(_mm512_maskz_loadu_ps((__mmask16) tail, x_in + valueIterator))), scale, _mm512_maskz_loadu_pd(tail, y_in + valueIterator)));
+      }
+    }
+
+    __attribute__((target("avx512f")))
+    static double dotSparseAVX512(const double* a_in, const unsigned* index_in, const double* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m512d sum0;
+      __m512d sum1;
+      __m256i index;
+      __mmask8 tail;
+
+      sum0 = _mm512_setzero_pd();
+      sum1 = _mm512_setzero_pd();
+      for (valueIterator = 0; valueIterator + 16 <= length_in; valueIterator += 16) {
+        sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(a_in + valueIterator), _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i*) (index_in + valueIterator)), b_in, 8), sum0);
+        sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(a_in + valueIterator + 8), _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i*) (index_in + valueIterator + 8)), b_in, 8), sum1);
+      }
+      //Masked lanes neither load an index nor gather a value
+      for (; valueIterator < length_in; valueIterator += 8) {
+        tail = length_in - valueIterator >= 8 ? 0xFF : (__mmask8) ((1u << (length_in - valueIterator)) - 1);
+        index = _mm512_castsi512_si256(_mm512_maskz_loadu_epi32((__mmask16) tail, index_in + valueIterator));
+        sum0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, a_in + valueIterator), _mm512_mask_i32gather_pd(_mm512_setzero_pd(), tail, index, b_in, 8), sum0);
+      }
+      return _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+    }
+
+    //Byte lanes need AVX-512BW, which every processor with VNNI also has
+    __attribute__((target("avx512f,avx512bw")))
+    static int32_t dotInt8AVX512(const int8_t* a_in, const int8_t* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m512i sum;
+      __mmask32 tail;
+
+      sum = _mm512_setzero_si512();
+      for (valueIterator = 0; valueIterator < length_in; valueIterator += 32) {
+        tail = length_in - valueIterator >= 32 ? 0xFFFFFFFF : (__mmask32) ((1u << (length_in - valueIterator)) - 1);
+        sum = _mm512_add_epi32(sum, _mm512_madd_epi16(_mm512_cvtepi8_epi16(_mm512_castsi512_si256(_mm512_maskz_loadu_epi8((__mmask64) tail, a_in + valueIterator))), _mm512_cvtepi8_epi16(_mm512_castsi512_si256(_mm512_maskz_loadu_epi8((__mmask64) tail, b_in + valueIterator)))));
+      }
+      return _mm512_reduce_add_epi32(sum);
+    }
+
+    //VNNI multiplies unsigned by signed bytes, so one side is offset by 128 and the offset times the other side's sum taken back off
+    __attribute__((target("avx512f,avx512bw,avx512vnni")))
+    static int32_t dotInt8VNNI(const int8_t* a_in, const int8_t* b_in, unsigned length_in)
+    {
+      unsigned valueIterator;
+      __m512i sum0;
+      __m512i sum1;
+      __m512i offsetSum0;
+      __m512i offsetSum1;
+      __m512i a0;
+      __m512i a1;
+      __m512i offset;
+      __m512i ones;
+      __mmask64 tail;
+
+      sum0 = _mm512_setzero_si512();
+      sum1 = _mm512_setzero_si512();
+      offsetSum0 = _mm512_setzero_si512();
+      offsetSum1 = _mm512_setzero_si512();
+      offset = _mm512_set1_epi8((char) 0x80);
+      ones = _mm512_set1_epi8(1);
+      //Two independent chains hide the latency of the dot product instruction
+      for (valueIterator = 0; valueIterator + 128 <= length_in; valueIterator += 128) {
+        a0 = _mm512_loadu_si512(a_in + valueIterator);
+        a1 = _mm512_loadu_si512(a_in + valueIterator + 64);
+        sum0 = _mm512_dpbusd_epi32(sum0, _mm512_xor_si512(_mm512_loadu_si512(b_in + valueIterator), offset), a0);
+        sum1 = _mm512_dpbusd_epi32(sum1, _mm512_xor_si512(_mm512_loadu_si512(b_in + valueIterator + 64), offset), a1);
+        offsetSum0 = _mm512_dpbusd_epi32(offsetSum0, ones, a0);
+        offsetSum1 = _mm512_dpbusd_epi32(offsetSum1, ones, a1);
+      }
+      for (; valueIterator < length_in; valueIterator += 64) {
+        tail = length_in - valueIterator >= 64 ? ~(__mmask64) 0 : (((__mmask64) 1 << (length_in - valueIterator)) - 1);
+        a0 = _mm512_maskz_loadu_epi8(tail, a_in + valueIterator);
+        sum0 = _mm512_dpbusd_epi32(sum0, _mm512_xor_si512(_mm512_maskz_loadu_epi8(tail, b_in + valueIterator), offset), a0);
+        offsetSum0 = _mm512_dpbusd_epi32(offsetSum0, ones, a0);
+      }
+      sum0 = _mm512_add_epi32(sum0, sum1);
+      offsetSum0 = _mm512_add_epi32(offsetSum0, offsetSum1);
+      return _mm512_reduce_add_epi32(_mm512_sub_epi32(sum0, _mm512_slli_epi32(offsetSum0, 7)));
+    }
+
+    //Philox rounds on sixteen counters at once
+    __attribute__((target("avx512f")))
+    static void philoxAVX512(uint32_t* words_in, uint32_t key0_in, uint32_t key1_in, unsigned length_in)
+    {
+      unsigned laneIterator;
+      unsigned roundIterator;
+      __m512i word0;
+      __m512i word1;
+      __m512i word2;
+      __m512i word3;
+      __m512i key0;
+      __m512i key1;
+      __m512i even;
+      __m512i odd;
+      __m512i high0;
+      __m512i low0;
+      __m512i high1;
+      __m512i low1;
+      __m512i lowHalves;
+
+      lowHalves = _mm512_set1_epi64(0xFFFFFFFFll);
+      for (laneIterator = 0; laneIterator + 16 <= length_in; laneIterator += 16) {
+        word0 = _mm512_loadu_si512((__m512i*) (words_in + laneIterator));
+        word1 = _mm512_loadu_si512((__m512i*) (words_in + length_in + laneIterator));
+        word2 = _mm512_loadu_si512((__m512i*) (words_in + 2 * length_in + laneIterator));
+        word3 = _mm512_loadu_si512((__m512i*) (words_in + 3 * length_in + laneIterator));
+        key0 = _mm512_set1_epi32((int) key0_in);
+        key1 = _mm512_set1_epi32((int) key1_in);
+        for (roundIterator = 0; roundIterator < PHILOX_ROUNDS; ++roundIterator) {
+          even = _mm512_mul_epu32(word0, _mm512_set1_epi32((int) PHILOX_M0));
+          odd = _mm512_mul_epu32(_mm512_srli_epi64(word0, 32), _mm512_set1_epi32((int) PHILOX_M0));
+          high0 = _mm512_or_si512(_mm512_srli_epi64(even, 32), _mm512_andnot_si512(lowHalves, odd));
+          low0 = _mm512_or_si512(_mm512_and_si512(even, lowHalves), _mm512_slli_epi64(odd, 32));
+          even = _mm512_mul_epu32(word2, _mm512_set1_epi32((int) PHILOX_M1));
+          odd = _mm512_mul_epu32(_mm512_srli_epi64(word2, 32), _mm512_set1_epi32((int) PHILOX_M1));
+          high1 = _mm512_or_si512(_mm512_srli_epi64(even, 32), _mm512_andnot_si512(lowHalves, odd));
+          low1 = _mm512_or_si512(_mm512_and_si512(even, lowHalves), _mm512_slli_epi64(odd, 32));
+          word0 = _mm512_xor_si512(_mm512_xor_si512(high1, word1), key0);
+          word2 = _mm512_xor_si512(_mm512_xor_si512(high0, word3), key1);
+          word1 = low1;
+          word3 = low0;
+          key0 = _mm512_add_epi32(key0, _mm512_set1_epi32((int) PHILOX_W0));
+          key1 = _mm512_add_epi32(key1, _mm512_set1_epi32((int) PHILOX_W1));
+        }
+        _mm512_storeu_si512((__m512i*) (words_in + laneIterator), word0);
+        _mm512_storeu_si512((__m512i*) (words_in + length_in + laneIterator), word1);
+        _mm512_storeu_si512((__m512i*) (words_in + 2 * length_in + laneIterator), word2);
+        _mm512_storeu_si512((__m512i*) (words_in + 3 * length_in + laneIterator), word3);
+      }
+      //The compiler leaves the upper halves dirty when the scalar rest is inlined, which slows every later SSE instruction
+      _mm256_zeroupper();
+      philoxRange(words_in, length_in, laneIterator, length_in, key0_in, key1_in);
+    }
+#pragma GCC diagnostic pop
+#endif
+
+    //Kernels start on the reference implementation until the processor has been checked
+    double (*dot)(const double*, const double*, unsigned) = dotScalar;
+    void (*axpy)(double, const double*, double*, unsigned) = axpyScalar;
+    float (*dotFloat)(const float*, const float*, unsigned) = dotFloatScalar;
+    void (*axpyFloat)(float, const float*, float*, unsigned) = axpyFloatScalar;
+    double (*dotMixed)(const float*, const double*, unsigned) = dotMixedScalar;
+    void (*axpyMixed)(double, const float*, double*, unsigned) = axpyMixedScalar;
+    double (*dotSparse)(const double*, const unsigned*, const double*, unsigned) = dotSparseScalar;
+    int32_t (*dotInt8)(const int8_t*, const int8_t*, unsigned) = dotInt8Scalar;
+    void (*philox)(uint32_t*, uint32_t, uint32_t, unsigned) = philoxScalar;
+
+    /* Identifier of the kernel currently in use */
+    static unsigned current = NEURAL_KERNEL_SCALAR;
+
+    //Finds the widest kernel supported by the processor
+    unsigned detect()
+    {
+#ifdef NEURAL_KERNEL_X86
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f")) {
+        return NEURAL_KERNEL_AVX512;
+      }
+      if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return NEURAL_KERNEL_AVX2;
+      }
+      if (__builtin_cpu_supports("sse2")) {
+        return NEURAL_KERNEL_SSE2;
+      }
+#endif
+      return NEURAL_KERNEL_SCALAR;
+    }
+
+    //Switches every kernel to the specified implementation
+    void select(unsigned kernel_in)
+    {
+      //Refuse kernels the processor can not run
+      if (kernel_in > detect()) {
+        throw std::runtime_error("Kernel not supported by this processor");
+      }
+      switch (kernel_in) {
+#ifdef NEURAL_KERNEL_X86
+      case NEURAL_KERNEL_SSE2:
+        dot = dotSSE2;
+        axpy = axpySSE2;
+        dotFloat = dotFloatSSE2;
+        axpyFloat = axpyFloatSSE2;
+        dotMixed = dotMixedSSE2;
+        axpyMixed = axpyMixedSSE2;
+        dotSparse = dotSparseSSE2;
+        dotInt8 = dotInt8SSE2;
+        philox = philoxSSE2;
+        break;
+      case NEURAL_KERNEL_AVX2:
+        dot = dotAVX2;
+        axpy = axpyAVX2;
+        dotFloat = dotFloatAVX2;
+        axpyFloat = axpyFloatAVX2;
+        dotMixed = dotMixedAVX2;
+        axpyMixed = axpyMixedAVX2;
+        dotSparse = dotSparseAVX2;
+        dotInt8 = dotInt8AVX2;
+        philox = philoxAVX2;
+        break;
+      case NEURAL_KERNEL_AVX512:
+        dot = dotAVX512;
+        axpy = axpyAVX512;
+        dotFloat = dotFloatAVX512;
+        axpyFloat = axpyFloatAVX512;
+        dotMixed = dotMixedAVX512;
+        axpyMixed = axpyMixedAVX512;
+        dotSparse = dotSparseAVX512;
+        philox = philoxAVX512;
+        //The integer kernel needs more than AVX-512F
+        if (__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vnni")) {
+          dotInt8 = dotInt8VNNI;
+        } else if (__builtin_cpu_supports("avx512bw")) {
+          dotInt8 = dotInt8AVX512;
+        } else {
+          dotInt8 = dotInt8AVX2;
+        }
+        break;
+#endif
+      default:
+        dot = dotScalar;
+        axpy = axpyScalar;
+        dotFloat = dotFloatScalar;
+        axpyFloat = axpyFloatScalar;
+        dotMixed = dotMixedScalar;
+        axpyMixed = axpyMixedScalar;
+        dotSparse = dotSparseScalar;
+        dotInt8 = dotInt8Scalar;
+        philox = philoxScalar;
+        break;
+      }
+      current = kernel_in;
+    }
+
+    //Returns the identifier of the kernel currently in use
+    unsigned selected()
+    {
+      return current;
+    }
+
+    //Returns a printable name for a kernel
+    const char* name(unsigned kernel_in)
+    {
+      switch (kernel_in) {
+      case NEURAL_KERNEL_SSE2:
+        return "sse2";
+      case NEURAL_KERNEL_AVX2:
+        return "avx2";
+      case NEURAL_KERNEL_AVX512:
+        return "avx512";
+      default:
+        return "scalar";
+      }
+    }
+
+    /* Picks the widest supported kernel when the program starts */
+    static struct Startup {
+      Startup() { select(detect()); }
+    } startup;
+  }
+}
@@ -0,0 +1,146 @@
+/***********************************************
+* Vectorized inner loops shared by the dense layers.
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified:
+*   October 17, 2026 - Created Initially
+*   October 17, 2026 - Added mixed precision kernels
+*   October 17, 2026 - Added sparse row gather kernel
+*   October 17, 2026 - Added 8 bit integer kernel
+*   October 17, 2026 - Added counter-based random number kernel
+*   October 17, 2026 - Declared the Philox reference for the kernel tests
+***********************************************/
+
+#ifndef _H_NEURAL_KERNELS
+#define _H_NEURAL_KERNELS
+
+#include <stdexcept>   //std::runtime_error
+#include <stdint.h>    //int8_t    int32_t    uint32_t
+
+//Plain loops, kept as the reference every other kernel is checked against
+#define NEURAL_KERNEL_SCALAR 0
+//128 bit vectors available on every x86-64 processor
+#define NEURAL_KERNEL_SSE2   1
+//256 bit vectors with fused multiply-add
+#define NEURAL_KERNEL_AVX2   2
+//512 bit vectors with fused multiply-add
+#define NEURAL_KERNEL_AVX512 3
+
+namespace neural
+{
+  namespace kernels
+  {
+    /****************
+    * Sums the products of two arrays using the selected kernel
+    *   PARAMETERS (in order)
+    *     const double* - first array
+    *     const double* - second array
+    *     unsigned      - length of both arrays
+    ****************/
+    extern double (*dot)(const double*, const double*, unsigned);
+
+    /****************
+    * Adds a multiple of one array into another using the selected kernel
+    *   PARAMETERS (in order)
+    *     double        - multiple of the source array to add
+    *     const double* - source array
+    *     double*       - array to accumulate into
+    *     unsigned      - length of both arrays
+    ****************/
+    extern void (*axpy)(double, const double*, double*, unsigned);
+
+    /* Single precision version of dot */
+    extern float (*dotFloat)(const float*, const float*, unsigned);
+
+    /* Single precision version of axpy */
+    extern void (*axpyFloat)(float, const float*, float*, unsigned);
+
+    /* Version of dot that widens single precision weights and accumulates in double precision */
+    extern double (*dotMixed)(const float*, const double*, unsigned);
+
+    /* Version of axpy that widens single precision weights into a double precision array */
+    extern void (*axpyMixed)(double, const float*, double*, unsigned);
+
+    /****************
+    * Sums the products of a sparse row's entries and the values they are indexed to using the selected kernel
+    *   PARAMETERS (in order)
+    *     const double*   - entries of the row
+    *     const unsigned* - index of each entry into the values
+    *     const double*   - values the entries are gathered against
+    *     unsigned        - number of entries in the row
+    ****************/
+    extern double (*dotSparse)(const double*, const unsigned*, const double*, unsigned);
+
+    /****************
+    * Sums the products of two arrays of 8 bit integers into a 32 bit integer using the selected kernel
+    *   The AVX-512 kernel uses VNNI when the processor has it
+    *   PARAMETERS (in order)
+    *     const int8_t* - first array
+    *     const int8_t* - second array
+    *     unsigned      - length of both arrays
+    ****************/
+    extern int32_t (*dotInt8)(const int8_t*, const int8_t*, unsigned);
+
+    /****************
+    * Runs the Philox 4x32-10 rounds on a group of counters using the selected kernel
+    *   The counters are stored as four rows, the first words of every counter then the second and so on,
+    *   and are overwritten with the random words
+    *   PARAMETERS (in order)
+    *     uint32_t* - rows of counter words
+    *     uint32_t  - low word of the key
+    *     uint32_t  - high word of the key
+    *     unsigned  - number of counters, the length of each row
+    ****************/
+    extern void (*philox)(uint32_t*, uint32_t, uint32_t, unsigned);
+
+    /****************
+    * Finds the widest kernel supported by the processor
+    * @return NEURAL_KERNEL_* identifier of the kernel
+    ****************/
+    unsigned detect();
+
+    /****************
+    * Switches every kernel to the specified implementation
+    * @param kernel_in NEURAL_KERNEL_* identifier of the kernel
+    ****************/
+    void select(unsigned kernel_in);
+
+    /****************
+    * Returns the identifier of the kernel currently in use
+    ****************/
+    unsigned selected();
+
+    /****************
+    * Returns a printable name for a kernel
+    * @param kernel_in NEURAL_KERNEL_* identifier of the kernel
+    ****************/
+    const char* name(unsigned kernel_in);
+
+    /****************
+    * Picks the kernel for a row of weights summed against a row of values
+    *   double weights     - dot and axpy
+    *   float weights      - dotMixed and axpyMixed, summed in double precision
+    *   float both         - dotFloat, summed in single precision
+    ****************/
+    inline double rowDot(const double* weights_in, const double* values_in, unsigned length_in) { return dot(weights_in, values_in, length_in); }
+    inline double rowDot(const float* weights_in, const double* values_in, unsigned length_in) { return dotMixed(weights_in, values_in, length_in); }
+    inline double rowDot(const float* weights_in, const float* values_in, unsigned length_in) { return dotFloat(weights_in, values_in, length_in); }
+    inline void rowAxpy(double scale_in, const double* weights_in, double* values_in, unsigned length_in) { axpy(scale_in, weights_in, values_in, length_in); }
+    inline void rowAxpy(double scale_in, const float* weights_in, double* values_in, unsigned length_in) { axpyMixed(scale_in, weights_in, values_in, length_in); }
+
+    //Reference implementations
+    double dotScalar(const double* a_in, const double* b_in, unsigned length_in);
+    void axpyScalar(double scale_in, const double* x_in, double* y_in, unsigned length_in);
+    float dotFloatScalar(const float* a_in, const float* b_in, unsigned length_in);
+    void axpyFloatScalar(float scale_in, const float* x_in, float* y_in, unsigned length_in);
+    double dotMixedScalar(const float* a_in, const double* b_in, unsigned length_in);
+    void axpyMixedScalar(double scale_in, const float* x_in, double* y_in, unsigned length_in);
+    double dotSparseScalar(const double* a_in, const unsigned* index_in, const double* b_in, unsigned length_in);
+    int32_t dotInt8Scalar(const int8_t* a_in, const int8_t* b_in, unsigned length_in);
+    void philoxScalar(uint32_t* words_in, uint32_t key0_in, uint32_t key1_in, unsigned length_in);
+  }
+}
+
+#endif
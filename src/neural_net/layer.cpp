@@ -7,6 +7,16 @@ namespace neural
   Layer::Layer(unsigned bias_in)
   {
     bias = bias_in;
+    dense = 0;
+    sparse = 0;
+    softmax = 0;
+    inputs = 0;
+    mappedWeights = NULL;
+    mappedDeltaWeights = NULL;
+    mappedSingleWeights = NULL;
+    mappedSingleDeltaWeights = NULL;
+    precision = NEURAL_PRECISION_DOUBLE;
+    batchSize = 0;
     //Create list of neurons
     neurons = std::vector<Neuron>();
   }
@@ -17,6 +27,16 @@ namespace neural
     unsigned neuronIterator;
 
     bias = bias_in;
+    dense = 0;
+    sparse = 0;
+    softmax = 0;
+    inputs = 0;
+    mappedWeights = NULL;
+    mappedDeltaWeights = NULL;
+    mappedSingleWeights = NULL;
+    mappedSingleDeltaWeights = NULL;
+    precision = NEURAL_PRECISION_DOUBLE;
+    batchSize = 0;
     //Create the list of neurons
     neurons = std::vector<Neuron>();
     //Add the new neurons to the layer
@@ -38,7 +58,467 @@ namespace neural
   //Create and add a new neuron with the specified inputs to the layer
   void Layer::addNeuron(std::vector<Neuron>* inputs_in, unsigned bias_in)
   {
-    neurons.push_back(Neuron(inputs_in, bias_in));
+    unsigned inputIterator;
+
+    //Connections point at the neurons, so a connected layer can not be allowed to move them
+    if (neurons.size() == neurons.capacity() && ! connections.empty()) {
+      throw std::runtime_error("Graph layers must be sized with reserveGraph before their neurons are connected");
+    }
+    neurons.push_back(Neuron(bias_in));
+    neurons.back().reserve(inputs_in->size(), 0);
+    //Place the neuron's inputs next to each other in the arena
+    for (inputIterator = 0; inputIterator < inputs_in->size(); ++inputIterator) {
+      connect(&(*inputs_in)[inputIterator], &neurons.back(), std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN());
+    }
+  }
+
+  //Sizes a graph layer's neurons and connection arena up front
+  void Layer::reserveGraph(unsigned neurons_in, unsigned inputs_in)
+  {
+    neurons.reserve(neurons_in);
+    connections.reserve((size_t) (neurons_in - bias) * inputs_in);
+  }
+
+  //Sizes the output list of every neuron in a graph layer up front
+  void Layer::reserveOutputs(unsigned outputs_in)
+  {
+    unsigned neuronIterator;
+
+    for (neuronIterator = 0; neuronIterator < neurons.size(); ++neuronIterator) {
+      neurons[neuronIterator].reserve(0, outputs_in);
+    }
+  }
+
+  //Sets how the layer draws weights for its connections
+  void Layer::setInitializer(const Initializer& initializer_in)
+  {
+    initializer = initializer_in;
+  }
+
+  //Redraws every weight in the layer from its initializer and clears the delta weights
+  void Layer::initializeWeights(ThreadPool* pool_in)
+  {
+    //Graph connections are drawn by their slot in the arena
+    if (! dense) {
+      split(pool_in, connections.size(), [&](unsigned first_in, unsigned last_in) {
+        unsigned connectionIterator;
+
+        for (connectionIterator = first_in; connectionIterator < last_in; ++connectionIterator) {
+          connections[connectionIterator].setWeight(initializer.weight(connectionIterator));
+          connections[connectionIterator].setDeltaWeight(0.0);
+        }
+      });
+      return;
+    }
+    //Sparse entries are drawn where they would sit in a dense matrix, and copied into the transpose
+    if (sparse) {
+      compressSparse();
+      split(pool_in, neurons.size() - bias, [&](unsigned first_in, unsigned last_in) {
+        unsigned neuronIterator;
+        unsigned entryIterator;
+
+        for (neuronIterator = first_in; neuronIterator < last_in; ++neuronIterator) {
+          for (entryIterator = rowStarts[neuronIterator]; entryIterator < rowStarts[neuronIterator + 1]; ++entryIterator) {
+            weights[entryIterator] = initializer.weight((size_t) neuronIterator * inputs + columns[entryIterator]);
+            deltaWeights[entryIterator] = 0.0;
+            transposeWeights[transposeSlots[entryIterator]] = weights[entryIterator];
+          }
+        }
+      });
+      return;
+    }
+    //Dense rows are runs of consecutive positions
+    split(pool_in, neurons.size() - bias, [&](unsigned first_in, unsigned last_in) {
+      size_t first;
+      size_t count;
+
+      first = (size_t) first_in * inputs;
+      count = (size_t) (last_in - first_in) * inputs;
+      if (precision == NEURAL_PRECISION_DOUBLE) {
+        initializer.fill(weightData() + first, first, count);
+        std::fill(deltaWeightData() + first, deltaWeightData() + first + count, 0.0);
+      } else {
+        initializer.fill(singleWeightData() + first, first, count);
+        std::fill(singleDeltaWeightData() + first, singleDeltaWeightData() + first + count, 0.0f);
+      }
+    });
+  }
+
+  //Allocates a connection into a neuron of this graph layer from the layer's arena
+  Connection* Layer::connect(Neuron* source_in, Neuron* destination_in, double weight_in, double deltaWeight_in)
+  {
+    unsigned neuronIterator;
+    size_t connectionIterator;
+    std::vector<Connection> grown;
+    std::vector<Neuron*> sources;
+
+    //Copy a full arena into one twice the size and point the inputs and outputs at the copy before the old one is freed
+    if (connections.size() == connections.capacity()) {
+      grown.reserve(connections.empty() ? NEURAL_ARENA_MINIMUM : 2 * connections.size());
+      grown.insert(grown.end(), connections.begin(), connections.end());
+      for (neuronIterator = 0; neuronIterator < neurons.size(); ++neuronIterator) {
+        neurons[neuronIterator].rebase(connections.data(), connections.size(), grown.data());
+      }
+      //The sending neurons live in other layers, each is moved once
+      for (connectionIterator = 0; connectionIterator < connections.size(); ++connectionIterator) {
+        sources.push_back(connections[connectionIterator].getStart());
+      }
+      std::sort(sources.begin(), sources.end());
+      sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+      for (neuronIterator = 0; neuronIterator < sources.size(); ++neuronIterator) {
+        sources[neuronIterator]->rebase(connections.data(), connections.size(), grown.data());
+      }
+      connections.swap(grown);
+    }
+
+    //Place the connection at the end of the arena and hand it to the neuron, a missing weight is drawn for its slot
+    connections.push_back(Connection(source_in, destination_in, std::isnan(weight_in) ? initializer.weight(connections.size()) : weight_in));
+    connections.back().setDeltaWeight(std::isnan(deltaWeight_in) ? 0.0 : deltaWeight_in);
+    destination_in->addInput(&connections.back());
+    return &connections.back();
+  }
+
+  //Switches the layer to dense storage with a weight matrix of the specified width
+  void Layer::makeDense(unsigned inputs_in, unsigned precision_in, ThreadPool* pool_in)
+  {
+    size_t count;
+    unsigned neuronIterator;
+
+    dense = 1;
+    sparse = 0;
+    inputs = inputs_in;
+    precision = precision_in;
+    mappedWeights = NULL;
+    mappedDeltaWeights = NULL;
+    mappedSingleWeights = NULL;
+    mappedSingleDeltaWeights = NULL;
+    //One row of weights for every neuron that is not a bias neuron
+    count = (size_t) (neurons.size() - bias) * inputs;
+    //Only the matrices of the requested precision are kept
+    if (precision == NEURAL_PRECISION_DOUBLE) {
+      weights.resize(count);
+      deltaWeights.assign(count, 0.0);
+      std::vector<float>().swap(singleWeights);
+      std::vector<float>().swap(singleDeltaWeights);
+    } else {
+      singleWeights.resize(count);
+      singleDeltaWeights.assign(count, 0.0f);
+      std::vector<double>().swap(weights);
+      std::vector<double>().swap(deltaWeights);
+    }
+    //Generate a weight for every connection, a block of rows on each thread
+    initializeWeights(pool_in);
+    //Copy the current neuron values into the dense arrays
+    outputs.resize(neurons.size());
+    gradients.resize(neurons.size());
+    for (neuronIterator = 0; neuronIterator < neurons.size(); ++neuronIterator) {
+      outputs[neuronIterator] = neurons[neuronIterator].getOutput();
+      gradients[neuronIterator] = neurons[neuronIterator].getGradient();
+    }
+  }
+
+  //Switches the layer to dense storage using externally owned weights
+  void Layer::makeDense(unsigned inputs_in, double* weights_in, double* deltaWeights_in)
+  {
+    unsigned neuronIterator;
+
+    dense = 1;
+    sparse = 0;
+    inputs = inputs_in;
+    precision = NEURAL_PRECISION_DOUBLE;
+    mappedWeights = weights_in;
+    mappedDeltaWeights = deltaWeights_in;
+    mappedSingleWeights = NULL;
+    mappedSingleDeltaWeights = NULL;
+    //The layer keeps no weights of its own
+    std::vector<double>().swap(weights);
+    std::vector<double>().swap(deltaWeights);
+    std::vector<float>().swap(singleWeights);
+    std::vector<float>().swap(singleDeltaWeights);
+    //Copy the current neuron values into the dense arrays
+    outputs.resize(neurons.size());
+    gradients.resize(neurons.size());
+    for (neuronIterator = 0; neuronIterator < neurons.size(); ++neuronIterator) {
+      outputs[neuronIterator] = neurons[neuronIterator].getOutput();
+      gradients[neuronIterator] = neurons[neuronIterator].getGradient();
+    }
+  }
+
+  //Switches the layer to dense storage using externally owned single precision weights
+  void Layer::makeDense(unsigned inputs_in, float* weights_in, float* deltaWeights_in, unsigned precision_in)
+  {
+    unsigned neuronIterator;
+
+    if (precision_in == NEURAL_PRECISION_DOUBLE) {
+      throw std::runtime_error("Single precision weights need a single or mixed precision layer");
+    }
+    dense = 1;
+    sparse = 0;
+    inputs = inputs_in;
+    precision = precision_in;
+    mappedWeights = NULL;
+    mappedDeltaWeights = NULL;
+    mappedSingleWeights = weights_in;
+    mappedSingleDeltaWeights = deltaWeights_in;
+    //The layer keeps no weights of its own
+    std::vector<double>().swap(weights);
+    std::vector<double>().swap(deltaWeights);
+    std::vector<float>().swap(singleWeights);
+    std::vector<float>().swap(singleDeltaWeights);
+    //Copy the current neuron values into the dense arrays
+    outputs.resize(neurons.size());
+    gradients.resize(neurons.size());
+    for (neuronIterator = 0; neuronIterator < neurons.size(); ++neuronIterator) {
+      outputs[neuronIterator] = neurons[neuronIterator].getOutput();
+      gradients[neuronIterator] = neurons[neuronIterator].getGradient();
+    }
+  }
+
+  //Switches the layer to sparse storage with no connections
+  void Layer::makeSparse(unsigned inputs_in)
+  {
+    unsigned neuronIterator;
+
+    dense = 1;
+    sparse = 1;
+    inputs = inputs_in;
+    precision = NEURAL_PRECISION_DOUBLE;
+    mappedWeights = NULL;
+    mappedDeltaWeights = NULL;
+    mappedSingleWeights = NULL;
+    mappedSingleDeltaWeights = NULL;
+    //Every row starts out empty
+    rowStarts.assign(neurons.size() - bias + 1, 0);
+    columnStarts.assign(inputs + 1, 0);
+    columns.clear();
+    weights.clear();
+    deltaWeights.clear();
+    transposeRows.clear();
+    transposeWeights.clear();
+    transposeSlots.clear();
+    pendingConnections.clear();
+    std::vector<float>().swap(singleWeights);
+    std::vector<float>().swap(singleDeltaWeights);
+    //Copy the current neuron values into the dense arrays
+    outputs.resize(neurons.size());
+    gradients.resize(neurons.size());
+    for (neuronIterator = 0; neuronIterator < neurons.size(); ++neuronIterator) {
+      outputs[neuronIterator] = neurons[neuronIterator].getOutput();
+      gradients[neuronIterator] = neurons[neuronIterator].getGradient();
+    }
+  }
+
+  //Adds a connection to the sparse matrix, replacing it if it already exists
+  void Layer::addConnection(unsigned neuron_in, unsigned input_in, double weight_in, double deltaWeight_in)
+  {
+    connection_data connection;
+
+    if (! sparse) {
+      throw std::runtime_error("Connections can only be added to sparse storage");
+    }
+    if (neuron_in >= neurons.size() - bias) {
+      throw std::runtime_error("Bias neurons can not have inputs");
+    }
+    if (input_in >= inputs) {
+      throw std::runtime_error("Connection input is outside the previous layer");
+    }
+    //Hold the connection aside so a whole file of connections is sorted once
+    connection.destination.neuron = neuron_in;
+    connection.source.neuron = input_in;
+    connection.weight = weight_in;
+    connection.deltaWeight = deltaWeight_in;
+    pendingConnections.push_back(connection);
+  }
+
+  //Folds every pending connection into the sparse matrix and rebuilds its transpose
+  void Layer::compressSparse()
+  {
+    std::vector<connection_data> entries;
+    std::vector<unsigned> filled;
+    connection_data entry;
+    unsigned neuronIterator;
+    unsigned inputIterator;
+    size_t entryIterator;
+    size_t mergedIterator;
+
+    //Existing entries go first so pending connections override them once sorted
+    entries.reserve(columns.size() + pendingConnections.size());
+    for (neuronIterator = 0; neuronIterator < rowStarts.size() - 1; ++neuronIterator) {
+      for (entryIterator = rowStarts[neuronIterator]; entryIterator < rowStarts[neuronIterator + 1]; ++entryIterator) {
+        entry.destination.neuron = neuronIterator;
+        entry.source.neuron = columns[entryIterator];
+        entry.weight = weights[entryIterator];
+        entry.deltaWeight = deltaWeights[entryIterator];
+        entries.push_back(entry);
+      }
+    }
+    entries.insert(entries.end(), pendingConnections.begin(), pendingConnections.end());
+    std::vector<connection_data>().swap(pendingConnections);
+    std::stable_sort(entries.begin(), entries.end(), [](const connection_data &a_in, const connection_data &b_in) {
+      return a_in.destination.neuron != b_in.destination.neuron ? a_in.destination.neuron < b_in.destination.neuron : a_in.source.neuron < b_in.source.neuron;
+    });
+
+    //Merge repeats of a connection, later values win unless they are missing
+    mergedIterator = 0;
+    for (entryIterator = 0; entryIterator < entries.size(); ++entryIterator) {
+      if (mergedIterator > 0 && entries[mergedIterator - 1].destination.neuron == entries[entryIterator].destination.neuron && entries[mergedIterator - 1].source.neuron == entries[entryIterator].source.neuron) {
+        if (! std::isnan(entries[entryIterator].weight)) {
+          entries[mergedIterator - 1].weight = entries[entryIterator].weight;
+        }
+        if (! std::isnan(entries[entryIterator].deltaWeight)) {
+          entries[mergedIterator - 1].deltaWeight = entries[entryIterator].deltaWeight;
+        }
+        continue;
+      }
+      entries[mergedIterator++] = entries[entryIterator];
+    }
+    entries.resize(mergedIterator);
+
+    //Lay the entries out as compressed rows, new connections without values start like a dense weight
+    rowStarts.assign(neurons.size() - bias + 1, 0);
+    columns.resize(entries.size());
+    weights.resize(entries.size());
+    deltaWeights.resize(entries.size());
+    for (entryIterator = 0; entryIterator < entries.size(); ++entryIterator) {
+      ++rowStarts[entries[entryIterator].destination.neuron + 1];
+      columns[entryIterator] = entries[entryIterator].source.neuron;
+      weights[entryIterator] = std::isnan(entries[entryIterator].weight) ? initializer.weight((size_t) entries[entryIterator].destination.neuron * inputs + entries[entryIterator].source.neuron) : entries[entryIterator].weight;
+      deltaWeights[entryIterator] = std::isnan(entries[entryIterator].deltaWeight) ? 0.0 : entries[entryIterator].deltaWeight;
+    }
+    for (neuronIterator = 0; neuronIterator < rowStarts.size() - 1; ++neuronIterator) {
+      rowStarts[neuronIterator + 1] += rowStarts[neuronIterator];
+    }
+
+    //Count the entries of each column then place every entry in its column in row order
+    columnStarts.assign(inputs + 1, 0);
+    for (entryIterator = 0; entryIterator < columns.size(); ++entryIterator) {
+      ++columnStarts[columns[entryIterator] + 1];
+    }
+    for (inputIterator = 0; inputIterator < inputs; ++inputIterator) {
+      columnStarts[inputIterator + 1] += columnStarts[inputIterator];
+    }
+    transposeRows.resize(columns.size());
+    transposeWeights.resize(columns.size());
+    transposeSlots.resize(columns.size());
+    filled.assign(columnStarts.begin(), columnStarts.end() - 1);
+    for (neuronIterator = 0; neuronIterator < rowStarts.size() - 1; ++neuronIterator) {
+      for (entryIterator = rowStarts[neuronIterator]; entryIterator < rowStarts[neuronIterator + 1]; ++entryIterator) {
+        transposeSlots[entryIterator] = filled[columns[entryIterator]]++;
+        transposeRows[transposeSlots[entryIterator]] = neuronIterator;
+        transposeWeights[transposeSlots[entryIterator]] = weights[entryIterator];
+      }
+    }
+  }
+
+  //Removes every connection whose weight is smaller in magnitude than a threshold
+  void Layer::prune(double threshold_in)
+  {
+    std::vector<connection_data> kept;
+    connection_data entry;
+    unsigned neuronIterator;
+    unsigned inputIterator;
+    size_t entryIterator;
+
+    if (! dense) {
+      throw std::runtime_error("Pruning requires dense or sparse storage");
+    }
+    if (! pendingConnections.empty()) {
+      compressSparse();
+    }
+
+    //Collect the connections that survive as sparse entries
+    for (neuronIterator = 0; neuronIterator < neurons.size() - bias; ++neuronIterator) {
+      entry.destination.neuron = neuronIterator;
+      if (sparse) {
+        for (entryIterator = rowStarts[neuronIterator]; entryIterator < rowStarts[neuronIterator + 1]; ++entryIterator) {
+          if (fabs(weights[entryIterator]) >= threshold_in) {
+            entry.source.neuron = columns[entryIterator];
+            entry.weight = weights[entryIterator];
+            entry.deltaWeight = deltaWeights[entryIterator];
+            kept.push_back(entry);
+          }
+        }
+        continue;
+      }
+      for (inputIterator = 0; inputIterator < inputs; ++inputIterator) {
+        entry.weight = getWeight(neuronIterator, inputIterator);
+        if (fabs(entry.weight) >= threshold_in) {
+          entry.source.neuron = inputIterator;
+          entry.deltaWeight = getDeltaWeight(neuronIterator, inputIterator);
+          kept.push_back(entry);
+        }
+      }
+    }
+
+    //Drop the old matrix, the layer no longer reads externally owned weights
+    sparse = 1;
+    precision = NEURAL_PRECISION_DOUBLE;
+    mappedWeights = NULL;
+    mappedDeltaWeights = NULL;
+    mappedSingleWeights = NULL;
+    mappedSingleDeltaWeights = NULL;
+    std::vector<float>().swap(singleWeights);
+    std::vector<float>().swap(singleDeltaWeights);
+    rowStarts.assign(neurons.size() - bias + 1, 0);
+    columns.clear();
+    weights.clear();
+    deltaWeights.clear();
+
+    //Lay the surviving connections out as a fresh sparse matrix
+    pendingConnections.swap(kept);
+    compressSparse();
+    std::vector<double>(weights).swap(weights);
+    std::vector<double>(deltaWeights).swap(deltaWeights);
+    std::vector<unsigned>(columns).swap(columns);
+  }
+
+  //Appends the absolute weight of every connection into the layer
+  void Layer::getMagnitudes(std::vector<double>* location_in)
+  {
+    unsigned neuronIterator;
+    unsigned inputIterator;
+    size_t entryIterator;
+
+    if (sparse) {
+      if (! pendingConnections.empty()) {
+        compressSparse();
+      }
+      for (entryIterator = 0; entryIterator < columns.size(); ++entryIterator) {
+        location_in->push_back(fabs(weights[entryIterator]));
+      }
+      return;
+    }
+    for (neuronIterator = 0; neuronIterator < neurons.size() - bias; ++neuronIterator) {
+      for (inputIterator = 0; inputIterator < inputs; ++inputIterator) {
+        location_in->push_back(fabs(getWeight(neuronIterator, inputIterator)));
+      }
+    }
+  }
+
+  //Finds the sparse entry of a connection
+  size_t Layer::findSparse(unsigned neuron_in, unsigned input_in) const
+  {
+    const unsigned* found;
+
+    //Columns are sorted within each row
+    found = std::lower_bound(columns.data() + rowStarts[neuron_in], columns.data() + rowStarts[neuron_in + 1], input_in);
+    if (found == columns.data() + rowStarts[neuron_in + 1] || *found != input_in) {
+      return columns.size();
+    }
+    return found - columns.data();
+  }
+
+  //Finds the most recent pending connection between two neurons
+  const connection_data* Layer::findPending(unsigned neuron_in, unsigned input_in) const
+  {
+    size_t pendingIterator;
+
+    for (pendingIterator = pendingConnections.size(); pendingIterator > 0; --pendingIterator) {
+      if (pendingConnections[pendingIterator - 1].destination.neuron == neuron_in && pendingConnections[pendingIterator - 1].source.neuron == input_in) {
+        return &pendingConnections[pendingIterator - 1];
+      }
+    }
+    return NULL;
   }
 
   //Sets the values of the first neurons to the specified values
@@ -46,6 +526,13 @@ namespace neural
   {
     unsigned inputIterator;
 
+    //Dense storage keeps the values in the output array
+    if (dense) {
+      for (inputIterator = 0; inputIterator < (unsigned) values_in.size(); ++inputIterator) {
+        outputs[inputIterator] = values_in[inputIterator];
+      }
+      return;
+    }
     //Hit each neuron in the layer
     for (inputIterator = 0; inputIterator < (unsigned) values_in.size(); ++inputIterator) {
       neurons[inputIterator].setOutput(values_in[inputIterator]);
@@ -63,6 +550,23 @@ namespace neural
     }
   }
 
+  //Sets all the neurons to forward their values, reading dense inputs from the previous layer
+  void Layer::feedForward(Layer* previous_in, double (*activationFunction)(double), ThreadPool* pool_in)
+  {
+    //Connection storage reaches the previous layer through the neurons
+    if (! dense) {
+      split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+        unsigned neuronIterator;
+
+        for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+          neurons[neuronIterator].feedForward(activationFunction);
+        }
+      });
+      return;
+    }
+    feedForward(previous_in, activation::Pointer(activationFunction, NULL), pool_in);
+  }
+
   //Calculates the error for the network using root mean square storing it in the error member
   double Layer::calculateError(const std::vector<double> &values_in)
   {
@@ -70,15 +574,37 @@ namespace neural
     double delta;
     double error;
 
+    error = 0.0;
     //Hit each neuron in the output layer
     for (neuronIterator = 0; neuronIterator < neurons.size() - bias; ++neuronIterator) {
       //Caucluate the difference for the current Neuron
-      delta = values_in[neuronIterator] - neurons[neuronIterator].getOutput();
+      delta = values_in[neuronIterator] - (dense ? outputs[neuronIterator] : neurons[neuronIterator].getOutput());
       //Add the error of this Neuron to the error
       error += delta * delta;
     }
     //Calculate root mean square
-    return sqrt(error / (neurons.size() - 1));
+    return sqrt(error / (neurons.size() - bias));
+  }
+
+  //Calculates the cross-entropy of a softmax layer and its gradients with respect to the sums in one pass
+  double Layer::calculateSoftmaxGradients(const std::vector<double> &values_in)
+  {
+    unsigned neuronIterator;
+    double error;
+
+    if (! softmax) {
+      throw std::runtime_error("Cross-entropy requires a softmax layer");
+    }
+    error = 0.0;
+    for (neuronIterator = 0; neuronIterator < neurons.size() - bias; ++neuronIterator) {
+      //The softmax derivative cancels against the cross-entropy's, leaving the difference from the target
+      gradients[neuronIterator] = values_in[neuronIterator] - outputs[neuronIterator];
+      //Only expected classes add to the loss, an output that underflowed to 0 is charged the smallest double instead of infinity
+      if (values_in[neuronIterator] != 0.0) {
+        error -= values_in[neuronIterator] * log(std::max(outputs[neuronIterator], std::numeric_limits<double>::min()));
+      }
+    }
+    return error;
   }
 
   //Calculates the gradients for the layer's neurons
@@ -86,6 +612,11 @@ namespace neural
   {
     unsigned neuronIterator;
 
+    //Dense storage keeps the gradients next to the outputs
+    if (dense) {
+      calculateOutputGradients(values_in, activation::Pointer(NULL, activationFunctionDerivative));
+      return;
+    }
     //Hit each neuron in the output layer
     for (neuronIterator = 0; neuronIterator < neurons.size() - bias; ++neuronIterator) {
       //Calculate the gradients for that neuron
@@ -105,6 +636,23 @@ namespace neural
     }
   }
 
+  //Calculates the gradients for the layer, reading dense gradients from the next layer
+  void Layer::calculateHiddenGradients(Layer* next_in, double (*activationFunctionDerivative)(double), ThreadPool* pool_in)
+  {
+    //Connection storage reaches the next layer through the neurons
+    if (! dense) {
+      split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+        unsigned neuronIterator;
+
+        for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+          neurons[neuronIterator].calculateHiddenGradients(activationFunctionDerivative);
+        }
+      });
+      return;
+    }
+    calculateHiddenGradients(next_in, activation::Pointer(NULL, activationFunctionDerivative), pool_in);
+  }
+
   //Updates the weights of each neuron in the layer
   void Layer::updateInputWeights(double (*deltaInputWeight)(double, double, double, double))
   {
@@ -117,6 +665,203 @@ namespace neural
     }
   }
 
+  //Updates the weights of each neuron in the layer, reading dense inputs from the previous layer
+  void Layer::updateInputWeights(Layer* previous_in, double (*deltaInputWeight)(double, double, double, double), ThreadPool* pool_in)
+  {
+    //Connection storage reaches the previous layer through the neurons
+    if (! dense) {
+      split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+        unsigned neuronIterator;
+
+        for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+          neurons[neuronIterator].updateInputWeights(deltaInputWeight);
+        }
+      });
+      return;
+    }
+    updateInputWeights(previous_in, optimizer::Pointer(deltaInputWeight), pool_in);
+  }
+
+  //Splits a range of neurons or samples between the threads of a pool
+  void Layer::split(ThreadPool* pool_in, unsigned items_in, const std::function<void(unsigned, unsigned)> &task_in)
+  {
+    //Without a pool the calling thread does all the work
+    if (pool_in == NULL) {
+      if (items_in > 0) {
+        task_in(0, items_in);
+      }
+      return;
+    }
+    pool_in->run(items_in, task_in);
+  }
+
+  //Sizes the batch arrays and points each batch row at this layer's outputs
+  void Layer::resizeBatch(unsigned samples_in)
+  {
+    unsigned sampleIterator;
+    unsigned width;
+
+    width = neurons.size() - bias;
+    batchSize = samples_in;
+    batchOutputs.resize(samples_in * width);
+    batchGradients.resize(samples_in * width);
+    batchRows.resize(samples_in);
+    for (sampleIterator = 0; sampleIterator < samples_in; ++sampleIterator) {
+      batchRows[sampleIterator] = batchOutputs.data() + sampleIterator * width;
+    }
+  }
+
+  //Points the batch rows of the layer at externally owned values without copying them
+  void Layer::setBatchValues(const double* const* values_in, unsigned samples_in)
+  {
+    batchSize = samples_in;
+    batchRows.assign(values_in, values_in + samples_in);
+  }
+
+  //Forwards every sample of the previous layer's batch through this layer
+  void Layer::feedForwardBatch(Layer* previous_in, double (*activationFunction)(double), ThreadPool* pool_in)
+  {
+    feedForwardBatch(previous_in, activation::Pointer(activationFunction, NULL), pool_in);
+  }
+
+  //Calculates the root mean square error over every sample in the batch
+  double Layer::calculateBatchError(const double* const* values_in)
+  {
+    unsigned sampleIterator;
+    unsigned neuronIterator;
+    double delta;
+    double error;
+
+    //An empty batch has no error
+    if (batchSize == 0) {
+      return 0.0;
+    }
+    error = 0.0;
+    //Hit each neuron of each sample
+    for (sampleIterator = 0; sampleIterator < batchSize; ++sampleIterator) {
+      for (neuronIterator = 0; neuronIterator < neurons.size() - bias; ++neuronIterator) {
+        delta = values_in[sampleIterator][neuronIterator] - batchRows[sampleIterator][neuronIterator];
+        error += delta * delta;
+      }
+    }
+    //Calculate root mean square
+    return sqrt(error / (batchSize * (neurons.size() - bias)));
+  }
+
+  //Calculates the cross-entropy of a softmax layer and its gradients for every sample in the batch
+  double Layer::calculateSoftmaxGradientsBatch(const double* const* values_in)
+  {
+    unsigned sampleIterator;
+    unsigned neuronIterator;
+    unsigned width;
+    const double* values;
+    double* gradient;
+    double error;
+
+    if (! softmax) {
+      throw std::runtime_error("Cross-entropy requires a softmax layer");
+    }
+    //An empty batch has no error
+    if (batchSize == 0) {
+      return 0.0;
+    }
+    width = neurons.size() - bias;
+    error = 0.0;
+    //Hit each neuron of each sample
+    for (sampleIterator = 0; sampleIterator < batchSize; ++sampleIterator) {
+      values = batchRows[sampleIterator];
+      gradient = &batchGradients[(size_t) sampleIterator * width];
+      for (neuronIterator = 0; neuronIterator < width; ++neuronIterator) {
+        gradient[neuronIterator] = values_in[sampleIterator][neuronIterator] - values[neuronIterator];
+        if (values_in[sampleIterator][neuronIterator] != 0.0) {
+          error -= values_in[sampleIterator][neuronIterator] * log(std::max(values[neuronIterator], std::numeric_limits<double>::min()));
+        }
+      }
+    }
+    return error / batchSize;
+  }
+
+  //Calculates the output gradients for every sample in the batch
+  void Layer::calculateOutputGradientsBatch(const double* const* values_in, double (*activationFunctionDerivative)(double))
+  {
+    calculateOutputGradientsBatch(values_in, activation::Pointer(NULL, activationFunctionDerivative));
+  }
+
+  //Calculates the gradients for every sample in the batch from the next layer's gradients
+  void Layer::calculateHiddenGradientsBatch(Layer* next_in, double (*activationFunctionDerivative)(double), ThreadPool* pool_in)
+  {
+    calculateHiddenGradientsBatch(next_in, activation::Pointer(NULL, activationFunctionDerivative), pool_in);
+  }
+
+  //Accumulates the weight gradients over the batch and applies a single update to each weight
+  void Layer::updateInputWeightsBatch(Layer* previous_in, double (*deltaInputWeight)(double, double, double, double), ThreadPool* pool_in)
+  {
+    updateInputWeightsBatch(previous_in, optimizer::Pointer(deltaInputWeight), pool_in);
+  }
+
+  //Sums gradient * input over the batch for every weight without changing any weight
+  void Layer::sumWeightGradients(Layer* previous_in, double* sums_out, ThreadPool* pool_in)
+  {
+    if (! dense || sparse) {
+      throw std::runtime_error("Batched evaluation requires dense storage");
+    }
+    //Rows of weights are independent so each thread takes a block of them
+    split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+      sumWeightGradientRows(previous_in, begin_in, end_in, sums_out);
+    });
+  }
+
+  //Sums gradient * input over the batch for a block of weight rows
+  void Layer::sumWeightGradientRows(Layer* previous_in, unsigned begin_in, unsigned end_in, double* sums_out)
+  {
+    unsigned tileIterator;
+    unsigned tileEnd;
+    unsigned sampleIterator;
+    unsigned neuronIterator;
+    unsigned inputIterator;
+    unsigned width;
+    double* sum;
+    double gradient;
+
+    //Bias inputs are not part of the batch rows
+    width = previous_in->neurons.size() - previous_in->bias;
+    std::fill(sums_out + (size_t) begin_in * inputs, sums_out + (size_t) end_in * inputs, 0.0);
+    //Accumulate gradient * input for a tile of samples so each gradient row is reused while cached
+    for (tileIterator = 0; tileIterator < batchSize; tileIterator += NEURAL_BATCH_TILE) {
+      tileEnd = tileIterator + NEURAL_BATCH_TILE < batchSize ? tileIterator + NEURAL_BATCH_TILE : batchSize;
+      for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+        sum = sums_out + (size_t) neuronIterator * inputs;
+        for (sampleIterator = tileIterator; sampleIterator < tileEnd; ++sampleIterator) {
+          gradient = batchGradients[(size_t) sampleIterator * (neurons.size() - bias) + neuronIterator];
+          kernels::axpy(gradient, previous_in->batchRows[sampleIterator], sum, width);
+          //Bias inputs are the same for every sample
+          for (inputIterator = width; inputIterator < inputs; ++inputIterator) {
+            sum[inputIterator] += gradient * previous_in->outputs[inputIterator];
+          }
+        }
+      }
+    }
+  }
+
+  //Applies one update to each weight from gradients summed over a batch
+  void Layer::applyWeightGradients(const double* sums_in, unsigned samples_in, double (*deltaInputWeight)(double, double, double, double), ThreadPool* pool_in)
+  {
+    applyWeightGradients(sums_in, samples_in, optimizer::Pointer(deltaInputWeight), pool_in);
+  }
+
+  //Returns the result values of every sample in the batch
+  void Layer::getBatchResults(std::vector<double>* location_in)
+  {
+    unsigned sampleIterator;
+    unsigned width;
+
+    width = neurons.size() - bias;
+    location_in->resize(batchSize * width);
+    for (sampleIterator = 0; sampleIterator < batchSize; ++sampleIterator) {
+      std::copy(batchRows[sampleIterator], batchRows[sampleIterator] + width, location_in->begin() + sampleIterator * width);
+    }
+  }
+
   //Returns the result values of the layer
   void Layer::getResults(std::vector<double>* location_in)
   {
@@ -130,7 +875,7 @@ namespace neural
         continue;
       }
       //Append the neurons value to the results
-      location_in->push_back(neurons[resultIterator].getOutput());
+      location_in->push_back(dense ? outputs[resultIterator] : neurons[resultIterator].getOutput());
     }
   }
 
@@ -139,6 +884,48 @@ namespace neural
   {
     //Set value of specified neuron
     neurons[neuron_in.neuron.neuron].setValues(neuron_in);
+    //Keep the dense arrays in step with the neuron
+    if (dense) {
+      outputs[neuron_in.neuron.neuron] = neurons[neuron_in.neuron.neuron].getOutput();
+      gradients[neuron_in.neuron.neuron] = neurons[neuron_in.neuron.neuron].getGradient();
+    }
+  }
+
+  //Makes the layer normalize its sums with softmax instead of calling the activation function
+  void Layer::setSoftmax(unsigned softmax_in)
+  {
+    if (softmax_in && ! dense) {
+      throw std::runtime_error("Softmax output requires dense or sparse storage");
+    }
+    softmax = softmax_in;
+  }
+
+  //Turns sums into probabilities in place
+  void Layer::normalizeSoftmax(double* values_in, unsigned length_in)
+  {
+    unsigned valueIterator;
+    double largest;
+    double sum;
+    double scale;
+
+    if (length_in == 0) {
+      return;
+    }
+    //Shift by the largest sum so every exponent is at most 0
+    largest = values_in[0];
+    for (valueIterator = 1; valueIterator < length_in; ++valueIterator) {
+      largest = std::max(largest, values_in[valueIterator]);
+    }
+    sum = 0.0;
+    for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+      values_in[valueIterator] = exp(values_in[valueIterator] - largest);
+      sum += values_in[valueIterator];
+    }
+    //The largest sum contributes 1, so the total is never 0
+    scale = 1.0 / sum;
+    for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+      values_in[valueIterator] *= scale;
+    }
   }
 
   //Changes the values of all the bias neurons in the layer
@@ -150,15 +937,141 @@ namespace neural
     for (neuronIterator = neurons.size() - 1; neuronIterator >= neurons.size() - bias; --neuronIterator) {
       //Set the neurons value to the specified
       neurons[neuronIterator].setOutput(value_in);
+      if (dense) {
+        outputs[neuronIterator] = value_in;
+      }
     }
   }
 
   //Returns the neuron at the specified location
   Neuron* Layer::getNeuron(unsigned neuron_in)
   {
+    //Bring the neuron up to date with the dense arrays before handing it out
+    if (dense) {
+      neurons[neuron_in - 1].setOutput(outputs[neuron_in - 1]);
+      neurons[neuron_in - 1].setGradient(gradients[neuron_in - 1]);
+    }
     return &neurons[neuron_in - 1];
   }
 
+  //Returns the weight of a connection in dense storage
+  double Layer::getWeight(unsigned neuron_in, unsigned input_in) const
+  {
+    const connection_data* pending;
+    size_t entry;
+
+    //Sparse storage looks through the connections not yet compressed before the matrix
+    if (sparse) {
+      pending = findPending(neuron_in, input_in);
+      if (pending != NULL && ! std::isnan(pending->weight)) {
+        return pending->weight;
+      }
+      entry = findSparse(neuron_in, input_in);
+      return entry < columns.size() ? weights[entry] : 0.0;
+    }
+    if (precision != NEURAL_PRECISION_DOUBLE) {
+      return singleWeightData()[(size_t) neuron_in * inputs + input_in];
+    }
+    return weightData()[(size_t) neuron_in * inputs + input_in];
+  }
+
+  //Returns the last change in weight of a connection in dense storage
+  double Layer::getDeltaWeight(unsigned neuron_in, unsigned input_in) const
+  {
+    const connection_data* pending;
+    size_t entry;
+
+    if (sparse) {
+      pending = findPending(neuron_in, input_in);
+      if (pending != NULL && ! std::isnan(pending->deltaWeight)) {
+        return pending->deltaWeight;
+      }
+      entry = findSparse(neuron_in, input_in);
+      return entry < columns.size() ? deltaWeights[entry] : 0.0;
+    }
+    if (precision != NEURAL_PRECISION_DOUBLE) {
+      return singleDeltaWeightData()[(size_t) neuron_in * inputs + input_in];
+    }
+    return deltaWeightData()[(size_t) neuron_in * inputs + input_in];
+  }
+
+  //Changes the weight of a connection in dense storage
+  void Layer::setWeight(unsigned neuron_in, unsigned input_in, double weight_in)
+  {
+    //Sparse storage adds the connection if it does not exist yet
+    if (sparse) {
+      addConnection(neuron_in, input_in, weight_in, std::numeric_limits<double>::quiet_NaN());
+      return;
+    }
+    if (precision != NEURAL_PRECISION_DOUBLE) {
+      singleWeightData()[(size_t) neuron_in * inputs + input_in] = weight_in;
+      return;
+    }
+    weightData()[(size_t) neuron_in * inputs + input_in] = weight_in;
+  }
+
+  //Changes the last change in weight of a connection in dense storage
+  void Layer::setDeltaWeight(unsigned neuron_in, unsigned input_in, double deltaWeight_in)
+  {
+    if (sparse) {
+      addConnection(neuron_in, input_in, std::numeric_limits<double>::quiet_NaN(), deltaWeight_in);
+      return;
+    }
+    if (precision != NEURAL_PRECISION_DOUBLE) {
+      singleDeltaWeightData()[(size_t) neuron_in * inputs + input_in] = deltaWeight_in;
+      return;
+    }
+    deltaWeightData()[(size_t) neuron_in * inputs + input_in] = deltaWeight_in;
+  }
+
+  //Returns the dense weights currently in use
+  double* Layer::weightData() { return mappedWeights != NULL ? mappedWeights : weights.data(); }
+  const double* Layer::weightData() const { return mappedWeights != NULL ? mappedWeights : weights.data(); }
+  double* Layer::deltaWeightData() { return mappedDeltaWeights != NULL ? mappedDeltaWeights : deltaWeights.data(); }
+  const double* Layer::deltaWeightData() const { return mappedDeltaWeights != NULL ? mappedDeltaWeights : deltaWeights.data(); }
+  float* Layer::singleWeightData() { return mappedSingleWeights != NULL ? mappedSingleWeights : singleWeights.data(); }
+  const float* Layer::singleWeightData() const { return mappedSingleWeights != NULL ? mappedSingleWeights : singleWeights.data(); }
+  float* Layer::singleDeltaWeightData() { return mappedSingleDeltaWeights != NULL ? mappedSingleDeltaWeights : singleDeltaWeights.data(); }
+  const float* Layer::singleDeltaWeightData() const { return mappedSingleDeltaWeights != NULL ? mappedSingleDeltaWeights : singleDeltaWeights.data(); }
+
+  //Weights stored as each type the dense passes are instantiated for
+  template<> double* Layer::matrix<double>() { return weightData(); }
+  template<> float* Layer::matrix<float>() { return singleWeightData(); }
+  template<> double* Layer::deltaMatrix<double>() { return deltaWeightData(); }
+  template<> float* Layer::deltaMatrix<float>() { return singleDeltaWeightData(); }
+
+  //Returns the compressed sparse row matrix
+  const unsigned* Layer::sparseRowStarts() const { return rowStarts.data(); }
+  const unsigned* Layer::sparseColumns() const { return columns.data(); }
+  size_t Layer::numConnections() const
+  {
+    if (! dense) {
+      return connections.size();
+    }
+    return sparse ? columns.size() : (size_t) (neurons.size() - bias) * inputs;
+  }
+
+  //Sparse entries are read along with their column, and each row with its start
+  size_t Layer::weightBytes() const
+  {
+    if (! dense) {
+      return connections.size() * sizeof(Connection);
+    }
+    if (sparse) {
+      return numConnections() * (sizeof(double) + sizeof(unsigned)) + rowStarts.size() * sizeof(unsigned);
+    }
+    return numConnections() * (precision == NEURAL_PRECISION_DOUBLE ? sizeof(double) : sizeof(float));
+  }
+
+  //Getters and Setters
   unsigned Layer::numNeurons() { return neurons.size(); }
+  unsigned Layer::numBias() const { return bias; }
+  unsigned Layer::numInputs() const { return inputs; }
+  unsigned Layer::isDense() const { return dense; }
+  unsigned Layer::isSparse() const { return sparse; }
+  unsigned Layer::isSoftmax() const { return softmax; }
+  unsigned Layer::getPrecision() const { return precision; }
+  unsigned Layer::getBatchSize() const { return batchSize; }
   std::vector<Neuron>* Layer::getNeurons() { return &neurons; }
+  std::vector<double>* Layer::getOutputs() { return &outputs; }
 }
\ No newline at end of file
@@ -6,16 +6,58 @@
 * 
 * Last Modified:
 *   March 14, 2015 - Made activation function constructor parameter
+*   October 17, 2026 - Added dense weight matrix storage
+*   October 17, 2026 - Added mini-batch evaluation for dense storage
+*   October 17, 2026 - Moved dense inner loops onto vectorized kernels
+*   October 17, 2026 - Split neuron ranges across a thread pool
+*   October 17, 2026 - Allowed dense weights to live in externally owned memory
+*   October 17, 2026 - Made dense passes templates on activation and optimizer policies
+*   October 17, 2026 - Added single and mixed precision dense weights
+*   October 17, 2026 - Added compressed sparse row weights
+*   October 17, 2026 - Added magnitude pruning
+*   October 17, 2026 - Added fused softmax and cross-entropy output
+*   October 17, 2026 - Allocated graph connections from a per-layer arena
+*   October 17, 2026 - Made the arena the only copy of each graph connection
+*   October 17, 2026 - Drew weights from a seeded initializer instead of rand()
+*   October 17, 2026 - Counted graph connections in the weight bytes for profiling
+*   October 17, 2026 - Split batch updates into summing and applying the weight gradients
+*   October 17, 2026 - Made layers move-only so graph connections never point into another layer
+*   October 17, 2026 - Left the weights and error of an empty batch alone
+*   October 17, 2026 - Drew the weights of a new dense matrix on a thread pool
 ***********************************************/
 
 #ifndef _H_NEURAL_LAYER
 #define _H_NEURAL_LAYER
 
 #include <vector>    //std::vector
+#include <functional> //std::function
+#include <algorithm> //std::fill()    std::copy()    std::sort()    std::unique()
+#include <stdexcept> //std::runtime_error
+#include <cmath>     //sqrt()    std::isnan()
+#include <limits>    //std::numeric_limits<double>::quiet_NaN()
 
+#include "kernels.hpp"
+#include "activation.hpp"
+#include "optimizer.hpp"
 #include "neuron.hpp"
+#include "thread_pool.hpp"
+#include "initializer.hpp"
 #include "neuron_data.hpp"
 #include "neuron_id.hpp"
+#include "connection_data.hpp"
+
+//Number of samples evaluated together so a block of weight rows is reused while cached
+#define NEURAL_BATCH_TILE 16
+
+//Connections a graph layer's arena starts with when it was not sized from a topology
+#define NEURAL_ARENA_MINIMUM 64
+
+//Dense weights and sums in double precision
+#define NEURAL_PRECISION_DOUBLE 0
+//Dense weights in single precision, forward sums accumulated in single precision
+#define NEURAL_PRECISION_FLOAT  1
+//Dense weights in single precision, every sum accumulated in double precision
+#define NEURAL_PRECISION_MIXED  2
 
 namespace neural
 {
@@ -24,8 +66,141 @@ namespace neural
   private:
     /* Neurons in this layer */
     std::vector<Neuron> neurons;
+    /* Arena holding the only copy of every connection into the layer in graph storage, each neuron's inputs contiguous when built from the topology
+    *   Receiving neurons index it by destination as inputs and sending neurons by source as outputs */
+    std::vector<Connection> connections;
     /* Number of bias neurons in the layer */
     unsigned bias;
+    /* Flags if the layer stores its values in dense arrays instead of the neurons */
+    unsigned dense;
+    /* Number of values input to each neuron in dense storage (previous layer including bias) */
+    unsigned inputs;
+    /* Row-major input weights in dense storage, one row per non-bias neuron */
+    std::vector<double> weights;
+    /* Row-major last change of each input weight in dense storage */
+    std::vector<double> deltaWeights;
+    /* Externally owned weights used in place of weights, NULL when the layer owns its weights */
+    double* mappedWeights;
+    /* Externally owned delta weights used in place of deltaWeights */
+    double* mappedDeltaWeights;
+    /* NEURAL_PRECISION_* the dense weights are stored and summed in */
+    unsigned precision;
+    /* Row-major input weights when stored in single precision */
+    std::vector<float> singleWeights;
+    /* Row-major last change of each input weight when stored in single precision */
+    std::vector<float> singleDeltaWeights;
+    /* Externally owned single precision weights used in place of singleWeights */
+    float* mappedSingleWeights;
+    /* Externally owned single precision delta weights used in place of singleDeltaWeights */
+    float* mappedSingleDeltaWeights;
+    /* Previous layer's outputs narrowed for single precision sums */
+    std::vector<float> singleInputs;
+    /* Previous layer's batch narrowed for single precision sums, one row per sample */
+    std::vector<float> singleBatch;
+    /* Location of each sample in singleBatch */
+    std::vector<const float*> singleBatchRows;
+    /* Flags if the weights are a compressed sparse row matrix of only the connections that exist, held in weights and deltaWeights */
+    unsigned sparse;
+    /* Offset of each non-bias neuron's first sparse entry, with one more offset marking the end */
+    std::vector<unsigned> rowStarts;
+    /* Input of each sparse entry, sorted within each row */
+    std::vector<unsigned> columns;
+    /* Offset of each input's first entry in the transposed sparse matrix, with one more offset marking the end */
+    std::vector<unsigned> columnStarts;
+    /* Neuron of each entry in the transposed sparse matrix */
+    std::vector<unsigned> transposeRows;
+    /* Weights in transposed order so the backward pass gathers a column the way the forward pass gathers a row */
+    std::vector<double> transposeWeights;
+    /* Location in transposeWeights of each sparse entry */
+    std::vector<unsigned> transposeSlots;
+    /* Connections added since the sparse matrix was last compressed, destination is the neuron and source the input */
+    std::vector<connection_data> pendingConnections;
+    /* Draws the weights of the layer's connections, by position so any order gives the same weights */
+    Initializer initializer;
+    /* Flags if the layer normalizes its sums with softmax instead of calling the activation function */
+    unsigned softmax;
+    /* Output value of each neuron in dense storage */
+    std::vector<double> outputs;
+    /* Gradient of each neuron in dense storage */
+    std::vector<double> gradients;
+    /* Number of samples in the current batch */
+    unsigned batchSize;
+    /* Location of the non-bias values of each sample in the current batch */
+    std::vector<const double*> batchRows;
+    /* Non-bias outputs of each sample in the current batch, one row per sample */
+    std::vector<double> batchOutputs;
+    /* Non-bias gradients of each sample in the current batch, one row per sample */
+    std::vector<double> batchGradients;
+    /* Gradient of each weight accumulated over the current batch */
+    std::vector<double> weightGradients;
+
+    /***********************
+    * Sizes the batch arrays and points each batch row at this layer's outputs
+    * @param samples_in Number of samples in the batch
+    ***********************/
+    void resizeBatch(unsigned samples_in);
+
+    /***********************
+    * Splits a range of neurons or samples between the threads of a pool
+    * @param pool_in  Pool to run on, NULL runs the whole range on the calling thread
+    * @param items_in Number of items in the range
+    * @param task_in  Function called with the first and one past the last item of each part
+    ***********************/
+    static void split(ThreadPool* pool_in, unsigned items_in, const std::function<void(unsigned, unsigned)> &task_in);
+
+    /***********************
+    * Returns the row-major weights or delta weights stored as the specified type
+    ***********************/
+    template<class Weight> Weight* matrix();
+    template<class Weight> Weight* deltaMatrix();
+
+    /***********************
+    * Inner loops of the dense passes for one weight and input type
+    *   Weight is the type the matrix is stored as, Input the type the previous layer's values are summed in
+    ***********************/
+    template<class Activation> void feedForwardDense(Layer* previous_in, const Activation& activation_in, ThreadPool* pool_in);
+    template<class Activation> void feedForwardBatchDense(Layer* previous_in, const Activation& activation_in, ThreadPool* pool_in);
+    template<class Activation, class Weight, class Input> void feedForwardMatrix(const Input* values_in, const Activation& activation_in, ThreadPool* pool_in);
+    template<class Activation, class Weight> void calculateHiddenGradientsMatrix(Layer* next_in, const Activation& activation_in, ThreadPool* pool_in);
+    template<class Optimizer, class Weight> void updateInputWeightsMatrix(Layer* previous_in, const Optimizer& optimizer_in, ThreadPool* pool_in);
+    template<class Activation, class Weight, class Input> void feedForwardBatchMatrix(Layer* previous_in, const Input* const* rows_in, const Activation& activation_in, ThreadPool* pool_in);
+    template<class Activation, class Weight> void calculateHiddenGradientsBatchMatrix(Layer* next_in, const Activation& activation_in, ThreadPool* pool_in);
+    template<class Optimizer, class Weight> void updateInputWeightsBatchMatrix(Layer* previous_in, const Optimizer& optimizer_in, ThreadPool* pool_in);
+
+    /***********************
+    * Sums gradient * input over the current batch for a block of weight rows
+    * @param previous_in Layer feeding into this layer
+    * @param begin_in    First row to sum
+    * @param end_in      One past the last row to sum
+    * @param sums_out    Row-major sums of the whole layer, only the block's rows are overwritten
+    ***********************/
+    void sumWeightGradientRows(Layer* previous_in, unsigned begin_in, unsigned end_in, double* sums_out);
+
+    /***********************
+    * Applies one update to each weight of a block of rows from gradients summed over a batch
+    ***********************/
+    template<class Optimizer, class Weight> void applyWeightGradientRows(const double* sums_in, unsigned samples_in, const Optimizer& optimizer_in, unsigned begin_in, unsigned end_in);
+
+    /***********************
+    * Inner loops of the sparse passes, rows are gathered against the previous layer and columns against the next
+    ***********************/
+    template<class Activation> void feedForwardSparse(const double* values_in, const Activation& activation_in, ThreadPool* pool_in);
+    template<class Activation> void calculateHiddenGradientsSparse(Layer* next_in, const Activation& activation_in, ThreadPool* pool_in);
+    template<class Optimizer> void updateInputWeightsSparse(Layer* previous_in, const Optimizer& optimizer_in, ThreadPool* pool_in);
+
+    /***********************
+    * Finds the sparse entry of a connection
+    * @param neuron_in Index of the receiving neuron in this layer
+    * @param input_in  Index of the sending neuron in the previous layer
+    * @return Index of the entry, the number of entries if the connection does not exist
+    ***********************/
+    size_t findSparse(unsigned neuron_in, unsigned input_in) const;
+
+    /***********************
+    * Finds the most recent pending connection between two neurons
+    * @return The pending connection, NULL if there is none
+    ***********************/
+    const connection_data* findPending(unsigned neuron_in, unsigned input_in) const;
   
   public:
     /***********************
@@ -41,6 +216,17 @@ namespace neural
     ***********************/
     Layer(unsigned neurons_in, unsigned bias_in);
 
+    /***********************
+    * Moves a Layer, its neurons and connections keep their addresses
+    * @param layer_in Layer to move from, left empty
+    ***********************/
+    Layer(Layer&& layer_in) = default;
+    Layer& operator=(Layer&& layer_in) = default;
+
+    /* Graph neurons point into the layer's arenas, so a copy would read the original's connections */
+    Layer(const Layer& layer_in) = delete;
+    Layer& operator=(const Layer& layer_in) = delete;
+
     /***********************
     * Create and add a new neuron to the layer
     * @param bias_in flags if this neuron is a bias neuron
@@ -54,6 +240,103 @@ namespace neural
     ***********************/
     void addNeuron(std::vector<Neuron>* inputs_in, unsigned bias_in);
 
+    /***********************
+    * Sizes a graph layer's neurons and connection arena up front so neither moves while the network is built
+    * @param neurons_in Number of neurons (including bias) the layer will hold
+    * @param inputs_in  Number of neurons (including bias) each non-bias neuron will be connected to
+    ***********************/
+    void reserveGraph(unsigned neurons_in, unsigned inputs_in);
+
+    /***********************
+    * Sizes the output list of every neuron in a graph layer up front
+    * @param outputs_in Number of neurons each neuron will output to
+    ***********************/
+    void reserveOutputs(unsigned outputs_in);
+
+    /***********************
+    * Sets how the layer draws weights for its connections, existing weights are kept
+    * @param initializer_in Initializer already set up for this layer with forLayer
+    ***********************/
+    void setInitializer(const Initializer& initializer_in);
+
+    /***********************
+    * Redraws every weight in the layer from its initializer and clears the delta weights
+    *   Each weight depends only on its position, so the result is the same on any number of threads
+    * @param pool_in Pool to split the neurons between, NULL for the calling thread
+    ***********************/
+    void initializeWeights(ThreadPool* pool_in = NULL);
+
+    /***********************
+    * Allocates a connection into a neuron of this graph layer from the layer's arena
+    *   A full arena is moved into one twice the size, carrying the inputs and outputs that point into it along with it
+    * @param source_in      Neuron sending on the connection
+    * @param destination_in Neuron of this layer receiving on the connection
+    * @param weight_in      Weight of the connection, NaN draws one from the layer's initializer
+    * @param deltaWeight_in Last change in weight of the connection, NaN starts at 0
+    * @return The connection in the arena
+    ***********************/
+    Connection* connect(Neuron* source_in, Neuron* destination_in, double weight_in, double deltaWeight_in);
+
+    /***********************
+    * Switches the layer to dense storage with a weight matrix of the specified width
+    * @param inputs_in    Number of neurons (including bias) in the previous layer, 0 for the input layer
+    * @param precision_in NEURAL_PRECISION_* to store and sum the weights in
+    * @param pool_in      Threads the weights are drawn on, NULL to draw them on the calling thread
+    ***********************/
+    void makeDense(unsigned inputs_in, unsigned precision_in = NEURAL_PRECISION_DOUBLE, ThreadPool* pool_in = NULL);
+
+    /***********************
+    * Switches the layer to dense storage using externally owned weights, the caller keeps them alive
+    * @param inputs_in       Number of neurons (including bias) in the previous layer
+    * @param weights_in      Row-major weights, one row of inputs_in per non-bias neuron
+    * @param deltaWeights_in Row-major last change of each weight
+    ***********************/
+    void makeDense(unsigned inputs_in, double* weights_in, double* deltaWeights_in);
+
+    /***********************
+    * Switches the layer to dense storage using externally owned single precision weights, the caller keeps them alive
+    * @param inputs_in       Number of neurons (including bias) in the previous layer
+    * @param weights_in      Row-major weights, one row of inputs_in per non-bias neuron
+    * @param deltaWeights_in Row-major last change of each weight
+    * @param precision_in    NEURAL_PRECISION_FLOAT or NEURAL_PRECISION_MIXED
+    ***********************/
+    void makeDense(unsigned inputs_in, float* weights_in, float* deltaWeights_in, unsigned precision_in);
+
+    /***********************
+    * Switches the layer to sparse storage with no connections, values are kept in the dense arrays
+    * @param inputs_in Number of neurons (including bias) in the previous layer
+    ***********************/
+    void makeSparse(unsigned inputs_in);
+
+    /***********************
+    * Adds a connection to the sparse matrix, replacing it if it already exists
+    *   The connection is held aside until the matrix is next compressed
+    * @param neuron_in      Index of the receiving neuron in this layer
+    * @param input_in       Index of the sending neuron in the previous layer
+    * @param weight_in      Weight of the connection, NaN keeps the current weight or picks a random one
+    * @param deltaWeight_in Last change in weight, NaN keeps the current change or starts at 0
+    ***********************/
+    void addConnection(unsigned neuron_in, unsigned input_in, double weight_in, double deltaWeight_in);
+
+    /***********************
+    * Folds every pending connection into the sparse matrix and rebuilds its transpose
+    *   The sparse passes call this themselves when connections are pending
+    ***********************/
+    void compressSparse();
+
+    /***********************
+    * Removes every connection whose weight is smaller in magnitude than a threshold
+    *   Dense layers are converted to double precision sparse storage holding the connections that remain
+    * @param threshold_in Connections with an absolute weight below this are removed
+    ***********************/
+    void prune(double threshold_in);
+
+    /***********************
+    * Appends the absolute weight of every connection into the layer
+    * @param location_in location to append the magnitudes to
+    ***********************/
+    void getMagnitudes(std::vector<double>* location_in);
+
     /***********************
     * Modifies the value sof the neuron to match the input values
     * @param neuron_in Vallues to match
@@ -72,6 +355,22 @@ namespace neural
     ***********************/
     void feedForward(double (*activationFunction)(double));
 
+    /***********************
+    * Sets all the neurons to forward their values, reading dense inputs from the previous layer
+    * @param previous_in Layer feeding into this layer
+    * @param activationFunction function to call to determine neuron output
+    * @param pool_in Threads to split the neurons between, NULL for the calling thread only
+    ***********************/
+    void feedForward(Layer* previous_in, double (*activationFunction)(double), ThreadPool* pool_in = NULL);
+
+    /***********************
+    * Sets all the neurons to forward their values with an activation policy resolved at compile time (dense storage only)
+    * @param previous_in Layer feeding into this layer
+    * @param activation_in policy providing value() and derivative()
+    * @param pool_in Threads to split the neurons between, NULL for the calling thread only
+    ***********************/
+    template<class Activation> void feedForward(Layer* previous_in, const Activation& activation_in, ThreadPool* pool_in = NULL);
+
     /***********************
     * Calculates the error for the network using root mean square storing it in the error member
     * @param values_in Values expected for each Neuron
@@ -79,6 +378,13 @@ namespace neural
     ***********************/
     double calculateError(const std::vector<double> &values_in);
 
+    /***********************
+    * Calculates the cross-entropy of a softmax layer and its gradients with respect to the sums in one pass
+    * @param values_in Probability expected for each Neuron, usually one-hot
+    * @return Cross-entropy of the outputs against the expected values
+    ***********************/
+    double calculateSoftmaxGradients(const std::vector<double> &values_in);
+
     /***********************
     * Calculates the output gradients for the layer
     * @param values_in Values expected for each Neuron
@@ -86,23 +392,165 @@ namespace neural
     ***********************/
     void calculateOutputGradients(const std::vector<double> &values_in, double (*activationFunctionDerivative)(double));
 
+    /***********************
+    * Calculates the output gradients for the layer with an activation policy (dense storage only)
+    * @param values_in Values expected for each Neuron
+    * @param activation_in policy providing value() and derivative()
+    ***********************/
+    template<class Activation> void calculateOutputGradients(const std::vector<double> &values_in, const Activation& activation_in);
+
     /***********************
     * Calculates the gradients for the layer
     * @param activationFunctionDerivative derivative of activation function
     ***********************/
     void calculateHiddenGradients(double (*activationFunctionDerivative)(double));
 
+    /***********************
+    * Calculates the gradients for the layer, reading dense gradients from the next layer
+    * @param next_in Layer this layer feeds into
+    * @param activationFunctionDerivative derivative of activation function
+    * @param pool_in Threads to split the neurons between, NULL for the calling thread only
+    ***********************/
+    void calculateHiddenGradients(Layer* next_in, double (*activationFunctionDerivative)(double), ThreadPool* pool_in = NULL);
+
+    /***********************
+    * Calculates the gradients for the layer with an activation policy (dense storage only)
+    * @param next_in Layer this layer feeds into
+    * @param activation_in policy providing value() and derivative()
+    * @param pool_in Threads to split the neurons between, NULL for the calling thread only
+    ***********************/
+    template<class Activation> void calculateHiddenGradients(Layer* next_in, const Activation& activation_in, ThreadPool* pool_in = NULL);
+
     /***********************
     * Updates the weights of each neuron in the layer
     ***********************/
     void updateInputWeights(double (*deltaInputWeight)(double, double, double, double));
 
+    /***********************
+    * Updates the weights of each neuron in the layer, reading dense inputs from the previous layer
+    * @param previous_in Layer feeding into this layer
+    * @param pool_in Threads to split the neurons between, NULL for the calling thread only
+    ***********************/
+    void updateInputWeights(Layer* previous_in, double (*deltaInputWeight)(double, double, double, double), ThreadPool* pool_in = NULL);
+
+    /***********************
+    * Updates the weights of each neuron with an optimizer policy resolved at compile time (dense storage only)
+    * @param previous_in Layer feeding into this layer
+    * @param optimizer_in policy providing delta()
+    * @param pool_in Threads to split the neurons between, NULL for the calling thread only
+    ***********************/
+    template<class Optimizer> void updateInputWeights(Layer* previous_in, const Optimizer& optimizer_in, ThreadPool* pool_in = NULL);
+
+    /***********************
+    * Points the batch rows of the layer at externally owned values without copying them
+    * @param values_in  Non-bias values of each sample
+    * @param samples_in Number of samples in the batch
+    ***********************/
+    void setBatchValues(const double* const* values_in, unsigned samples_in);
+
+    /***********************
+    * Forwards every sample of the previous layer's batch through this layer
+    * @param previous_in Layer feeding into this layer
+    * @param activationFunction function to call to determine neuron output
+    * @param pool_in Threads to split the neurons between, NULL for the calling thread only
+    ***********************/
+    void feedForwardBatch(Layer* previous_in, double (*activationFunction)(double), ThreadPool* pool_in = NULL);
+
+    /* Policy version of feedForwardBatch */
+    template<class Activation> void feedForwardBatch(Layer* previous_in, const Activation& activation_in, ThreadPool* pool_in = NULL);
+
+    /***********************
+    * Calculates the root mean square error over every sample in the batch
+    * @param values_in Values expected for each Neuron of each sample
+    * @return Error for the batch
+    ***********************/
+    double calculateBatchError(const double* const* values_in);
+
+    /***********************
+    * Calculates the cross-entropy of a softmax layer and its gradients for every sample in the batch
+    * @param values_in Probability expected for each Neuron of each sample
+    * @return Mean cross-entropy over the batch
+    ***********************/
+    double calculateSoftmaxGradientsBatch(const double* const* values_in);
+
+    /***********************
+    * Calculates the output gradients for every sample in the batch
+    * @param values_in Values expected for each Neuron of each sample
+    * @param activationFunctionDerivative derivative of activation function
+    ***********************/
+    void calculateOutputGradientsBatch(const double* const* values_in, double (*activationFunctionDerivative)(double));
+
+    /* Policy version of calculateOutputGradientsBatch */
+    template<class Activation> void calculateOutputGradientsBatch(const double* const* values_in, const Activation& activation_in);
+
+    /***********************
+    * Calculates the gradients for every sample in the batch from the next layer's gradients
+    * @param next_in Layer this layer feeds into
+    * @param activationFunctionDerivative derivative of activation function
+    * @param pool_in Threads to split the samples between, NULL for the calling thread only
+    ***********************/
+    void calculateHiddenGradientsBatch(Layer* next_in, double (*activationFunctionDerivative)(double), ThreadPool* pool_in = NULL);
+
+    /* Policy version of calculateHiddenGradientsBatch */
+    template<class Activation> void calculateHiddenGradientsBatch(Layer* next_in, const Activation& activation_in, ThreadPool* pool_in = NULL);
+
+    /***********************
+    * Accumulates the weight gradients over the batch and applies a single update to each weight
+    *   The hook receives the mean of gradient * input over the batch as the gradient and 1.0 as the input value
+    * @param previous_in Layer feeding into this layer
+    * @param pool_in Threads to split the neurons between, NULL for the calling thread only
+    ***********************/
+    void updateInputWeightsBatch(Layer* previous_in, double (*deltaInputWeight)(double, double, double, double), ThreadPool* pool_in = NULL);
+
+    /* Policy version of updateInputWeightsBatch */
+    template<class Optimizer> void updateInputWeightsBatch(Layer* previous_in, const Optimizer& optimizer_in, ThreadPool* pool_in = NULL);
+
+    /***********************
+    * Sums gradient * input over the current batch for every weight without changing any weight
+    *   Each sum runs over the samples in order, so it depends only on the batch
+    * @param previous_in Layer feeding into this layer
+    * @param sums_out    Row-major sums, one row of numInputs() per non-bias neuron, overwritten
+    * @param pool_in Threads to split the neurons between, NULL for the calling thread only
+    ***********************/
+    void sumWeightGradients(Layer* previous_in, double* sums_out, ThreadPool* pool_in = NULL);
+
+    /***********************
+    * Applies one update to each weight from gradients summed over a batch, as updateInputWeightsBatch does
+    *   The hook receives the sum / samples as the gradient and 1.0 as the input value
+    * @param sums_in    Row-major sums from sumWeightGradients, possibly added up over several batches
+    * @param samples_in Number of samples the sums cover
+    * @param pool_in Threads to split the neurons between, NULL for the calling thread only
+    ***********************/
+    void applyWeightGradients(const double* sums_in, unsigned samples_in, double (*deltaInputWeight)(double, double, double, double), ThreadPool* pool_in = NULL);
+
+    /* Policy version of applyWeightGradients */
+    template<class Optimizer> void applyWeightGradients(const double* sums_in, unsigned samples_in, const Optimizer& optimizer_in, ThreadPool* pool_in = NULL);
+
+    /***********************
+    * Returns the result values of every sample in the batch, one row per sample
+    * @param location_in lcoation to store the values
+    ***********************/
+    void getBatchResults(std::vector<double>* location_in);
+
     /***********************
     * Returns the result values of the layer
     * @param location_in lcoation to store the values
     ***********************/
     void getResults(std::vector<double>* location_in);
 
+    /**********************
+    * Makes the layer normalize its sums with softmax instead of calling the activation function (dense and sparse storage)
+    * @param softmax_in flags if the layer is a softmax layer
+    **********************/
+    void setSoftmax(unsigned softmax_in);
+
+    /**********************
+    * Turns sums into probabilities in place, shifted by the largest sum so no exponent overflows
+    * @param values_in sums to normalize
+    * @param length_in number of sums
+    **********************/
+    static void normalizeSoftmax(double* values_in, unsigned length_in);
+
     /**********************
     * Changes the values of all the bias neurons in the layer
     * @param value_in New value for bias neurons
@@ -115,9 +563,535 @@ namespace neural
     **********************/
     Neuron* getNeuron(unsigned neuron_in);
 
+    /**********************
+    * Returns the weight of a connection in dense storage, 0 for a connection missing from sparse storage
+    * @param neuron_in Index of the receiving neuron in this layer
+    * @param input_in  Index of the sending neuron in the previous layer
+    **********************/
+    double getWeight(unsigned neuron_in, unsigned input_in) const;
+
+    /**********************
+    * Returns the last change in weight of a connection in dense storage
+    * @param neuron_in Index of the receiving neuron in this layer
+    * @param input_in  Index of the sending neuron in the previous layer
+    **********************/
+    double getDeltaWeight(unsigned neuron_in, unsigned input_in) const;
+
+    /**********************
+    * Returns the row-major dense weights currently in use (double precision only)
+    *   Sparse storage returns the weight of each entry in row order
+    **********************/
+    double* weightData();
+    const double* weightData() const;
+
+    /**********************
+    * Returns the row-major last change of each dense weight currently in use (double precision only)
+    **********************/
+    double* deltaWeightData();
+    const double* deltaWeightData() const;
+
+    /**********************
+    * Returns the row-major dense weights currently in use (single and mixed precision only)
+    **********************/
+    float* singleWeightData();
+    const float* singleWeightData() const;
+
+    /**********************
+    * Returns the row-major last change of each dense weight currently in use (single and mixed precision only)
+    **********************/
+    float* singleDeltaWeightData();
+    const float* singleDeltaWeightData() const;
+
+    void setWeight(unsigned neuron_in, unsigned input_in, double weight_in);
+    void setDeltaWeight(unsigned neuron_in, unsigned input_in, double deltaWeight_in);
+
+    /**********************
+    * Returns the compressed sparse row matrix, the passes and compressSparse() keep it current
+    *   Row starts hold an offset per non-bias neuron plus the end, columns the input of each entry
+    **********************/
+    const unsigned* sparseRowStarts() const;
+    const unsigned* sparseColumns() const;
+
+    /**********************
+    * Returns the number of connections into the layer, every entry of a dense matrix counts
+    *   Graph storage counts the connections in its arena
+    *   Sparse storage counts the entries as of the last compression
+    **********************/
+    size_t numConnections() const;
+
+    /**********************
+    * Returns the bytes of weights and sparse indices one forward pass through the layer reads
+    *   Graph storage reads every connection whole
+    **********************/
+    size_t weightBytes() const;
     unsigned numNeurons();
+    unsigned numBias() const;
+    unsigned numInputs() const;
+    unsigned isDense() const;
+    unsigned isSparse() const;
+    unsigned isSoftmax() const;
+    unsigned getPrecision() const;
+    unsigned getBatchSize() const;
     std::vector<Neuron>* getNeurons();
+    std::vector<double>* getOutputs();
   };
+
+  //Dense passes are templates so a policy known at compile time is inlined into the inner loops
+  //Each pass picks the matrix type from the layer's precision then runs the matching inner loop
+
+  template<> double* Layer::matrix<double>();
+  template<> float* Layer::matrix<float>();
+  template<> double* Layer::deltaMatrix<double>();
+  template<> float* Layer::deltaMatrix<float>();
+
+  //Sets all the neurons to forward their values, reading dense inputs from the previous layer
+  template<class Activation> void Layer::feedForward(Layer* previous_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    if (! dense) {
+      throw std::runtime_error("Activation policies require dense storage");
+    }
+    //Softmax layers keep their sums and normalize them together
+    if (softmax) {
+      feedForwardDense(previous_in, activation::Linear(), pool_in);
+      normalizeSoftmax(outputs.data(), neurons.size() - bias);
+      return;
+    }
+    feedForwardDense(previous_in, activation_in, pool_in);
+  }
+
+  //Picks the inner loop for the layer's storage and precision
+  template<class Activation> void Layer::feedForwardDense(Layer* previous_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    if (sparse) {
+      feedForwardSparse(previous_in->outputs.data(), activation_in, pool_in);
+      return;
+    }
+    switch (precision) {
+    case NEURAL_PRECISION_FLOAT:
+      //Narrow the inputs once so every row is summed in single precision
+      singleInputs.assign(previous_in->outputs.begin(), previous_in->outputs.end());
+      feedForwardMatrix<Activation, float>(singleInputs.data(), activation_in, pool_in);
+      break;
+    case NEURAL_PRECISION_MIXED:
+      feedForwardMatrix<Activation, float>(previous_in->outputs.data(), activation_in, pool_in);
+      break;
+    default:
+      feedForwardMatrix<Activation, double>(previous_in->outputs.data(), activation_in, pool_in);
+      break;
+    }
+  }
+
+  //Multiplies the weight matrix by the previous layer's outputs
+  template<class Activation, class Weight, class Input> void Layer::feedForwardMatrix(const Input* values_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    const Weight* rows;
+
+    rows = matrix<Weight>();
+    //Each thread takes a block of rows
+    split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+      unsigned neuronIterator;
+
+      for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+        outputs[neuronIterator] = activation_in.value(kernels::rowDot(rows + (size_t) neuronIterator * inputs, values_in, inputs));
+      }
+    });
+  }
+
+  //Calculates the output gradients for the layer
+  template<class Activation> void Layer::calculateOutputGradients(const std::vector<double> &values_in, const Activation& activation_in)
+  {
+    unsigned neuronIterator;
+
+    if (! dense) {
+      throw std::runtime_error("Activation policies require dense storage");
+    }
+    //Dense storage keeps the gradients next to the outputs
+    for (neuronIterator = 0; neuronIterator < neurons.size() - bias; ++neuronIterator) {
+      gradients[neuronIterator] = (values_in[neuronIterator] - outputs[neuronIterator]) * activation_in.derivative(outputs[neuronIterator]);
+    }
+  }
+
+  //Calculates the gradients for the layer, reading dense gradients from the next layer
+  template<class Activation> void Layer::calculateHiddenGradients(Layer* next_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    if (! dense) {
+      throw std::runtime_error("Activation policies require dense storage");
+    }
+    if (next_in->sparse) {
+      calculateHiddenGradientsSparse(next_in, activation_in, pool_in);
+      return;
+    }
+    //Gradients are always summed in double precision
+    if (next_in->precision == NEURAL_PRECISION_DOUBLE) {
+      calculateHiddenGradientsMatrix<Activation, double>(next_in, activation_in, pool_in);
+    } else {
+      calculateHiddenGradientsMatrix<Activation, float>(next_in, activation_in, pool_in);
+    }
+  }
+
+  //Accumulates the transposed product of the next layer's weights and gradients
+  template<class Activation, class Weight> void Layer::calculateHiddenGradientsMatrix(Layer* next_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    const Weight* rows;
+
+    rows = next_in->matrix<Weight>();
+    //Each thread takes a block of columns
+    split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+      unsigned neuronIterator;
+      unsigned outputIterator;
+
+      for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+        gradients[neuronIterator] = 0.0;
+      }
+      for (outputIterator = 0; outputIterator < next_in->neurons.size() - next_in->bias; ++outputIterator) {
+        kernels::rowAxpy(next_in->gradients[outputIterator], rows + (size_t) outputIterator * next_in->inputs + begin_in, &gradients[begin_in], end_in - begin_in);
+      }
+      //Scale each sum by the derivative at the neuron's output
+      for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+        gradients[neuronIterator] *= activation_in.derivative(outputs[neuronIterator]);
+      }
+    });
+  }
+
+  //Updates the weights of each neuron in the layer, reading dense inputs from the previous layer
+  template<class Optimizer> void Layer::updateInputWeights(Layer* previous_in, const Optimizer& optimizer_in, ThreadPool* pool_in)
+  {
+    if (! dense) {
+      throw std::runtime_error("Optimizer policies require dense storage");
+    }
+    if (sparse) {
+      updateInputWeightsSparse(previous_in, optimizer_in, pool_in);
+      return;
+    }
+    if (precision == NEURAL_PRECISION_DOUBLE) {
+      updateInputWeightsMatrix<Optimizer, double>(previous_in, optimizer_in, pool_in);
+    } else {
+      updateInputWeightsMatrix<Optimizer, float>(previous_in, optimizer_in, pool_in);
+    }
+  }
+
+  //Hits each weight one row at a time, the change is found in double precision then stored as the matrix type
+  template<class Optimizer, class Weight> void Layer::updateInputWeightsMatrix(Layer* previous_in, const Optimizer& optimizer_in, ThreadPool* pool_in)
+  {
+    const double* values;
+    Weight* rows;
+    Weight* deltaRows;
+
+    values = &previous_in->outputs[0];
+    rows = matrix<Weight>();
+    deltaRows = deltaMatrix<Weight>();
+    //Each thread takes a block of rows
+    split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+      unsigned neuronIterator;
+      unsigned inputIterator;
+      Weight* row;
+      Weight* deltaRow;
+      double gradient;
+      double newDeltaWeight;
+
+      for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+        row = rows + (size_t) neuronIterator * inputs;
+        deltaRow = deltaRows + (size_t) neuronIterator * inputs;
+        gradient = gradients[neuronIterator];
+        for (inputIterator = 0; inputIterator < inputs; ++inputIterator) {
+          //Calculate new deltaweight then store it and update the weight
+          newDeltaWeight = optimizer_in.delta(gradient, row[inputIterator], deltaRow[inputIterator], values[inputIterator]);
+          deltaRow[inputIterator] = newDeltaWeight;
+          row[inputIterator] += newDeltaWeight;
+        }
+      }
+    });
+  }
+
+  //Forwards every sample of the previous layer's batch through this layer
+  template<class Activation> void Layer::feedForwardBatch(Layer* previous_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    unsigned sampleIterator;
+
+    if (! dense || sparse) {
+      throw std::runtime_error("Batched evaluation requires dense storage");
+    }
+    resizeBatch(previous_in->batchSize);
+    //Softmax layers keep their sums and normalize each sample's together
+    if (softmax) {
+      feedForwardBatchDense(previous_in, activation::Linear(), pool_in);
+      for (sampleIterator = 0; sampleIterator < batchSize; ++sampleIterator) {
+        normalizeSoftmax(&batchOutputs[(size_t) sampleIterator * (neurons.size() - bias)], neurons.size() - bias);
+      }
+      return;
+    }
+    feedForwardBatchDense(previous_in, activation_in, pool_in);
+  }
+
+  //Picks the inner loop for the layer's precision
+  template<class Activation> void Layer::feedForwardBatchDense(Layer* previous_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    unsigned sampleIterator;
+    unsigned width;
+
+    switch (precision) {
+    case NEURAL_PRECISION_FLOAT:
+      //Narrow the whole batch once so every row is summed in single precision
+      width = previous_in->neurons.size() - previous_in->bias;
+      singleBatch.resize((size_t) batchSize * width);
+      singleBatchRows.resize(batchSize);
+      for (sampleIterator = 0; sampleIterator < batchSize; ++sampleIterator) {
+        std::copy(previous_in->batchRows[sampleIterator], previous_in->batchRows[sampleIterator] + width, singleBatch.begin() + (size_t) sampleIterator * width);
+        singleBatchRows[sampleIterator] = singleBatch.data() + (size_t) sampleIterator * width;
+      }
+      feedForwardBatchMatrix<Activation, float>(previous_in, singleBatchRows.data(), activation_in, pool_in);
+      break;
+    case NEURAL_PRECISION_MIXED:
+      feedForwardBatchMatrix<Activation, float>(previous_in, previous_in->batchRows.data(), activation_in, pool_in);
+      break;
+    default:
+      feedForwardBatchMatrix<Activation, double>(previous_in, previous_in->batchRows.data(), activation_in, pool_in);
+      break;
+    }
+  }
+
+  //Multiplies every sample of the batch by the weight matrix
+  template<class Activation, class Weight, class Input> void Layer::feedForwardBatchMatrix(Layer* previous_in, const Input* const* rows_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    const Weight* rows;
+    unsigned width;
+
+    rows = matrix<Weight>();
+    //Bias inputs are not part of the batch rows
+    width = previous_in->neurons.size() - previous_in->bias;
+
+    //Each thread multiplies every sample by its own block of weight rows
+    split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+      unsigned tileIterator;
+      unsigned tileEnd;
+      unsigned sampleIterator;
+      unsigned neuronIterator;
+      unsigned inputIterator;
+      const Weight* row;
+      double biasSum;
+
+      //Multiply a tile of samples by the block of rows so each row is reused while cached
+      for (tileIterator = 0; tileIterator < batchSize; tileIterator += NEURAL_BATCH_TILE) {
+        tileEnd = tileIterator + NEURAL_BATCH_TILE < batchSize ? tileIterator + NEURAL_BATCH_TILE : batchSize;
+        for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+          row = rows + (size_t) neuronIterator * inputs;
+          //Bias inputs are the same for every sample
+          biasSum = 0.0;
+          for (inputIterator = width; inputIterator < inputs; ++inputIterator) {
+            biasSum += row[inputIterator] * previous_in->outputs[inputIterator];
+          }
+          for (sampleIterator = tileIterator; sampleIterator < tileEnd; ++sampleIterator) {
+            batchOutputs[sampleIterator * (neurons.size() - bias) + neuronIterator] = activation_in.value(biasSum + kernels::rowDot(row, rows_in[sampleIterator], width));
+          }
+        }
+      }
+    });
+  }
+
+  //Calculates the output gradients for every sample in the batch
+  template<class Activation> void Layer::calculateOutputGradientsBatch(const double* const* values_in, const Activation& activation_in)
+  {
+    unsigned sampleIterator;
+    unsigned neuronIterator;
+    unsigned width;
+    const double* values;
+    double* gradient;
+
+    width = neurons.size() - bias;
+    //Hit each neuron of each sample
+    for (sampleIterator = 0; sampleIterator < batchSize; ++sampleIterator) {
+      values = batchRows[sampleIterator];
+      gradient = &batchGradients[sampleIterator * width];
+      for (neuronIterator = 0; neuronIterator < width; ++neuronIterator) {
+        gradient[neuronIterator] = (values_in[sampleIterator][neuronIterator] - values[neuronIterator]) * activation_in.derivative(values[neuronIterator]);
+      }
+    }
+  }
+
+  //Calculates the gradients for every sample in the batch from the next layer's gradients
+  template<class Activation> void Layer::calculateHiddenGradientsBatch(Layer* next_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    if (next_in->sparse) {
+      throw std::runtime_error("Batched evaluation requires dense storage");
+    }
+    //Gradients are always summed in double precision
+    if (next_in->precision == NEURAL_PRECISION_DOUBLE) {
+      calculateHiddenGradientsBatchMatrix<Activation, double>(next_in, activation_in, pool_in);
+    } else {
+      calculateHiddenGradientsBatchMatrix<Activation, float>(next_in, activation_in, pool_in);
+    }
+  }
+
+  //Accumulates the transposed product of the next layer's weights and each sample's gradients
+  template<class Activation, class Weight> void Layer::calculateHiddenGradientsBatchMatrix(Layer* next_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    const Weight* rows;
+    unsigned width;
+    unsigned nextWidth;
+
+    rows = next_in->matrix<Weight>();
+    width = neurons.size() - bias;
+    nextWidth = next_in->neurons.size() - next_in->bias;
+
+    //Samples are independent so each thread takes a block of them
+    split(pool_in, batchSize, [&](unsigned begin_in, unsigned end_in) {
+      unsigned tileIterator;
+      unsigned tileEnd;
+      unsigned sampleIterator;
+      unsigned neuronIterator;
+      unsigned outputIterator;
+      const Weight* row;
+
+      std::fill(batchGradients.begin() + begin_in * width, batchGradients.begin() + end_in * width, 0.0);
+      //Accumulate the transposed product for a tile of samples so each row of the next layer is reused while cached
+      for (tileIterator = begin_in; tileIterator < end_in; tileIterator += NEURAL_BATCH_TILE) {
+        tileEnd = tileIterator + NEURAL_BATCH_TILE < end_in ? tileIterator + NEURAL_BATCH_TILE : end_in;
+        for (outputIterator = 0; outputIterator < nextWidth; ++outputIterator) {
+          row = rows + (size_t) outputIterator * next_in->inputs;
+          for (sampleIterator = tileIterator; sampleIterator < tileEnd; ++sampleIterator) {
+            kernels::rowAxpy(next_in->batchGradients[sampleIterator * nextWidth + outputIterator], row, &batchGradients[sampleIterator * width], width);
+          }
+        }
+      }
+      //Scale each sum by the derivative at the neuron's output
+      for (sampleIterator = begin_in; sampleIterator < end_in; ++sampleIterator) {
+        for (neuronIterator = 0; neuronIterator < width; ++neuronIterator) {
+          batchGradients[sampleIterator * width + neuronIterator] *= activation_in.derivative(batchRows[sampleIterator][neuronIterator]);
+        }
+      }
+    });
+  }
+
+  //Accumulates the weight gradients over the batch and applies a single update to each weight
+  template<class Optimizer> void Layer::updateInputWeightsBatch(Layer* previous_in, const Optimizer& optimizer_in, ThreadPool* pool_in)
+  {
+    if (sparse) {
+      throw std::runtime_error("Batched evaluation requires dense storage");
+    }
+    //An empty batch has no gradient to average
+    if (batchSize == 0) {
+      return;
+    }
+    if (precision == NEURAL_PRECISION_DOUBLE) {
+      updateInputWeightsBatchMatrix<Optimizer, double>(previous_in, optimizer_in, pool_in);
+    } else {
+      updateInputWeightsBatchMatrix<Optimizer, float>(previous_in, optimizer_in, pool_in);
+    }
+  }
+
+  //Sums gradient * input over the batch in double precision then stores each update as the matrix type
+  template<class Optimizer, class Weight> void Layer::updateInputWeightsBatchMatrix(Layer* previous_in, const Optimizer& optimizer_in, ThreadPool* pool_in)
+  {
+    weightGradients.resize((size_t) (neurons.size() - bias) * inputs);
+
+    //Rows of weights are independent so each thread sums and updates a block of them
+    split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+      sumWeightGradientRows(previous_in, begin_in, end_in, weightGradients.data());
+      applyWeightGradientRows<Optimizer, Weight>(weightGradients.data(), batchSize, optimizer_in, begin_in, end_in);
+    });
+  }
+
+  //Applies one update to each weight from gradients summed over a batch
+  template<class Optimizer> void Layer::applyWeightGradients(const double* sums_in, unsigned samples_in, const Optimizer& optimizer_in, ThreadPool* pool_in)
+  {
+    if (! dense || sparse) {
+      throw std::runtime_error("Batched evaluation requires dense storage");
+    }
+    //An empty batch has no gradient to average
+    if (samples_in == 0) {
+      return;
+    }
+    //Rows of weights are independent so each thread takes a block of them
+    split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+      if (precision == NEURAL_PRECISION_DOUBLE) {
+        applyWeightGradientRows<Optimizer, double>(sums_in, samples_in, optimizer_in, begin_in, end_in);
+      } else {
+        applyWeightGradientRows<Optimizer, float>(sums_in, samples_in, optimizer_in, begin_in, end_in);
+      }
+    });
+  }
+
+  //Applies one update per weight with the mean gradient as if the input were 1
+  template<class Optimizer, class Weight> void Layer::applyWeightGradientRows(const double* sums_in, unsigned samples_in, const Optimizer& optimizer_in, unsigned begin_in, unsigned end_in)
+  {
+    Weight* rows;
+    Weight* deltaRows;
+    size_t weightIterator;
+    double newDeltaWeight;
+
+    rows = matrix<Weight>();
+    deltaRows = deltaMatrix<Weight>();
+    for (weightIterator = (size_t) begin_in * inputs; weightIterator < (size_t) end_in * inputs; ++weightIterator) {
+      newDeltaWeight = optimizer_in.delta(sums_in[weightIterator] / samples_in, rows[weightIterator], deltaRows[weightIterator], 1.0);
+      deltaRows[weightIterator] = newDeltaWeight;
+      rows[weightIterator] += newDeltaWeight;
+    }
+  }
+
+  //Gathers each compressed row against the previous layer's outputs
+  template<class Activation> void Layer::feedForwardSparse(const double* values_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    if (! pendingConnections.empty()) {
+      compressSparse();
+    }
+    //Each thread takes a block of rows
+    split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+      unsigned neuronIterator;
+      unsigned start;
+
+      for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+        start = rowStarts[neuronIterator];
+        outputs[neuronIterator] = activation_in.value(kernels::dotSparse(weights.data() + start, columns.data() + start, values_in, rowStarts[neuronIterator + 1] - start));
+      }
+    });
+  }
+
+  //Gathers each column of the next layer's transposed matrix against its gradients
+  template<class Activation> void Layer::calculateHiddenGradientsSparse(Layer* next_in, const Activation& activation_in, ThreadPool* pool_in)
+  {
+    if (! next_in->pendingConnections.empty()) {
+      next_in->compressSparse();
+    }
+    //Columns are independent in the transpose so each thread takes a block of them
+    split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+      unsigned neuronIterator;
+      unsigned start;
+
+      for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+        start = next_in->columnStarts[neuronIterator];
+        gradients[neuronIterator] = kernels::dotSparse(next_in->transposeWeights.data() + start, next_in->transposeRows.data() + start, next_in->gradients.data(), next_in->columnStarts[neuronIterator + 1] - start) * activation_in.derivative(outputs[neuronIterator]);
+      }
+    });
+  }
+
+  //Updates each sparse entry one row at a time and mirrors the new weight into the transpose
+  template<class Optimizer> void Layer::updateInputWeightsSparse(Layer* previous_in, const Optimizer& optimizer_in, ThreadPool* pool_in)
+  {
+    const double* values;
+
+    if (! pendingConnections.empty()) {
+      compressSparse();
+    }
+    values = &previous_in->outputs[0];
+    //Each thread takes a block of rows, their entries in the transpose never overlap
+    split(pool_in, neurons.size() - bias, [&](unsigned begin_in, unsigned end_in) {
+      unsigned neuronIterator;
+      unsigned entryIterator;
+      double gradient;
+      double newDeltaWeight;
+
+      for (neuronIterator = begin_in; neuronIterator < end_in; ++neuronIterator) {
+        gradient = gradients[neuronIterator];
+        for (entryIterator = rowStarts[neuronIterator]; entryIterator < rowStarts[neuronIterator + 1]; ++entryIterator) {
+          //Calculate new deltaweight then store it and update the weight
+          newDeltaWeight = optimizer_in.delta(gradient, weights[entryIterator], deltaWeights[entryIterator], values[columns[entryIterator]]);
+          deltaWeights[entryIterator] = newDeltaWeight;
+          weights[entryIterator] += newDeltaWeight;
+          transposeWeights[transposeSlots[entryIterator]] = weights[entryIterator];
+        }
+      }
+    });
+  }
 }
 
-#endif
\ No newline at end of file
+#endif
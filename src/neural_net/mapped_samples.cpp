@@ -0,0 +1,161 @@
+//Binary sample file that is memory mapped and batched in place
+#include "mapped_samples.hpp"
+
+namespace neural
+{
+  //Maps a binary sample file and draws the first epoch's order
+  MappedSamples::MappedSamples(const char* path_in, unsigned batch_in, uint64_t seed_in)
+    : generator(seed_in)
+  {
+    int descriptor;
+    struct stat status;
+    uint64_t sampleIterator;
+    void* mapping;
+    uint64_t record;
+
+    if (batch_in == 0) {
+      throw std::runtime_error("Batches need at least one sample");
+    }
+    batchSize = batch_in;
+
+    //Open the file and find its size
+    descriptor = open(path_in, O_RDONLY);
+    if (descriptor < 0) {
+      throw std::runtime_error("Unable to open binary samples");
+    }
+    if (fstat(descriptor, &status) != 0 || (size_t) status.st_size < sizeof(sample_header)) {
+      close(descriptor);
+      throw std::runtime_error("Binary sample file is too small");
+    }
+    size = status.st_size;
+
+    //Samples are only read, so the pages can be dropped and read again whenever memory is short
+    mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (mapping == MAP_FAILED) {
+      throw std::runtime_error("Unable to map binary samples");
+    }
+    data = (char*) mapping;
+    header = (const sample_header*) data;
+
+    //Check to make sure the file is valid
+    try {
+      SampleReader::checkHeader(header);
+      //The last sample must end inside the file, checked by division so a crafted count or stride can not wrap
+      record = (uint64_t) (header->inputs + header->targets) * header->scalarSize;
+      if (header->samples > 0 && (header->offset > size || size - header->offset < record || header->samples - 1 > (size - header->offset - record) / header->stride)) {
+        throw std::runtime_error("Binary sample file is shorter than its header says");
+      }
+    } catch (...) {
+      munmap(data, size);
+      throw;
+    }
+    //Samples are visited in random order, so reading ahead of each one would be wasted
+    madvise(data, size, MADV_RANDOM);
+
+    //Doubles can be summed straight from the mapping when every one sits on a double boundary
+    inPlace = header->scalarSize == sizeof(double) && header->offset % sizeof(double) == 0 && header->stride % sizeof(double) == 0;
+    if (! inPlace) {
+      widened.resize((size_t) batchSize * (header->inputs + header->targets));
+    }
+    inputs.resize(batchSize);
+    targets.resize(batchSize);
+    batch.inputs = inputs.data();
+    batch.targets = targets.data();
+    batch.samples = 0;
+
+    order.resize(header->samples);
+    for (sampleIterator = 0; sampleIterator < header->samples; ++sampleIterator) {
+      order[sampleIterator] = sampleIterator;
+    }
+    restart();
+  }
+
+  //Unmaps the file
+  MappedSamples::~MappedSamples()
+  {
+    munmap(data, size);
+  }
+
+  //Returns the start of a sample in the mapping
+  const char* MappedSamples::sample(uint64_t sample_in) const
+  {
+    return data + header->offset + sample_in * header->stride;
+  }
+
+  //Asks the kernel to start reading the pages of a batch
+  void MappedSamples::prefetch(uint64_t first_in)
+  {
+    uint64_t sampleIterator;
+    uintptr_t page;
+    uintptr_t start;
+    uintptr_t end;
+
+    page = sysconf(_SC_PAGESIZE);
+    for (sampleIterator = first_in; sampleIterator < first_in + batchSize && sampleIterator < order.size(); ++sampleIterator) {
+      start = (uintptr_t) sample(order[sampleIterator]) / page * page;
+      end = (uintptr_t) sample(order[sampleIterator]) + (uint64_t) (header->inputs + header->targets) * header->scalarSize;
+      madvise((void*) start, end - start, MADV_WILLNEED);
+    }
+  }
+
+  //Takes the next batch of the epoch
+  const sample_batch* MappedSamples::next()
+  {
+    unsigned sampleIterator;
+    unsigned valueIterator;
+    unsigned width;
+    const float* values;
+    double* row;
+
+    if (position >= order.size()) {
+      return NULL;
+    }
+    batch.samples = order.size() - position < batchSize ? order.size() - position : batchSize;
+
+    //Point each row at its sample, widening float samples into the batch
+    width = header->inputs + header->targets;
+    for (sampleIterator = 0; sampleIterator < batch.samples; ++sampleIterator) {
+      if (inPlace) {
+        inputs[sampleIterator] = (const double*) sample(order[position + sampleIterator]);
+      } else {
+        row = &widened[(size_t) sampleIterator * width];
+        if (header->scalarSize == sizeof(float)) {
+          values = (const float*) sample(order[position + sampleIterator]);
+          for (valueIterator = 0; valueIterator < width; ++valueIterator) {
+            row[valueIterator] = values[valueIterator];
+          }
+        } else {
+          memcpy(row, sample(order[position + sampleIterator]), (size_t) width * sizeof(double));
+        }
+        inputs[sampleIterator] = row;
+      }
+      targets[sampleIterator] = inputs[sampleIterator] + header->inputs;
+    }
+    position += batch.samples;
+
+    //Start paging in the next batch while this one trains
+    prefetch(position);
+    return &batch;
+  }
+
+  //Draws a new order and starts another epoch
+  void MappedSamples::restart()
+  {
+    uint64_t sampleIterator;
+    uint64_t swap;
+
+    //Fisher-Yates over the indices, the samples themselves never move
+    for (sampleIterator = order.size(); sampleIterator > 1; --sampleIterator) {
+      swap = generator() % sampleIterator;
+      std::swap(order[sampleIterator - 1], order[swap]);
+    }
+    position = 0;
+    prefetch(position);
+  }
+
+  unsigned long long MappedSamples::numSamples() const { return header->samples; }
+  unsigned MappedSamples::numInputs() const { return header->inputs; }
+  unsigned MappedSamples::numTargets() const { return header->targets; }
+  unsigned MappedSamples::getBatchSize() const { return batchSize; }
+}
@@ -0,0 +1,114 @@
+/***********************************************************
+* Binary sample file that is memory mapped and batched in place
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*   - Checked the size of the file without overflowing
+*
+* Maps a NEURAL_SAMPLES_BINARY file (see sample_reader.hpp) read
+*   only and shuffles it by drawing a permutation of the sample
+*   indices each epoch, so nothing is read or moved to shuffle and
+*   files larger than memory are paged in by the kernel as their
+*   samples come up. Each batch is a set of row pointers: into the
+*   mapping itself for files stored as doubles, or into one batch
+*   of widened values for files stored as floats. The pages of the
+*   following batch are requested from the kernel while the current
+*   batch trains.
+***********************************************************/
+
+#ifndef _H_NEURAL_MAPPED_SAMPLES
+#define _H_NEURAL_MAPPED_SAMPLES
+
+#include <stdint.h>    //uint64_t    uintptr_t
+#include <vector>      //std::vector
+#include <random>      //std::mt19937_64
+#include <utility>     //std::swap()
+#include <stdexcept>   //std::runtime_error
+#include <string.h>    //memcpy()
+#include <sys/mman.h>  //mmap()    munmap()    madvise()
+#include <sys/stat.h>  //fstat()
+#include <fcntl.h>     //open()
+#include <unistd.h>    //close()    sysconf()
+
+#include "sample_data.hpp"
+#include "sample_reader.hpp"
+#include "dataset.hpp"
+
+namespace neural
+{
+  class MappedSamples
+  {
+  private:
+    /* Start of the mapped file */
+    char* data;
+    /* Bytes mapped */
+    size_t size;
+    /* Header at the start of the mapping */
+    const sample_header* header;
+    /* Flags if the samples are doubles on double boundaries and are handed out in place */
+    unsigned inPlace;
+    /* Samples in each full batch */
+    unsigned batchSize;
+    /* Order the samples are handed out in this epoch */
+    std::vector<uint64_t> order;
+    /* Position in order of the next batch's first sample */
+    uint64_t position;
+    /* Draws each epoch's order */
+    std::mt19937_64 generator;
+    /* Location of each sample's inputs and targets in the current batch */
+    std::vector<const double*> inputs;
+    std::vector<const double*> targets;
+    /* Values of the current batch widened from floats, one row of inputs then targets per sample */
+    std::vector<double> widened;
+    /* Batch handed to the trainer */
+    sample_batch batch;
+
+    /*****************
+    * Returns the start of a sample in the mapping
+    * @param sample_in index of the sample in the file
+    *****************/
+    const char* sample(uint64_t sample_in) const;
+
+    /*****************
+    * Asks the kernel to start reading the pages of a batch
+    * @param first_in position in order of the batch's first sample
+    *****************/
+    void prefetch(uint64_t first_in);
+
+  public:
+    /*****************
+    * Maps a binary sample file and draws the first epoch's order
+    * @param path_in  location of the file
+    * @param batch_in samples in each batch, only the last batch of an epoch may be smaller
+    * @param seed_in  seed of the shuffle, the same seed gives the same batches
+    *****************/
+    MappedSamples(const char* path_in, unsigned batch_in, uint64_t seed_in = NEURAL_DATASET_SEED);
+
+    /*****************
+    * Unmaps the file
+    *****************/
+    ~MappedSamples();
+
+    /*****************
+    * Takes the next batch of the epoch
+    *   The batch's rows stay valid until the following call
+    * @return The batch, NULL once every sample of the epoch has been handed out
+    *****************/
+    const sample_batch* next();
+
+    /*****************
+    * Draws a new order and starts another epoch
+    *****************/
+    void restart();
+
+    unsigned long long numSamples() const;
+    unsigned numInputs() const;
+    unsigned numTargets() const;
+    unsigned getBatchSize() const;
+  };
+}
+
+#endif
@@ -1,32 +1,118 @@
 //Neural Network
 #include "network.hpp"
+#include "binary_model.hpp"
 
 namespace neural
 {
   //Creates a new Network
-  Network::Network() {}
+  Network::Network()
+  {
+    storage = NEURAL_STORAGE_GRAPH;
+    precision = NEURAL_PRECISION_DOUBLE;
+  }
 
   //Constructs a new instance of a Neural Network from the specified topology
-  Network::Network(const std::vector<unsigned> &topology_in, double (*activationFunction_in)(double), double (*activationFunctionDerivative_in)(double), double (*deltaInputWeight_in)(double, double, double, double))
+  Network::Network(const std::vector<unsigned> &topology_in, double (*activationFunction_in)(double), double (*activationFunctionDerivative_in)(double), double (*deltaInputWeight_in)(double, double, double, double), unsigned storage_in, unsigned precision_in, const Initializer& initializer_in, unsigned threads_in)
   {
     unsigned numLayers;
     unsigned layerIterator;
     unsigned neuronIterator;
+    unsigned fanOut;
 
     //Extract number of layers in network
     numLayers = topology_in.size();
+    storage = storage_in;
+    precision = precision_in;
+    if (storage != NEURAL_STORAGE_DENSE && precision != NEURAL_PRECISION_DOUBLE) {
+      throw std::runtime_error("Single and mixed precision require dense storage");
+    }
+    //The pool exists before any weight is drawn so the dense matrices are filled on it
+    setThreads(threads_in);
+
+    //Graph neurons point at each other, so every layer is placed before any is connected
+    layers.reserve(numLayers);
 
-    //Create the input layer with 1 bias Neuron
-    layers.push_back(Layer(topology_in[0], 1));
+    //Create the input layer with its bias Neurons
+    layers.push_back(Layer(topology_in[0], NEURAL_BIAS_NEURONS));
 
     //Create the layers of the netwok
     for (layerIterator = 1; layerIterator < numLayers; ++layerIterator) {
-      //Create the new layer
-      layers.push_back(Layer(1));
+      fanOut = layerIterator + 1 < numLayers ? topology_in[layerIterator + 1] : 0;
+      //Dense and sparse layers hold their connections in a weight matrix instead of the neurons
+      if (storage == NEURAL_STORAGE_DENSE || storage == NEURAL_STORAGE_SPARSE) {
+        layers.push_back(Layer(topology_in[layerIterator], NEURAL_BIAS_NEURONS));
+        layers.back().setInitializer(initializer_in.forLayer(layerIterator, layers[layerIterator - 1].numNeurons(), fanOut));
+        continue;
+      }
+      //Create the new layer with room for all of its neurons and connections
+      layers.push_back(Layer(NEURAL_BIAS_NEURONS));
+      layers.back().setInitializer(initializer_in.forLayer(layerIterator, layers[layerIterator - 1].numNeurons(), fanOut));
+      layers.back().reserveGraph(topology_in[layerIterator] + NEURAL_BIAS_NEURONS, layers[layerIterator - 1].numNeurons());
+      layers[layerIterator - 1].reserveOutputs(topology_in[layerIterator]);
       //Fill layer with neurons adding
       for (neuronIterator = 0; neuronIterator < topology_in[layerIterator]; ++neuronIterator) {
         layers.back().addNeuron(layers[layerIterator - 1].getNeurons(), 0);
       }
+      //Add the bias neurons after the regular neurons
+      for (neuronIterator = 0; neuronIterator < NEURAL_BIAS_NEURONS; ++neuronIterator) {
+        layers.back().addNeuron(1);
+      }
+    }
+
+    //Allocate the weight matrices once every layer has its final size
+    if (storage == NEURAL_STORAGE_DENSE) {
+      layers[0].makeDense(0);
+      for (layerIterator = 1; layerIterator < numLayers; ++layerIterator) {
+        layers[layerIterator].makeDense(layers[layerIterator - 1].numNeurons(), precision, pool.get());
+      }
+    }
+    //Sparse layers are filled in as connections are created, the input layer only needs its value arrays
+    if (storage == NEURAL_STORAGE_SPARSE) {
+      layers[0].makeDense(0);
+      for (layerIterator = 1; layerIterator < numLayers; ++layerIterator) {
+        layers[layerIterator].makeSparse(layers[layerIterator - 1].numNeurons());
+      }
+    }
+
+    //Bias neurons always fire the same value
+    for (layerIterator = 0; layerIterator < numLayers; ++layerIterator) {
+      layers[layerIterator].setBias(NEURAL_BIAS_VALUE);
+    }
+
+    //Store the networks activation function and it's derivative
+    activationFunction = activationFunction_in;
+    activationFunctionDerivative = activationFunctionDerivative_in;
+    //Store the function for reweiching connections
+    deltaInputWeight = deltaInputWeight_in;
+  }
+
+  //Constructs a dense Network whose weights are used in place from a mapped binary network
+  Network::Network(std::shared_ptr<BinaryModel> model_in, double (*activationFunction_in)(double), double (*activationFunctionDerivative_in)(double), double (*deltaInputWeight_in)(double, double, double, double))
+  {
+    unsigned layerIterator;
+
+    storage = NEURAL_STORAGE_DENSE;
+    precision = model_in->getPrecision();
+    model = model_in;
+
+    //Create each layer at the size stored in the file
+    for (layerIterator = 0; layerIterator < model->numLayers(); ++layerIterator) {
+      layers.push_back(Layer(model->numNeurons(layerIterator), NEURAL_BIAS_NEURONS));
+    }
+
+    //Point each layer at its weights inside the mapping
+    layers[0].makeDense(0);
+    for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
+      if (precision == NEURAL_PRECISION_DOUBLE) {
+        layers[layerIterator].makeDense(layers[layerIterator - 1].numNeurons(), model->getWeights(layerIterator), model->getDeltaWeights(layerIterator));
+      } else {
+        layers[layerIterator].makeDense(layers[layerIterator - 1].numNeurons(), model->getSingleWeights(layerIterator), model->getSingleDeltaWeights(layerIterator), precision);
+      }
+    }
+
+    //Bias neurons always fire the same value
+    for (layerIterator = 0; layerIterator < layers.size(); ++layerIterator) {
+      layers[layerIterator].setBias(NEURAL_BIAS_VALUE);
     }
 
     //Store the networks activation function and it's derivative
@@ -40,13 +126,20 @@ namespace neural
   void Network::feedForward(const std::vector<double> &values_in)
   {
     unsigned layerIterator;
+    std::chrono::steady_clock::time_point start;
 
     //Assign the specified values into the input neurons
     inputLayer()->setValues(values_in);
 
     //Forward propigate
     for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
-      layers[layerIterator].feedForward(activationFunction);
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
+      layers[layerIterator].feedForward(&layers[layerIterator - 1], activationFunction, pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_FORWARD, start, 0);
+      }
     }
   }
 
@@ -54,25 +147,208 @@ namespace neural
   void Network::backPropagation(const std::vector<double> &values_in)
   {
     unsigned layerIterator;
+    std::chrono::steady_clock::time_point start;
 
-    //Calculate overall error
-    error = outputLayer()->calculateError(values_in);
+    //The output layer's error and gradients are its gradient phase
+    if (profiler) {
+      start = std::chrono::steady_clock::now();
+    }
+    //Softmax outputs find the cross-entropy and their gradients together
+    if (outputLayer()->isSoftmax()) {
+      error = outputLayer()->calculateSoftmaxGradients(values_in);
+    } else {
+      //Calculate overall error
+      error = outputLayer()->calculateError(values_in);
 
-    //Calculate output layer gradients
-    outputLayer()->calculateOutputGradients(values_in, activationFunctionDerivative);
+      //Calculate output layer gradients
+      outputLayer()->calculateOutputGradients(values_in, activationFunctionDerivative);
+    }
+    if (profiler) {
+      profile(layers.size() - 1, NEURAL_PHASE_GRADIENTS, start, 0);
+    }
 
     //Calculate hidden layer gradients
     for (layerIterator = layers.size() - 2; layerIterator > 0; --layerIterator) {
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
       //Calculate the hidden gradients using the next layer
-      layers[layerIterator].calculateHiddenGradients(activationFunctionDerivative);
+      layers[layerIterator].calculateHiddenGradients(&layers[layerIterator + 1], activationFunctionDerivative, pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_GRADIENTS, start, 0);
+      }
     }
 
     //Update connection weights for neurons
     for (layerIterator = layers.size() - 1; layerIterator > 0; --layerIterator) {
-      layers[layerIterator].updateInputWeights(deltaInputWeight);
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
+      layers[layerIterator].updateInputWeights(&layers[layerIterator - 1], deltaInputWeight, pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_UPDATE, start, 0);
+      }
     }
   }
 
+  //Points a set of rows at consecutive samples of a row-major matrix
+  void Network::makeBatchRows(const std::vector<double> &values_in, unsigned width_in, unsigned samples_in, std::vector<const double*>* rows_in)
+  {
+    unsigned sampleIterator;
+
+    //Make sure the matrix holds every sample
+    if (values_in.size() < (size_t) width_in * samples_in) {
+      throw std::runtime_error("Batch is smaller than the number of samples");
+    }
+    rows_in->resize(samples_in);
+    for (sampleIterator = 0; sampleIterator < samples_in; ++sampleIterator) {
+      (*rows_in)[sampleIterator] = values_in.data() + sampleIterator * width_in;
+    }
+  }
+
+  //Forwards a batch of samples through the network
+  void Network::feedForwardBatch(const double* const* values_in, unsigned samples_in)
+  {
+    unsigned layerIterator;
+    std::chrono::steady_clock::time_point start;
+
+    if (storage != NEURAL_STORAGE_DENSE || hasSparseLayers()) {
+      throw std::runtime_error("Batched evaluation requires dense storage");
+    }
+    if (samples_in == 0) {
+      throw std::runtime_error("Batches need at least one sample");
+    }
+    //Read the input samples in place
+    inputLayer()->setBatchValues(values_in, samples_in);
+
+    //Forward propigate the whole batch one layer at a time
+    for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
+      layers[layerIterator].feedForwardBatch(&layers[layerIterator - 1], activationFunction, pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_FORWARD, start, 1);
+      }
+    }
+  }
+
+  //Forwards a batch of samples through the network
+  void Network::feedForwardBatch(const std::vector<double> &values_in, unsigned samples_in)
+  {
+    makeBatchRows(values_in, inputLayer()->numNeurons() - inputLayer()->numBias(), samples_in, &batchRows);
+    feedForwardBatch(batchRows.data(), samples_in);
+  }
+
+  //Back-propagates the last forwarded batch and applies one weight update for the whole batch
+  void Network::backPropagationBatch(const double* const* values_in)
+  {
+    unsigned layerIterator;
+    std::chrono::steady_clock::time_point start;
+
+    calculateBatchGradients(values_in);
+
+    //Apply the accumulated update once per weight
+    for (layerIterator = layers.size() - 1; layerIterator > 0; --layerIterator) {
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
+      layers[layerIterator].updateInputWeightsBatch(&layers[layerIterator - 1], deltaInputWeight, pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_UPDATE, start, 1);
+      }
+    }
+  }
+
+  //Finds the error and every layer's gradients for the last forwarded batch
+  void Network::calculateBatchGradients(const double* const* values_in)
+  {
+    unsigned layerIterator;
+    std::chrono::steady_clock::time_point start;
+
+    //The output layer's error and gradients are its gradient phase
+    if (profiler) {
+      start = std::chrono::steady_clock::now();
+    }
+    //Softmax outputs find the cross-entropy and their gradients together
+    if (outputLayer()->isSoftmax()) {
+      error = outputLayer()->calculateSoftmaxGradientsBatch(values_in);
+    } else {
+      //Calculate overall error
+      error = outputLayer()->calculateBatchError(values_in);
+
+      //Calculate output layer gradients
+      outputLayer()->calculateOutputGradientsBatch(values_in, activationFunctionDerivative);
+    }
+    if (profiler) {
+      profile(layers.size() - 1, NEURAL_PHASE_GRADIENTS, start, 1);
+    }
+
+    //Calculate hidden layer gradients
+    for (layerIterator = layers.size() - 2; layerIterator > 0; --layerIterator) {
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
+      layers[layerIterator].calculateHiddenGradientsBatch(&layers[layerIterator + 1], activationFunctionDerivative, pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_GRADIENTS, start, 1);
+      }
+    }
+  }
+
+  //Sums gradient * input over the last batch for every weight
+  void Network::sumBatchGradients(double* sums_out)
+  {
+    unsigned layerIterator;
+
+    for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
+      layers[layerIterator].sumWeightGradients(&layers[layerIterator - 1], sums_out, pool.get());
+      sums_out += layers[layerIterator].numConnections();
+    }
+  }
+
+  //Applies one update to every weight from summed gradients
+  void Network::applyBatchGradients(const double* sums_in, unsigned samples_in)
+  {
+    unsigned layerIterator;
+
+    if (samples_in == 0) {
+      throw std::runtime_error("Batches need at least one sample");
+    }
+
+    for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
+      layers[layerIterator].applyWeightGradients(sums_in, samples_in, deltaInputWeight, pool.get());
+      sums_in += layers[layerIterator].numConnections();
+    }
+  }
+
+  //Runs one mini-batch training step
+  void Network::trainBatch(const double* const* values_in, const double* const* targets_in, unsigned samples_in)
+  {
+    feedForwardBatch(values_in, samples_in);
+    backPropagationBatch(targets_in);
+  }
+
+  //Runs one mini-batch training step
+  void Network::trainBatch(const std::vector<double> &values_in, const std::vector<double> &targets_in, unsigned samples_in)
+  {
+    makeBatchRows(values_in, inputLayer()->numNeurons() - inputLayer()->numBias(), samples_in, &batchRows);
+    makeBatchRows(targets_in, outputLayer()->numNeurons() - outputLayer()->numBias(), samples_in, &targetRows);
+    trainBatch(batchRows.data(), targetRows.data(), samples_in);
+  }
+
+  //Runs one mini-batch training step on a batch of sample rows
+  void Network::trainBatch(const sample_batch* batch_in)
+  {
+    trainBatch(batch_in->inputs, batch_in->targets, batch_in->samples);
+  }
+
+  //Finds the results of the last forwarded batch
+  void Network::getBatchResults(std::vector<double> &resultValues_in)
+  {
+    outputLayer()->getBatchResults(&resultValues_in);
+  }
+
   //Finds results of the layer
   void Network::getResults(std::vector<double> &resultValues_in)
   {
@@ -85,11 +361,31 @@ namespace neural
     Neuron* source;
     Neuron* destination;
 
+    //Every connection between adjacent layers already exists in a dense matrix
+    if (storage == NEURAL_STORAGE_DENSE) {
+      if (destLayer_in != sourceLayer_in + 1) {
+        throw std::runtime_error("Dense storage only connects adjacent layers");
+      }
+      return;
+    }
+    //Sparse storage adds an entry with a random weight
+    if (storage == NEURAL_STORAGE_SPARSE) {
+      if (destLayer_in != sourceLayer_in + 1) {
+        throw std::runtime_error("Sparse storage only connects adjacent layers");
+      }
+      layers[destLayer_in].addConnection(destNeuron_in - 1, sourceNeuron_in - 1, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN());
+      return;
+    }
+
     source = layers[sourceLayer_in].getNeuron(sourceNeuron_in);
     destination = layers[destLayer_in].getNeuron(destNeuron_in);
 
-    //Create a connection between the source and destenation neurons
-    destination->addInput(source);
+    //The layers may already be connected, the existing connection keeps its weight
+    if (destination->findInput(source, sourceNeuron_in - 1) != NULL) {
+      return;
+    }
+    //Create a connection between the source and destenation neurons in the destination layer's arena
+    layers[destLayer_in].connect(source, destination, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN());
   }
 
   //Creates a connection between the specified neurons
@@ -97,25 +393,53 @@ namespace neural
   {
     Neuron* source;
     Neuron* destination;
+    Layer* destinationLayer;
+    Connection* existing;
 
-    //Get pointers to connected nodes
-    source = layers[connection_in.source.layer].getNeuron(connection_in.source.neuron);
-    destination = layers[connection_in.destination.layer].getNeuron(connection_in.destination.neuron);
+    //Dense storage keeps the connection as an entry in the destination layer's matrix
+    if (storage == NEURAL_STORAGE_DENSE) {
+      destinationLayer = &layers[connection_in.destination.layer];
+      if (connection_in.destination.layer != connection_in.source.layer + 1) {
+        throw std::runtime_error("Dense storage only connects adjacent layers");
+      }
+      if (connection_in.destination.neuron >= destinationLayer->numNeurons() - destinationLayer->numBias()) {
+        throw std::runtime_error("Bias neurons can not have inputs");
+      }
+      if (! std::isnan(connection_in.weight)) {
+        destinationLayer->setWeight(connection_in.destination.neuron, connection_in.source.neuron, connection_in.weight);
+      }
+      if (! std::isnan(connection_in.deltaWeight)) {
+        destinationLayer->setDeltaWeight(connection_in.destination.neuron, connection_in.source.neuron, connection_in.deltaWeight);
+      }
+      return;
+    }
+    //Sparse storage only keeps the connections that are created
+    if (storage == NEURAL_STORAGE_SPARSE) {
+      if (connection_in.destination.layer != connection_in.source.layer + 1) {
+        throw std::runtime_error("Sparse storage only connects adjacent layers");
+      }
+      layers[connection_in.destination.layer].addConnection(connection_in.destination.neuron, connection_in.source.neuron, connection_in.weight, connection_in.deltaWeight);
+      return;
+    }
 
-    //Create new connection
-    Connection newConnection(source, destination);
+    //Get pointers to connected nodes
+    source = layers[connection_in.source.layer].getNeuron(connection_in.source.neuron + 1);
+    destination = layers[connection_in.destination.layer].getNeuron(connection_in.destination.neuron + 1);
 
-    //If specified connection has weight store it
-    if (! std::isnan(connection_in.weight)) {
-      newConnection.setWeight(connection_in.weight);
-    }
-    //If specified neuron has delta weight store it
-    if (! std::isnan(connection_in.deltaWeight)) {
-      newConnection.setDeltaWeight(connection_in.deltaWeight);
+    //A connection the network was built with takes the given weights, a missing one keeps what it has
+    existing = destination->findInput(source, connection_in.source.neuron);
+    if (existing != NULL) {
+      if (! std::isnan(connection_in.weight)) {
+        existing->setWeight(connection_in.weight);
+      }
+      if (! std::isnan(connection_in.deltaWeight)) {
+        existing->setDeltaWeight(connection_in.deltaWeight);
+      }
+      return;
     }
 
-    //Add new connection to network
-    destination->addInput(&newConnection);
+    //Add new connection to the destination layer's arena, a missing weight is drawn and a missing delta weight 0
+    layers[connection_in.destination.layer].connect(source, destination, connection_in.weight, connection_in.deltaWeight);
   }
 
   //Modifies the values of a neuron to match the input values
@@ -125,6 +449,255 @@ namespace neural
     layers[neuron_in.neuron.layer].setNeuron(neuron_in);
   }
 
+  //Adds the cost of a range of layers to a report
+  void Network::measureLayers(unsigned first_in, unsigned last_in, unsigned before_in, prune_data* report_in)
+  {
+    unsigned long long connections;
+    unsigned long long bytes;
+    unsigned layerIterator;
+
+    connections = 0;
+    bytes = 0;
+    for (layerIterator = first_in; layerIterator < last_in; ++layerIterator) {
+      connections += layers[layerIterator].numConnections();
+      bytes += layers[layerIterator].weightBytes();
+    }
+    //Each connection is a multiply and an add in the forward pass
+    if (before_in) {
+      report_in->connectionsBefore = connections;
+      report_in->flopsBefore = 2 * connections;
+      report_in->bytesBefore = bytes;
+    } else {
+      report_in->connectionsAfter = connections;
+      report_in->flopsAfter = 2 * connections;
+      report_in->bytesAfter = bytes;
+    }
+  }
+
+  //Prunes a range of layers with one threshold and reports the cost before and after
+  void Network::pruneLayers(unsigned first_in, unsigned last_in, double threshold_in, prune_data* report_out)
+  {
+    unsigned layerIterator;
+    unsigned sparse;
+
+    if (storage == NEURAL_STORAGE_GRAPH) {
+      throw std::runtime_error("Pruning requires dense or sparse storage");
+    }
+    //Bring any pending sparse connections into the count
+    for (layerIterator = first_in; layerIterator < last_in; ++layerIterator) {
+      if (layers[layerIterator].isSparse()) {
+        layers[layerIterator].compressSparse();
+      }
+    }
+    if (report_out != NULL) {
+      measureLayers(first_in, last_in, 1, report_out);
+    }
+
+    for (layerIterator = first_in; layerIterator < last_in; ++layerIterator) {
+      layers[layerIterator].prune(threshold_in);
+    }
+    //Pruned layers hold double precision sparse matrices, the network only is one once every layer is
+    sparse = 1;
+    for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
+      sparse = sparse && layers[layerIterator].isSparse();
+    }
+    if (sparse) {
+      storage = NEURAL_STORAGE_SPARSE;
+      precision = NEURAL_PRECISION_DOUBLE;
+    }
+
+    if (report_out != NULL) {
+      measureLayers(first_in, last_in, 0, report_out);
+    }
+  }
+
+  //Removes every connection in the network whose weight is smaller in magnitude than a threshold
+  void Network::prune(double threshold_in, prune_data* report_out)
+  {
+    pruneLayers(1, layers.size(), threshold_in, report_out);
+  }
+
+  //Removes every connection into one layer whose weight is smaller in magnitude than a threshold
+  void Network::pruneLayer(unsigned layer_in, double threshold_in, prune_data* report_out)
+  {
+    if (layer_in < 2 || layer_in > layers.size()) {
+      throw std::runtime_error("Only layers after the input layer can be pruned");
+    }
+    pruneLayers(layer_in - 1, layer_in, threshold_in, report_out);
+  }
+
+  //Removes the smallest weights in the network until the requested share of a fully connected network is gone
+  void Network::pruneToSparsity(double sparsity_in, prune_data* report_out)
+  {
+    std::vector<double> magnitudes;
+    unsigned long long fullyConnected;
+    unsigned long long removed;
+    unsigned layerIterator;
+    double threshold;
+
+    if (sparsity_in < 0.0 || sparsity_in > 1.0) {
+      throw std::runtime_error("Sparsity must be between 0 and 1");
+    }
+    if (storage == NEURAL_STORAGE_GRAPH) {
+      throw std::runtime_error("Pruning requires dense or sparse storage");
+    }
+
+    //Gather every remaining weight and count what a fully connected network would hold
+    fullyConnected = 0;
+    for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
+      fullyConnected += (unsigned long long) (layers[layerIterator].numNeurons() - layers[layerIterator].numBias()) * layers[layerIterator].numInputs();
+      layers[layerIterator].getMagnitudes(&magnitudes);
+    }
+
+    //Connections already missing count towards the target
+    removed = (unsigned long long) (sparsity_in * fullyConnected);
+    if (removed <= fullyConnected - magnitudes.size()) {
+      threshold = 0.0;
+    } else if (removed - (fullyConnected - magnitudes.size()) >= magnitudes.size()) {
+      threshold = std::numeric_limits<double>::infinity();
+    } else {
+      //The smallest weight that is kept becomes the threshold
+      removed -= fullyConnected - magnitudes.size();
+      std::nth_element(magnitudes.begin(), magnitudes.begin() + removed, magnitudes.end());
+      threshold = magnitudes[removed];
+    }
+
+    pruneLayers(1, layers.size(), threshold, report_out);
+  }
+
+  //Makes the output layer a softmax over its sums trained on cross-entropy
+  void Network::setSoftmaxOutput(unsigned softmax_in)
+  {
+    outputLayer()->setSoftmax(softmax_in);
+  }
+
+  //Redraws every weight from an initializer and clears the delta weights
+  void Network::initializeWeights(const Initializer& initializer_in)
+  {
+    unsigned layerIterator;
+    unsigned fanOut;
+
+    for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
+      fanOut = layerIterator + 1 < layers.size() ? layers[layerIterator + 1].numNeurons() - layers[layerIterator + 1].numBias() : 0;
+      layers[layerIterator].setInitializer(initializer_in.forLayer(layerIterator, layers[layerIterator - 1].numNeurons(), fanOut));
+      layers[layerIterator].initializeWeights(pool.get());
+    }
+  }
+
+  //Turns per-layer profiling on or off
+  void Network::setProfiling(unsigned profiling_in)
+  {
+    if (profiling_in) {
+      profiler = std::make_shared<Profiler>(layers.size());
+    } else {
+      profiler.reset();
+    }
+  }
+
+  //Returns the costs recorded since profiling was turned on
+  Profiler* Network::getProfiler()
+  {
+    return profiler.get();
+  }
+
+  //Records one phase of one layer with the profiler
+  void Network::profile(unsigned layer_in, unsigned phase_in, std::chrono::steady_clock::time_point start_in, unsigned batch_in)
+  {
+    double seconds;
+    double samples;
+    double connections;
+    double flops;
+    double bytes;
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_in).count();
+    samples = batch_in ? layers[layer_in].getBatchSize() : 1;
+    connections = layers[layer_in].numConnections();
+    //Count the phase's inner loops, batches read the weights once for every sample
+    switch (phase_in) {
+    case NEURAL_PHASE_FORWARD:
+      flops = 2.0 * connections * samples;
+      bytes = layers[layer_in].weightBytes();
+      break;
+    case NEURAL_PHASE_GRADIENTS:
+      //Hidden gradients are summed back through the next layer's weights
+      if (layer_in + 1 < layers.size()) {
+        flops = 2.0 * layers[layer_in + 1].numConnections() * samples;
+        bytes = layers[layer_in + 1].weightBytes();
+      } else {
+        flops = 3.0 * (layers[layer_in].numNeurons() - layers[layer_in].numBias()) * samples;
+        bytes = 0.0;
+      }
+      break;
+    default:
+      flops = 5.0 * connections + (batch_in ? 2.0 * connections * samples : 0.0);
+      bytes = 4.0 * layers[layer_in].weightBytes();
+      break;
+    }
+    //A single sample reads everything for itself
+    if (! batch_in) {
+      bytes *= samples;
+    }
+    profiler->record(layer_in, phase_in, seconds, samples, flops, bytes);
+  }
+
+  //Copies the weights into a read-only network
+  FrozenNetwork Network::freeze()
+  {
+    return FrozenNetwork(this, activationFunction);
+  }
+
+  //Creates a network with its own values that trains this network's dense weights in place
+  Network Network::share()
+  {
+    Network copy;
+    unsigned layerIterator;
+
+    if (storage != NEURAL_STORAGE_DENSE || hasSparseLayers()) {
+      throw std::runtime_error("Only dense networks can share their weights");
+    }
+    copy.storage = storage;
+    copy.precision = precision;
+    //Keep any mapped file alive as long as the copy reads from it
+    copy.model = model;
+
+    //Create each layer at this network's size
+    for (layerIterator = 0; layerIterator < layers.size(); ++layerIterator) {
+      copy.layers.push_back(Layer(layers[layerIterator].numNeurons() - layers[layerIterator].numBias(), layers[layerIterator].numBias()));
+    }
+
+    //Point each layer at this network's weights, the values and gradients stay the copy's own
+    copy.layers[0].makeDense(0);
+    for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
+      if (precision == NEURAL_PRECISION_DOUBLE) {
+        copy.layers[layerIterator].makeDense(layers[layerIterator].numInputs(), layers[layerIterator].weightData(), layers[layerIterator].deltaWeightData());
+      } else {
+        copy.layers[layerIterator].makeDense(layers[layerIterator].numInputs(), layers[layerIterator].singleWeightData(), layers[layerIterator].singleDeltaWeightData(), precision);
+      }
+      copy.layers[layerIterator].setSoftmax(layers[layerIterator].isSoftmax());
+    }
+
+    //Bias neurons always fire the same value
+    for (layerIterator = 0; layerIterator < layers.size(); ++layerIterator) {
+      copy.layers[layerIterator].setBias(NEURAL_BIAS_VALUE);
+    }
+
+    copy.activationFunction = activationFunction;
+    copy.activationFunctionDerivative = activationFunctionDerivative;
+    copy.deltaInputWeight = deltaInputWeight;
+    return copy;
+  }
+
+  //Sets how many threads evaluate each layer
+  void Network::setThreads(unsigned threads_in, unsigned threshold_in)
+  {
+    //A single thread needs no pool
+    if (threads_in <= 1) {
+      pool.reset();
+      return;
+    }
+    pool = std::make_shared<ThreadPool>(threads_in, threshold_in);
+  }
+
   //Returns a pointer to the a requested layer
   Layer* Network::getLayer(unsigned layer_in)
   {
@@ -132,6 +705,23 @@ namespace neural
   }
 
   unsigned Network::numLayers() { return layers.size(); }
-  Layer* Network::outputLayer() { return &layers.front(); }
-  Layer* Network::inputLayer() { return &layers.back(); }
+  //Checks for layers pruned into sparse matrices
+  unsigned Network::hasSparseLayers() const
+  {
+    unsigned layerIterator;
+
+    for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
+      if (layers[layerIterator].isSparse()) {
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+  unsigned Network::getStorage() const { return storage; }
+  unsigned Network::getPrecision() const { return precision; }
+  unsigned Network::numThreads() const { return pool ? pool->numThreads() : 1; }
+  double Network::getError() const { return error; }
+  Layer* Network::outputLayer() { return &layers.back(); }
+  Layer* Network::inputLayer() { return &layers.front(); }
 }
\ No newline at end of file
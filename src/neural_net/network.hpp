@@ -6,6 +6,25 @@
 * 
 * Last Modified:
 *   March 14, 2015 - Made activation function constructor parameter
+*   October 17, 2026 - Added dense storage backend
+*   October 17, 2026 - Added mini-batch training
+*   October 17, 2026 - Added persistent thread pool for layer evaluation
+*   October 17, 2026 - Added construction from a mapped binary network
+*   October 17, 2026 - Opened members to the compile-time policy network
+*   October 17, 2026 - Added single and mixed precision dense weights
+*   October 17, 2026 - Added compressed sparse row storage
+*   October 17, 2026 - Added magnitude pruning
+*   October 17, 2026 - Added freezing into a read-only network
+*   October 17, 2026 - Added fused softmax and cross-entropy output
+*   October 17, 2026 - Drew initial weights from a seeded initializer
+*   October 17, 2026 - Added per-layer profiling of each phase
+*   October 17, 2026 - Added copies sharing the dense weights for lock-free training
+*   October 17, 2026 - Exposed summing and applying batch gradients for data-parallel training
+*   October 17, 2026 - Added training on a batch of sample rows
+*   October 17, 2026 - Kept the storage and precision of partly pruned networks
+*   October 17, 2026 - Made networks move-only so graph connections never point into another network
+*   October 17, 2026 - Refused empty batches
+*   October 17, 2026 - Drew the initial dense weights on the thread pool
 ***********************************************/
 
 #ifndef _H_NEURAL_NETWORK
@@ -13,20 +32,37 @@
 
 #include <vector>   //std::vector
 #include <cmath>    //std::isnan()
+#include <stdexcept> //std::runtime_error
+#include <memory>    //std::shared_ptr
+#include <chrono>    //std::chrono::steady_clock
 
 #include "layer.hpp"
 #include "neuron.hpp"
 #include "connection.hpp"
 #include "connection_data.hpp"
+#include "prune_data.hpp"
+#include "frozen_network.hpp"
+#include "thread_pool.hpp"
+#include "profiler.hpp"
+#include "sample_data.hpp"
 
 #define NEURAL_BIAS_NEURONS 1
 #define NEURAL_BIAS_VALUE   1.0
 
+//Neurons own their connections and are evaluated one at a time
+#define NEURAL_STORAGE_GRAPH 0
+//Each layer owns a row-major weight matrix and is evaluated as a matrix-vector product
+#define NEURAL_STORAGE_DENSE 1
+//Each layer owns a compressed sparse row matrix of only the connections that were created
+#define NEURAL_STORAGE_SPARSE 2
+
+class BinaryModel;
+
 namespace neural
 {
   class Network
   {
-  private:
+  protected:
     /* Layers of Neurons in the network */
     std::vector<Layer> layers;
     /* Function used when neurons fire */
@@ -35,8 +71,58 @@ namespace neural
     double (*activationFunctionDerivative)(double);
     /* Function to reweigh neuron connections */
     double (*deltaInputWeight)(double, double, double, double);
-    /* Error of the network */
+    /* Root mean square error of the last back propagation, or mean cross-entropy with a softmax output */
     double error;
+    /* How the layers store their neurons and connections */
+    unsigned storage;
+    /* NEURAL_PRECISION_* of the dense weights */
+    unsigned precision;
+    /* Mapped file the dense weights live in, NULL when the layers own their weights */
+    std::shared_ptr<BinaryModel> model;
+    /* Threads each layer's neurons are split between, NULL when running serially */
+    std::shared_ptr<ThreadPool> pool;
+    /* Cost of each phase of each layer, NULL when profiling is off */
+    std::shared_ptr<Profiler> profiler;
+    /* Location of each sample of the current batch's input values */
+    std::vector<const double*> batchRows;
+    /* Location of each sample of the current batch's target values */
+    std::vector<const double*> targetRows;
+
+    /***********************
+    * Points a set of rows at consecutive samples of a row-major matrix
+    * @param values_in  row-major matrix with one sample per row
+    * @param width_in   values in each sample
+    * @param samples_in number of samples
+    * @param rows_in    location to store the row pointers
+    ***********************/
+    void makeBatchRows(const std::vector<double> &values_in, unsigned width_in, unsigned samples_in, std::vector<const double*>* rows_in);
+
+    /***********************
+    * Records one phase of one layer with the profiler, only called when profiling is on
+    * @param layer_in Index of the layer that ran
+    * @param phase_in NEURAL_PHASE_* that ran
+    * @param start_in Time the phase started
+    * @param batch_in 1 if the phase ran on the layer's current batch, 0 for a single sample
+    ***********************/
+    void profile(unsigned layer_in, unsigned phase_in, std::chrono::steady_clock::time_point start_in, unsigned batch_in);
+
+    /***********************
+    * Prunes a range of layers with one threshold and reports the cost before and after
+    * @param first_in     index of the first layer to prune, 1 is the first layer with weights
+    * @param last_in      index one past the last layer to prune
+    * @param threshold_in connections with an absolute weight below this are removed
+    * @param report_out   location to store the cost before and after, NULL if not needed
+    ***********************/
+    void pruneLayers(unsigned first_in, unsigned last_in, double threshold_in, prune_data* report_out);
+
+    /***********************
+    * Adds the cost of a range of layers to a report
+    * @param first_in  index of the first layer to count
+    * @param last_in   index one past the last layer to count
+    * @param before_in 1 to fill in the before counts, 0 for the after counts
+    * @param report_in report to fill in
+    ***********************/
+    void measureLayers(unsigned first_in, unsigned last_in, unsigned before_in, prune_data* report_in);
 
   public:
     /***********************
@@ -48,8 +134,31 @@ namespace neural
     * Constructs a new instance of a Neural Network from the specified topology
     * @param topology vector with each element pertaining to the amount of neuraons at level index
     * @param activationFunction Function to call on neuron data should return [-1...1]
+    * @param storage_in How layers store connections (NEURAL_STORAGE_*), sparse layers start without connections
+    * @param precision_in NEURAL_PRECISION_* of the dense weights, graph storage is always double precision
+    * @param initializer_in Distribution and seed the weights are drawn from, the same seed gives the same weights in every storage
+    * @param threads_in Threads the dense weights are drawn on and each layer is then split between, as setThreads
+    ***********************/
+    Network(const std::vector<unsigned> &topology_in, double (*activationFunction_in)(double), double (*activationFunctionDerivative_in)(double), double (*deltaInputWeight_in)(double, double, double, double), unsigned storage_in = NEURAL_STORAGE_GRAPH, unsigned precision_in = NEURAL_PRECISION_DOUBLE, const Initializer& initializer_in = Initializer(), unsigned threads_in = 1);
+
+    /***********************
+    * Moves a Network, the layers keep their neurons and connections
+    * @param network_in Network to move from, left empty
+    ***********************/
+    Network(Network&& network_in) = default;
+    Network& operator=(Network&& network_in) = default;
+
+    /* Graph neurons point into their layers' arenas, so copies are made with share() instead */
+    Network(const Network& network_in) = delete;
+    Network& operator=(const Network& network_in) = delete;
+
+    /***********************
+    * Constructs a dense Network whose weights are used in place from a mapped binary network
+    *   The network takes the precision the file was saved with
+    * @param model_in Mapped binary network, kept alive by the Network
+    * @param activationFunction Function to call on neuron data should return [-1...1]
     ***********************/
-    Network(const std::vector<unsigned> &topology_in, double (*activationFunction_in)(double), double (*activationFunctionDerivative_in)(double), double (*deltaInputWeight_in)(double, double, double, double));
+    Network(std::shared_ptr<BinaryModel> model_in, double (*activationFunction_in)(double), double (*activationFunctionDerivative_in)(double), double (*deltaInputWeight_in)(double, double, double, double));
 
     /***********************
     * Sets all the neurons to forward their values for computation at the next layer
@@ -63,6 +172,73 @@ namespace neural
     ***********************/
     void backPropagation(const std::vector<double> &values_in);    
 
+    /***********************
+    * Forwards a batch of samples through the network (dense storage only)
+    * @param values_in  values for the input neurons of each sample, read in place
+    * @param samples_in number of samples in the batch, at least one
+    ***********************/
+    void feedForwardBatch(const double* const* values_in, unsigned samples_in);
+
+    /***********************
+    * Forwards a batch of samples through the network (dense storage only)
+    * @param values_in  samples x inputs row-major matrix of input values
+    * @param samples_in number of samples in the batch, at least one
+    ***********************/
+    void feedForwardBatch(const std::vector<double> &values_in, unsigned samples_in);
+
+    /***********************
+    * Back-propagates the last forwarded batch and applies one weight update for the whole batch
+    * @param values_in values to test each sample against, read in place
+    ***********************/
+    void backPropagationBatch(const double* const* values_in);
+
+    /***********************
+    * Finds the error and every layer's gradients for the last forwarded batch without changing any weight
+    * @param values_in values to test each sample against, read in place
+    ***********************/
+    void calculateBatchGradients(const double* const* values_in);
+
+    /***********************
+    * Sums gradient * input over the last batch for every weight, after calculateBatchGradients
+    * @param sums_out location to store the sums, each layer's numConnections() one after another from the first hidden layer
+    ***********************/
+    void sumBatchGradients(double* sums_out);
+
+    /***********************
+    * Applies one update to every weight through deltaInputWeight from gradients summed over one or more batches
+    * @param sums_in    sums laid out as sumBatchGradients stores them
+    * @param samples_in number of samples the sums cover, at least one
+    ***********************/
+    void applyBatchGradients(const double* sums_in, unsigned samples_in);
+
+    /***********************
+    * Runs one mini-batch training step
+    * @param values_in  values for the input neurons of each sample
+    * @param targets_in values to test each sample against
+    * @param samples_in number of samples in the batch, at least one
+    ***********************/
+    void trainBatch(const double* const* values_in, const double* const* targets_in, unsigned samples_in);
+
+    /***********************
+    * Runs one mini-batch training step
+    * @param values_in  samples x inputs row-major matrix of input values
+    * @param targets_in samples x outputs row-major matrix of values to test against
+    * @param samples_in number of samples in the batch, at least one
+    ***********************/
+    void trainBatch(const std::vector<double> &values_in, const std::vector<double> &targets_in, unsigned samples_in);
+
+    /***********************
+    * Runs one mini-batch training step on a batch from a Dataset or MappedSamples
+    * @param batch_in rows of the batch's inputs and targets
+    ***********************/
+    void trainBatch(const sample_batch* batch_in);
+
+    /***********************
+    * Finds the results of the last forwarded batch
+    * @param resultValues_in location to store samples x outputs row-major result values
+    ***********************/
+    void getBatchResults(std::vector<double> &resultValues_in);
+
     /***********************
     * Finds the current results of the network
     * @param resultValues_in location to store result values
@@ -90,13 +266,96 @@ namespace neural
     **********************/
     void createConnection(connection_data& connection_in);
 
+    /**********************
+    * Removes every connection in the network whose weight is smaller in magnitude than a threshold
+    *   Pruned layers switch to sparse storage so removed connections cost nothing to evaluate or write
+    * @param threshold_in connections with an absolute weight below this are removed
+    * @param report_out   location to store the cost before and after, NULL if not needed
+    **********************/
+    void prune(double threshold_in, prune_data* report_out = NULL);
+
+    /**********************
+    * Removes every connection into one layer whose weight is smaller in magnitude than a threshold
+    *   The network keeps its storage and precision until every layer after the input has been pruned,
+    *   until then hasSparseLayers() and each layer's isSparse() tell which layers were converted
+    * @param layer_in     layer to prune, numbered as in getLayer() so the input layer 1 can not be pruned
+    * @param threshold_in connections with an absolute weight below this are removed
+    * @param report_out   location to store the cost of the layer before and after, NULL if not needed
+    **********************/
+    void pruneLayer(unsigned layer_in, double threshold_in, prune_data* report_out = NULL);
+
+    /**********************
+    * Removes the smallest weights in the network until the requested share of a fully connected network is gone
+    *   Weights tied at the cut off are all kept, so the result can fall slightly short of the target
+    * @param sparsity_in share of the fully connected network's connections to leave out [0...1]
+    * @param report_out  location to store the cost before and after, NULL if not needed
+    **********************/
+    void pruneToSparsity(double sparsity_in, prune_data* report_out = NULL);
+
+    /**********************
+    * Makes the output layer a softmax over its sums trained on cross-entropy (dense and sparse storage)
+    *   Outputs become class probabilities and the error becomes the cross-entropy, the activation function is
+    *   still used by the hidden layers
+    * @param softmax_in flags if the output layer is a softmax layer
+    **********************/
+    void setSoftmaxOutput(unsigned softmax_in);
+
+    /**********************
+    * Redraws every weight from an initializer and clears the delta weights, split between the threads of the pool
+    *   Weights depend only on the seed and their position, so any number of threads gives the same network
+    * @param initializer_in Distribution and seed to draw from
+    **********************/
+    void initializeWeights(const Initializer& initializer_in);
+
+    /**********************
+    * Turns per-layer profiling of the forward, gradient and update phases on or off
+    *   Turning it on starts every cost at 0, while off the passes only check that it is off
+    * @param profiling_in flags if the passes are profiled
+    **********************/
+    void setProfiling(unsigned profiling_in);
+
+    /**********************
+    * Returns the costs recorded since profiling was turned on, NULL when it is off
+    **********************/
+    Profiler* getProfiler();
+
+    /**********************
+    * Copies the weights into a read-only network that any number of threads can evaluate at once
+    *   Later training does not change the frozen copy
+    **********************/
+    FrozenNetwork freeze();
+
+    /**********************
+    * Creates a network with its own values and gradients that trains this network's dense weights in place
+    *   Each copy can run feedForward and backPropagation on its own thread while the weights are shared unlocked
+    *   The copy is only valid while this network keeps its weight arrays
+    **********************/
+    Network share();
+
+    /**********************
+    * Sets how many threads evaluate each layer
+    * @param threads_in   Threads to split each layer between, including the calling thread
+    * @param threshold_in Layers (or batches) with fewer items than this run on the calling thread
+    **********************/
+    void setThreads(unsigned threads_in, unsigned threshold_in = NEURAL_PARALLEL_THRESHOLD);
+
     /**********************
     * Returns a pointer to the a requested layer
     * @param layer_in layer top be retrieved
     **********************/
     Layer* getLayer(unsigned layer_in);
 
+    /**********************
+    * Checks for layers pruned into sparse matrices in a network otherwise stored densely
+    * @return 1 if any layer after the input is sparse
+    **********************/
+    unsigned hasSparseLayers() const;
+
     unsigned numLayers();
+    unsigned getStorage() const;
+    unsigned getPrecision() const;
+    unsigned numThreads() const;
+    double getError() const;
     Layer* outputLayer();
     Layer* inputLayer();
   };
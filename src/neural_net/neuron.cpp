@@ -10,13 +10,8 @@ namespace neural
   Neuron::Neuron(unsigned bias_in)
   {
     bias = bias_in;
-  }
-
-  //Creates a new neuron with the specified number of outputs
-  Neuron::Neuron(std::vector<Neuron>* inputs_in, unsigned bias_in)
-  {
-    addInputs(inputs_in);
-    bias = bias_in;
+    outputValue = 0.0;
+    gradient = 0.0;
   }
 
   //Modifies the value sof the neuron to match the input values
@@ -36,24 +31,29 @@ namespace neural
     }
   }
 
-  //Adds a collection of incoming connections to the Neuron
-  void Neuron::addInputs(std::vector<Neuron>* inputs_in)
+  //Sizes the input and output lists so connecting the neuron allocates them once
+  void Neuron::reserve(unsigned inputs_in, unsigned outputs_in)
   {
-    unsigned inputIterator;
-
-    //Create the connections to the neuron
-    for (inputIterator = 0; inputIterator < inputs_in->size(); ++inputIterator) {
-      addInput(&(*inputs_in)[inputIterator]);
-    }
+    inputs.reserve(inputs_in);
+    outputs.reserve(outputs_in);
   }
 
-  //Create a new input connection from the specified Neuron
-  void Neuron::addInput(Neuron* input_in)
+  //Moves the input and output connections held in an arena to a copy of that arena
+  void Neuron::rebase(const Connection* from_in, size_t length_in, Connection* to_in)
   {
-    //Create a new connection for the current input
-    Connection newConnection = Connection(input_in, this, makeWeight());
-    //Add new connection as input to node
-    addInput(&newConnection);
+    unsigned inputIterator;
+    unsigned outputIterator;
+
+    for (inputIterator = 0; inputIterator < inputs.size(); ++inputIterator) {
+      if (inputs[inputIterator] >= from_in && inputs[inputIterator] < from_in + length_in) {
+        inputs[inputIterator] = to_in + (inputs[inputIterator] - from_in);
+      }
+    }
+    for (outputIterator = 0; outputIterator < outputs.size(); ++outputIterator) {
+      if (outputs[outputIterator] >= from_in && outputs[outputIterator] < from_in + length_in) {
+        outputs[outputIterator] = to_in + (outputs[outputIterator] - from_in);
+      }
+    }
   }
 
   //Adds an incoming connection to the Neuron
@@ -64,15 +64,32 @@ namespace neural
     input_in->getStart()->addOutput(input_in);
   }
 
-  //Adds an outgoing connection to the Neuron
-  void Neuron::addOutput(Connection* output_in) {
-    outputs.push_back(*output_in);
+  //Finds the connection inputting to the Neuron from a source neuron
+  Connection* Neuron::findInput(const Neuron* source_in, unsigned hint_in) const
+  {
+    unsigned inputIterator;
+
+    //Inputs created in order sit at the source's own index
+    if (hint_in < inputs.size() && inputs[hint_in]->getStart() == source_in) {
+      return inputs[hint_in];
+    }
+    for (inputIterator = 0; inputIterator < inputs.size(); ++inputIterator) {
+      if (inputs[inputIterator]->getStart() == source_in) {
+        return inputs[inputIterator];
+      }
+    }
+    return NULL;
   }
 
-  //Generates a weight for a new neuron
-  double Neuron::makeWeight()
+  //Finds one of the connections inputting to the Neuron
+  Connection* Neuron::getInput(unsigned input_in) const
   {
-    return rand() / double(RAND_MAX);
+    return inputs[input_in];
+  }
+
+  //Adds an outgoing connection to the Neuron
+  void Neuron::addOutput(Connection* output_in) {
+    outputs.push_back(output_in);
   }
 
   void Neuron::feedForward(double (*activationFunction)(double))
@@ -108,10 +125,11 @@ namespace neural
     unsigned outputIterator;
     Connection* currentConnection;
     double sum;
-    
+
+    sum = 0.0;
     //Hit each of the Neuron's outputs
     for (outputIterator = 0; outputIterator < outputs.size(); ++outputIterator) {
-      currentConnection = &outputs[outputIterator];
+      currentConnection = outputs[outputIterator];
       //IF bias neurons are reached stop
       if (currentConnection->getEndpoint()->isBias()) {
         continue;
@@ -148,6 +166,7 @@ namespace neural
   }
 
   //Getters and setters
+  unsigned Neuron::numInputs() const { return inputs.size(); }
   unsigned Neuron::isBias() const { return bias; }
   double Neuron::getGradient() const { return gradient; }
   void Neuron::setGradient(double gradient_in) { gradient = gradient_in; }
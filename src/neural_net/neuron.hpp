@@ -6,13 +6,15 @@
 * 
 * Last Modified:
 *   March 15, 2015 - Made activation function a parameter instead of hardcoding
+*   October 17, 2026 - Moved connection allocation into the layer's arena
+*   October 17, 2026 - Outputs point at the receiving layer's connections instead of copying them
+*   October 17, 2026 - Added looking up and listing input connections
 ***********************************************/
 
 #ifndef _H_NEURAL_NEURON
 #define _H_NEURAL_NEURON
 
 #include <vector>    //std::vector
-#include <cstdlib>   //rand()
 #include <cmath>     //tanh()    std::isnan()
 
 #include "connection.hpp"
@@ -26,21 +28,15 @@ namespace neural
   private:
     /* Value of the neuron */
     double outputValue;
-    /* Connections that input to the Neuron */
+    /* Connections that input to the Neuron, owned by this neuron's layer */
     std::vector<Connection*> inputs;
-    /* Connections that output to the neuron */
-    std::vector<Connection> outputs;
+    /* Connections the neuron outputs to, the same connections the receiving neurons hold as inputs */
+    std::vector<Connection*> outputs;
     /* Value of the gradient for this Neuron */
     double gradient;
     /* Flags if this is a bias neuron */
     unsigned bias;
 
-    /****************
-    * Generates a weight for a new neuron
-    * @return new weight
-    ****************/
-    double makeWeight();
-
     /****************
     * Finds sum of derivitaves of weights for outputs
     * @return sum
@@ -54,13 +50,6 @@ namespace neural
     ****************/
     Neuron(unsigned bias_in);
 
-    /****************
-    * Creates a new neuron with the specified number of outputs
-    * @param inputs_in Intput paths for neuron
-    * @param bias_in flags if this neuron is a bias neuron
-    ****************/
-    Neuron(std::vector<Neuron>* inputs_in, unsigned bias_in);
-
     /***********************
     * Modifies the value sof the neuron to match the input values
     * @param neuron_in Vallues to match
@@ -68,26 +57,45 @@ namespace neural
     void setValues(neuron_data& neuron_in);
 
     /****************
-    * Adds a collection of incoming connections to the Neuron
-    * @param inputs_in Intput paths for neuron
+    * Sizes the input and output lists so connecting the neuron allocates them once
+    * @param inputs_in  Number of connections that will input to the neuron
+    * @param outputs_in Number of connections the neuron will output to
     ****************/
-    void addInputs(std::vector<Neuron>* inputs_in);
-    
+    void reserve(unsigned inputs_in, unsigned outputs_in);
+
     /****************
-    * Create a new input connection from the specified Neuron
-    * @param input_in Input connection to be added
+    * Moves the input and output connections held in an arena to a copy of that arena
+    *   Connections outside the arena are left alone
+    * @param from_in   Start of the arena
+    * @param length_in Number of connections in the arena
+    * @param to_in     Start of the copy of the arena
     ****************/
-    void addInput(Neuron* input_in);
-    
+    void rebase(const Connection* from_in, size_t length_in, Connection* to_in);
+
     /****************
-    * Adds an incoming connection to the Neuron
+    * Adds an incoming connection to the Neuron, the connection must outlive the neuron
     * @param input_in Input connection to be added
     ****************/
     void addInput(Connection* input_in);
 
     /****************
-    * Adds an outgoing connection to the Neuron
-    * @param outputon_in the connection to be added
+    * Finds the connection inputting to the Neuron from a source neuron
+    * @param source_in Neuron at the start of the connection
+    * @param hint_in   Input checked first, the source's place in its layer when the inputs were created in order
+    * @return The connection, NULL if the source does not input to the neuron
+    ****************/
+    Connection* findInput(const Neuron* source_in, unsigned hint_in) const;
+
+    /****************
+    * Finds one of the connections inputting to the Neuron
+    * @param input_in Index of the input, in the order they were added
+    * @return The connection
+    ****************/
+    Connection* getInput(unsigned input_in) const;
+
+    /****************
+    * Adds an outgoing connection to the Neuron, the connection must outlive the neuron
+    * @param output_in the connection to be added
     ****************/
     void addOutput(Connection* output_in);
 
@@ -127,6 +135,7 @@ namespace neural
     ****************/
     void getData(neuron_data* location_in);
 
+    unsigned numInputs() const;
     unsigned isBias() const;
     double getGradient() const;
     void setGradient(double gradient_in);
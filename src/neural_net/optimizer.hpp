@@ -0,0 +1,68 @@
+/***********************************************
+* Weight update policies resolved at compile time.
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified:
+*   October 17, 2026 - Created Initially
+***********************************************/
+
+#ifndef _H_NEURAL_OPTIMIZER
+#define _H_NEURAL_OPTIMIZER
+
+#include <ratio>   //std::ratio
+
+namespace neural
+{
+  namespace optimizer
+  {
+    /****************
+    * Every policy provides
+    *   delta(gradient, weight, deltaWeight, input) - change to apply to a connection's weight
+    * matching the deltaInputWeight function passed to a Network
+    ****************/
+
+    /****************
+    * Gradient descent with momentum
+    * @param Rate   std::ratio scaling the gradient
+    * @param Factor std::ratio of the previous change carried into the next
+    ****************/
+    template<class Rate = std::ratio<15, 100>, class Factor = std::ratio<1, 2> >
+    struct Momentum
+    {
+      static inline double delta(double gradient_in, double weight_in, double deltaWeight_in, double input_in)
+      {
+        return (double) Rate::num / Rate::den * input_in * gradient_in + (double) Factor::num / Factor::den * deltaWeight_in;
+      }
+    };
+
+    /****************
+    * Plain gradient descent
+    * @param Rate std::ratio scaling the gradient
+    ****************/
+    template<class Rate = std::ratio<15, 100> >
+    struct Descent
+    {
+      static inline double delta(double gradient_in, double weight_in, double deltaWeight_in, double input_in)
+      {
+        return (double) Rate::num / Rate::den * input_in * gradient_in;
+      }
+    };
+
+    /* Calls a weight update function through a pointer chosen at runtime */
+    struct Pointer
+    {
+      /* Function to reweigh neuron connections */
+      double (*deltaFunction)(double, double, double, double);
+
+      Pointer(double (*delta_in)(double, double, double, double)) : deltaFunction(delta_in) {}
+      inline double delta(double gradient_in, double weight_in, double deltaWeight_in, double input_in) const
+      {
+        return deltaFunction(gradient_in, weight_in, deltaWeight_in, input_in);
+      }
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,14 @@
+//Simple structure holding what one phase of one layer has cost since profiling started
+
+#ifndef _H_NEURAL_PROFILE_DATA
+#define _H_NEURAL_PROFILE_DATA
+
+typedef struct {
+  unsigned long long calls;   //Times the phase ran, a batch counts once
+  unsigned long long samples; //Samples the phase ran on, a batch counts each of its samples
+  double seconds;             //Wall time spent in the phase
+  double flops;               //Floating point operations of the phase's inner loops
+  double bytes;               //Bytes of weights, delta weights and indices the phase reads and writes
+} profile_data;
+
+#endif
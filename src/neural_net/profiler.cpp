@@ -0,0 +1,116 @@
+//Per-layer cost of the passes through a network
+#include "profiler.hpp"
+
+namespace neural
+{
+  /* Writes one phase's costs as a json object */
+  static void writePhase(FILE* file_out, const char* name_in, const profile_data& phase_in)
+  {
+    fprintf(file_out, "\"%s\":{\"calls\":%llu,\"samples\":%llu,\"seconds\":%.9g,\"flops\":%.17g,\"bytes\":%.17g,\"gflops_per_sec\":%.6g,\"gb_per_sec\":%.6g}",
+      name_in, phase_in.calls, phase_in.samples, phase_in.seconds, phase_in.flops, phase_in.bytes,
+      phase_in.seconds > 0.0 ? phase_in.flops / phase_in.seconds / 1e9 : 0.0,
+      phase_in.seconds > 0.0 ? phase_in.bytes / phase_in.seconds / 1e9 : 0.0);
+  }
+
+  //Creates a profiler with every cost at 0
+  Profiler::Profiler(unsigned layers_in)
+  {
+    entries.resize((size_t) layers_in * NEURAL_PHASES);
+    reset();
+  }
+
+  //Adds one run of a phase to a layer's costs
+  void Profiler::record(unsigned layer_in, unsigned phase_in, double seconds_in, unsigned samples_in, double flops_in, double bytes_in)
+  {
+    profile_data* entry;
+
+    entry = &entries[(size_t) layer_in * NEURAL_PHASES + phase_in];
+    ++entry->calls;
+    entry->samples += samples_in;
+    entry->seconds += seconds_in;
+    entry->flops += flops_in;
+    entry->bytes += bytes_in;
+  }
+
+  //Returns the costs of one phase of one layer
+  const profile_data& Profiler::get(unsigned layer_in, unsigned phase_in) const
+  {
+    if (layer_in >= numLayers() || phase_in >= NEURAL_PHASES) {
+      throw std::runtime_error("Profiled layer or phase out of range");
+    }
+    return entries[(size_t) layer_in * NEURAL_PHASES + phase_in];
+  }
+
+  //Returns the costs of one phase summed over every layer
+  profile_data Profiler::total(unsigned phase_in) const
+  {
+    profile_data sum;
+    unsigned layerIterator;
+
+    sum = entries[phase_in];
+    for (layerIterator = 1; layerIterator < numLayers(); ++layerIterator) {
+      sum.calls += get(layerIterator, phase_in).calls;
+      sum.samples += get(layerIterator, phase_in).samples;
+      sum.seconds += get(layerIterator, phase_in).seconds;
+      sum.flops += get(layerIterator, phase_in).flops;
+      sum.bytes += get(layerIterator, phase_in).bytes;
+    }
+    return sum;
+  }
+
+  //Sets every cost back to 0
+  void Profiler::reset()
+  {
+    size_t entryIterator;
+
+    for (entryIterator = 0; entryIterator < entries.size(); ++entryIterator) {
+      entries[entryIterator].calls = 0;
+      entries[entryIterator].samples = 0;
+      entries[entryIterator].seconds = 0.0;
+      entries[entryIterator].flops = 0.0;
+      entries[entryIterator].bytes = 0.0;
+    }
+  }
+
+  //Writes every cost as a json object
+  void Profiler::write(FILE* file_out) const
+  {
+    unsigned layerIterator;
+    unsigned phaseIterator;
+
+    fprintf(file_out, "{\"layers\":[");
+    //The input layer has no weights and never runs a phase
+    for (layerIterator = 1; layerIterator < numLayers(); ++layerIterator) {
+      fprintf(file_out, "%s{\"layer\":%u", layerIterator > 1 ? "," : "", layerIterator);
+      for (phaseIterator = 0; phaseIterator < NEURAL_PHASES; ++phaseIterator) {
+        fprintf(file_out, ",");
+        writePhase(file_out, phaseName(phaseIterator), get(layerIterator, phaseIterator));
+      }
+      fprintf(file_out, "}");
+    }
+    fprintf(file_out, "],\"total\":{");
+    for (phaseIterator = 0; phaseIterator < NEURAL_PHASES; ++phaseIterator) {
+      fprintf(file_out, "%s", phaseIterator > 0 ? "," : "");
+      writePhase(file_out, phaseName(phaseIterator), total(phaseIterator));
+    }
+    fprintf(file_out, "}}\n");
+  }
+
+  //Returns the json name of a phase
+  const char* Profiler::phaseName(unsigned phase_in)
+  {
+    switch (phase_in) {
+    case NEURAL_PHASE_FORWARD:
+      return "forward";
+    case NEURAL_PHASE_GRADIENTS:
+      return "gradients";
+    case NEURAL_PHASE_UPDATE:
+      return "update";
+    default:
+      return "unknown";
+    }
+  }
+
+  //Getters
+  unsigned Profiler::numLayers() const { return entries.size() / NEURAL_PHASES; }
+}
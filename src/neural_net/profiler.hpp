@@ -0,0 +1,104 @@
+/***********************************************************
+* Per-layer cost of the passes through a network
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*
+* Accumulates the wall time, floating point operations, bytes
+*   and calls of each phase of each layer. The network only
+*   reads the clock and records when it has a profiler, so a
+*   network without one pays a single branch per layer.
+*
+* Costs are counted per connection:
+*   forward   - 2 flops and the layer's weight bytes per sample
+*   gradients - 2 flops and the next layer's weight bytes per
+*               sample, the output layer counts 3 flops a neuron
+*   update    - 5 flops and 4 times the weight bytes (weights and
+*               delta weights read and written), batches add the
+*               2 flops per sample of accumulating the gradients
+*   Batched passes read the weights once per batch.
+***********************************************************/
+
+#ifndef _H_NEURAL_PROFILER
+#define _H_NEURAL_PROFILER
+
+#include <vector>      //std::vector
+#include <cstdio>      //FILE    fprintf()
+#include <stdexcept>   //std::runtime_error
+
+#include "profile_data.hpp"
+
+//Forward pass of a layer
+#define NEURAL_PHASE_FORWARD   0
+//Gradients of a layer's neurons, from the targets for the output layer or the next layer for hidden layers
+#define NEURAL_PHASE_GRADIENTS 1
+//Update of the weights into a layer
+#define NEURAL_PHASE_UPDATE    2
+//Number of phases
+#define NEURAL_PHASES          3
+
+namespace neural
+{
+  class Profiler
+  {
+  private:
+    /* Cost of every phase of every layer, NEURAL_PHASES entries per layer */
+    std::vector<profile_data> entries;
+
+  public:
+    /***********************
+    * Creates a profiler with every cost at 0
+    * @param layers_in Number of layers in the network, including the input layer
+    ***********************/
+    Profiler(unsigned layers_in);
+
+    /***********************
+    * Adds one run of a phase to a layer's costs
+    * @param layer_in   Index of the layer, 0 is the input layer
+    * @param phase_in   NEURAL_PHASE_* that ran
+    * @param seconds_in Wall time of the run
+    * @param samples_in Samples in the run
+    * @param flops_in   Floating point operations of the run
+    * @param bytes_in   Bytes the run read and wrote
+    ***********************/
+    void record(unsigned layer_in, unsigned phase_in, double seconds_in, unsigned samples_in, double flops_in, double bytes_in);
+
+    /***********************
+    * Returns the costs of one phase of one layer
+    * @param layer_in Index of the layer, 0 is the input layer
+    * @param phase_in NEURAL_PHASE_* to return
+    ***********************/
+    const profile_data& get(unsigned layer_in, unsigned phase_in) const;
+
+    /***********************
+    * Returns the costs of one phase summed over every layer
+    * @param phase_in NEURAL_PHASE_* to sum
+    ***********************/
+    profile_data total(unsigned phase_in) const;
+
+    /***********************
+    * Sets every cost back to 0
+    ***********************/
+    void reset();
+
+    /***********************
+    * Writes every cost as a json object, one entry per layer with weights followed by the totals
+    *   Each phase also holds its achieved gflops_per_sec and gb_per_sec
+    * @param file_out File to write to
+    ***********************/
+    void write(FILE* file_out) const;
+
+    /***********************
+    * Returns the json name of a phase
+    * @param phase_in NEURAL_PHASE_* to name
+    ***********************/
+    static const char* phaseName(unsigned phase_in);
+
+    unsigned numLayers() const;
+  };
+}
+
+#endif
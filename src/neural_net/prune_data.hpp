@@ -0,0 +1,15 @@
+//Simple structure to report the cost of a network before and after pruning
+
+#ifndef _H_NEURAL_PRUNE_DATA
+#define _H_NEURAL_PRUNE_DATA
+
+typedef struct {
+  unsigned long long connectionsBefore; //Connections before pruning
+  unsigned long long connectionsAfter;  //Connections left after pruning
+  unsigned long long flopsBefore;       //Floating point operations of one forward pass before pruning
+  unsigned long long flopsAfter;        //Floating point operations of one forward pass after pruning
+  unsigned long long bytesBefore;       //Bytes of weights and indices one forward pass reads before pruning
+  unsigned long long bytesAfter;        //Bytes of weights and indices one forward pass reads after pruning
+} prune_data;
+
+#endif
@@ -0,0 +1,26 @@
+//Simple structures describing the layout of a quantized network file
+
+#ifndef _H_NEURAL_QUANTIZED_DATA
+#define _H_NEURAL_QUANTIZED_DATA
+
+#include <stdint.h>   //uint32_t    uint64_t
+
+typedef struct {
+  char magic[8];          //Identifies the file as a quantized network
+  uint32_t version;       //Version of the layout
+  uint32_t layers;        //Number of layers in the network
+  uint32_t bias;          //Bias neurons at the end of every layer
+  uint32_t granularity;   //NEURAL_QUANTIZE_* the weight scales were chosen for
+  uint32_t softmax;       //Whether the output layer is a softmax, 0 in older files
+  uint32_t flags;         //Zero, reserved
+  uint64_t reserved[2];   //Zero, pads the header to 48 bytes
+} quantized_header;
+
+typedef struct {
+  uint32_t neurons;       //Non-bias neurons in the layer
+  uint32_t inputs;        //Non-bias neurons in the previous layer, 0 for the input layer
+  uint32_t stride;        //Bytes in each padded row of weights
+  float inputScale;       //Value of one step of the layer's 8 bit inputs
+} quantized_layer;
+
+#endif
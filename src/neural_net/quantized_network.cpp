@@ -0,0 +1,269 @@
+//Network quantized to 8 bit integers for inference
+#include "quantized_network.hpp"
+
+namespace neural
+{
+  //Quantizes a trained dense or sparse network
+  QuantizedNetwork::QuantizedNetwork(Network* network_in, const std::vector<std::vector<double> > &calibration_in, double (*activationFunction_in)(double), unsigned granularity_in)
+  {
+    unsigned layerIterator;
+    unsigned sampleIterator;
+    unsigned neuronIterator;
+    unsigned inputIterator;
+    unsigned inputs;
+    Layer* layer;
+    std::vector<double> largest;
+    std::vector<double> results;
+    std::vector<double> rowWeights;
+    double scale;
+
+    //Quantization reads the weights back from the layer arrays
+    if (network_in->getStorage() == NEURAL_STORAGE_GRAPH) {
+      throw std::runtime_error("Quantization requires dense or sparse storage");
+    }
+    if (calibration_in.empty()) {
+      throw std::runtime_error("Quantization requires calibration samples");
+    }
+    if (granularity_in != NEURAL_QUANTIZE_PER_ROW && granularity_in != NEURAL_QUANTIZE_PER_LAYER) {
+      throw std::runtime_error("Unsupported quantization granularity");
+    }
+    activationFunction = activationFunction_in;
+    granularity = granularity_in;
+    softmax = network_in->outputLayer()->isSoftmax();
+
+    //Find the largest value each layer sends on over the calibration samples
+    largest.assign(network_in->numLayers(), 0);
+    for (sampleIterator = 0; sampleIterator < calibration_in.size(); ++sampleIterator) {
+      network_in->feedForward(calibration_in[sampleIterator]);
+      for (layerIterator = 0; layerIterator + 1 < network_in->numLayers(); ++layerIterator) {
+        network_in->getLayer(layerIterator + 1)->getResults(&results);
+        for (neuronIterator = 0; neuronIterator < results.size(); ++neuronIterator) {
+          largest[layerIterator] = std::max(largest[layerIterator], std::fabs(results[neuronIterator]));
+        }
+      }
+    }
+
+    //The input layer only has a size
+    topology.push_back(network_in->inputLayer()->numNeurons() - NEURAL_BIAS_NEURONS);
+    strides.push_back(0);
+    inputScales.push_back(0);
+    weights.push_back(std::vector<int8_t>());
+    rowScales.push_back(std::vector<float>());
+    offsets.push_back(std::vector<float>());
+
+    for (layerIterator = 1; layerIterator < network_in->numLayers(); ++layerIterator) {
+      layer = network_in->getLayer(layerIterator + 1);
+      inputs = topology.back();
+      topology.push_back(layer->numNeurons() - NEURAL_BIAS_NEURONS);
+      strides.push_back(align(inputs));
+      //A layer that never saw a non-zero input can use any scale
+      inputScales.push_back(largest[layerIterator - 1] > 0 ? largest[layerIterator - 1] / NEURAL_QUANTIZED_RANGE : 1);
+      weights.push_back(std::vector<int8_t>((size_t) topology.back() * strides.back(), 0));
+      rowScales.push_back(std::vector<float>(topology.back(), 0));
+      offsets.push_back(std::vector<float>(topology.back(), 0));
+
+      //Per layer scales come from the largest weight in the whole layer
+      scale = 0;
+      if (granularity == NEURAL_QUANTIZE_PER_LAYER) {
+        for (neuronIterator = 0; neuronIterator < topology.back(); ++neuronIterator) {
+          for (inputIterator = 0; inputIterator < inputs; ++inputIterator) {
+            scale = std::max(scale, std::fabs(layer->getWeight(neuronIterator, inputIterator)));
+          }
+        }
+      }
+
+      for (neuronIterator = 0; neuronIterator < topology.back(); ++neuronIterator) {
+        //Copy the row out once, sparse lookups are searches
+        rowWeights.resize(inputs);
+        for (inputIterator = 0; inputIterator < inputs; ++inputIterator) {
+          rowWeights[inputIterator] = layer->getWeight(neuronIterator, inputIterator);
+        }
+        //Per row scales come from the largest weight in the row
+        if (granularity == NEURAL_QUANTIZE_PER_ROW) {
+          scale = 0;
+          for (inputIterator = 0; inputIterator < inputs; ++inputIterator) {
+            scale = std::max(scale, std::fabs(rowWeights[inputIterator]));
+          }
+        }
+        rowScales.back()[neuronIterator] = scale > 0 ? scale / NEURAL_QUANTIZED_RANGE : 1;
+        quantize(rowWeights.data(), inputs, rowScales.back()[neuronIterator], &weights.back()[(size_t) neuronIterator * strides.back()]);
+        //Bias neurons always fire the same value so their connections fold into a single offset
+        for (inputIterator = inputs; inputIterator < inputs + NEURAL_BIAS_NEURONS; ++inputIterator) {
+          offsets.back()[neuronIterator] += layer->getWeight(neuronIterator, inputIterator) * NEURAL_BIAS_VALUE;
+        }
+      }
+    }
+  }
+
+  //Reads a quantized network written by write()
+  QuantizedNetwork::QuantizedNetwork(FILE* file_in, double (*activationFunction_in)(double))
+  {
+    quantized_header header;
+    std::vector<quantized_layer> layers;
+    unsigned layerIterator;
+
+    //Check to make sure the file is valid
+    if (fread(&header, sizeof(header), 1, file_in) != 1) {
+      throw std::runtime_error("Quantized network is truncated");
+    }
+    if (memcmp(header.magic, NEURAL_QUANTIZED_MAGIC, sizeof(header.magic)) != 0) {
+      throw std::runtime_error("Not a quantized network");
+    }
+    if (header.version != NEURAL_QUANTIZED_VERSION) {
+      throw std::runtime_error("Unsupported quantized network version");
+    }
+    if (header.bias != NEURAL_BIAS_NEURONS) {
+      throw std::runtime_error("Quantized network bias neurons do not match");
+    }
+    if (header.layers == 0) {
+      throw std::runtime_error("Quantized network has no layers");
+    }
+    layers.resize(header.layers);
+    if (fread(layers.data(), sizeof(quantized_layer), layers.size(), file_in) != layers.size()) {
+      throw std::runtime_error("Quantized network is truncated");
+    }
+    activationFunction = activationFunction_in;
+    granularity = header.granularity;
+    softmax = header.softmax;
+
+    //Read each layer's arrays in the order they were written
+    for (layerIterator = 0; layerIterator < layers.size(); ++layerIterator) {
+      if (layerIterator > 0 && (layers[layerIterator].inputs != topology.back() || layers[layerIterator].stride != align(layers[layerIterator].inputs))) {
+        throw std::runtime_error("Quantized network layers do not line up");
+      }
+      topology.push_back(layers[layerIterator].neurons);
+      strides.push_back(layerIterator > 0 ? layers[layerIterator].stride : 0);
+      inputScales.push_back(layers[layerIterator].inputScale);
+      weights.push_back(std::vector<int8_t>((size_t) topology.back() * strides.back()));
+      rowScales.push_back(std::vector<float>(layerIterator > 0 ? topology.back() : 0));
+      offsets.push_back(std::vector<float>(layerIterator > 0 ? topology.back() : 0));
+      if (fread(weights.back().data(), 1, weights.back().size(), file_in) != weights.back().size() ||
+          fread(rowScales.back().data(), sizeof(float), rowScales.back().size(), file_in) != rowScales.back().size() ||
+          fread(offsets.back().data(), sizeof(float), offsets.back().size(), file_in) != offsets.back().size()) {
+        throw std::runtime_error("Quantized network is truncated");
+      }
+    }
+  }
+
+  //Writes the quantized network so it can be read back without the original network
+  void QuantizedNetwork::write(FILE* file_out)
+  {
+    quantized_header header;
+    quantized_layer layer;
+    unsigned layerIterator;
+
+    //Describe the network
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, NEURAL_QUANTIZED_MAGIC, sizeof(header.magic));
+    header.version = NEURAL_QUANTIZED_VERSION;
+    header.layers = topology.size();
+    header.bias = NEURAL_BIAS_NEURONS;
+    header.granularity = granularity;
+    header.softmax = softmax;
+    if (fwrite(&header, sizeof(header), 1, file_out) != 1) {
+      throw std::runtime_error("Unable to write quantized network");
+    }
+
+    //Write the layer table
+    for (layerIterator = 0; layerIterator < topology.size(); ++layerIterator) {
+      memset(&layer, 0, sizeof(layer));
+      layer.neurons = topology[layerIterator];
+      layer.inputs = layerIterator > 0 ? topology[layerIterator - 1] : 0;
+      layer.stride = strides[layerIterator];
+      layer.inputScale = inputScales[layerIterator];
+      if (fwrite(&layer, sizeof(layer), 1, file_out) != 1) {
+        throw std::runtime_error("Unable to write quantized network");
+      }
+    }
+
+    //Write each layer's arrays
+    for (layerIterator = 0; layerIterator < topology.size(); ++layerIterator) {
+      if (fwrite(weights[layerIterator].data(), 1, weights[layerIterator].size(), file_out) != weights[layerIterator].size() ||
+          fwrite(rowScales[layerIterator].data(), sizeof(float), rowScales[layerIterator].size(), file_out) != rowScales[layerIterator].size() ||
+          fwrite(offsets[layerIterator].data(), sizeof(float), offsets[layerIterator].size(), file_out) != offsets[layerIterator].size()) {
+        throw std::runtime_error("Unable to write quantized network");
+      }
+    }
+  }
+
+  //Feeds values through the quantized network
+  void QuantizedNetwork::feedForward(const std::vector<double> &values_in)
+  {
+    unsigned layerIterator;
+    unsigned neuronIterator;
+    const int8_t* row;
+    int32_t sum;
+
+    if (values_in.size() != topology[0]) {
+      throw std::runtime_error("Input values do not match the input layer");
+    }
+    values = values_in;
+
+    for (layerIterator = 1; layerIterator < topology.size(); ++layerIterator) {
+      //Round the layer's inputs once, the padding stays zero so it adds nothing to the sums
+      quantizedValues.assign(strides[layerIterator], 0);
+      quantize(values.data(), topology[layerIterator - 1], inputScales[layerIterator], quantizedValues.data());
+      nextValues.resize(topology[layerIterator]);
+      for (neuronIterator = 0; neuronIterator < topology[layerIterator]; ++neuronIterator) {
+        row = &weights[layerIterator][(size_t) neuronIterator * strides[layerIterator]];
+        sum = kernels::dotInt8(row, quantizedValues.data(), strides[layerIterator]);
+        //Scale the integer sum back once for the whole row
+        nextValues[neuronIterator] = sum * ((double) rowScales[layerIterator][neuronIterator] * inputScales[layerIterator]) + offsets[layerIterator][neuronIterator];
+      }
+      //Softmax outputs are normalized together, every other layer calls the activation function
+      if (softmax && layerIterator + 1 == topology.size()) {
+        Layer::normalizeSoftmax(nextValues.data(), topology[layerIterator]);
+      } else {
+        for (neuronIterator = 0; neuronIterator < topology[layerIterator]; ++neuronIterator) {
+          nextValues[neuronIterator] = activationFunction(nextValues[neuronIterator]);
+        }
+      }
+      values.swap(nextValues);
+    }
+  }
+
+  //Returns the values of the output neurons from the last feed forward
+  void QuantizedNetwork::getResults(std::vector<double> &resultValues_in)
+  {
+    resultValues_in = values;
+  }
+
+  //Rounds values to 8 bit integers in steps of a scale, clamping to the quantized range
+  void QuantizedNetwork::quantize(const double* values_in, unsigned length_in, double scale_in, int8_t* values_out)
+  {
+    unsigned valueIterator;
+    double inverse;
+    long step;
+
+    inverse = 1 / scale_in;
+    for (valueIterator = 0; valueIterator < length_in; ++valueIterator) {
+      step = std::lrint(values_in[valueIterator] * inverse);
+      //Values past the calibrated range saturate
+      step = std::min(std::max(step, (long) -NEURAL_QUANTIZED_RANGE), (long) NEURAL_QUANTIZED_RANGE);
+      values_out[valueIterator] = (int8_t) step;
+    }
+  }
+
+  //Returns the stride a row of inputs is padded to
+  unsigned QuantizedNetwork::align(unsigned inputs_in)
+  {
+    return (inputs_in + NEURAL_QUANTIZED_ALIGNMENT - 1) / NEURAL_QUANTIZED_ALIGNMENT * NEURAL_QUANTIZED_ALIGNMENT;
+  }
+
+  //Returns the bytes held by the weights, row scales and offsets
+  size_t QuantizedNetwork::weightBytes() const
+  {
+    unsigned layerIterator;
+    size_t bytes;
+
+    bytes = 0;
+    for (layerIterator = 0; layerIterator < topology.size(); ++layerIterator) {
+      bytes += weights[layerIterator].size() + (rowScales[layerIterator].size() + offsets[layerIterator].size()) * sizeof(float);
+    }
+    return bytes;
+  }
+
+  unsigned QuantizedNetwork::numLayers() const { return topology.size(); }
+  unsigned QuantizedNetwork::getGranularity() const { return granularity; }
+  float QuantizedNetwork::getInputScale(unsigned layer_in) const { return inputScales[layer_in]; }
+}
@@ -0,0 +1,155 @@
+/***********************************************************
+* Network quantized to 8 bit integers for inference
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*   - Kept softmax output layers
+*
+* Each layer keeps its weights as one row of 8 bit integers per
+*   neuron with a float scale per row (or one per layer), and the
+*   bias connections folded into a float offset per row. Inputs to
+*   a layer are rounded to 8 bit integers using a scale calibrated
+*   from the largest values seen on sample inputs, so each sum is
+*   an integer dot product scaled back once:
+*     output = activation(dot * rowScale * inputScale + offset)
+*
+* File Layout:
+*   quantized_header
+*   quantized_layer for every layer
+*   For every layer but the input: weights (neurons * stride bytes),
+*     then row scales and offsets (neurons floats each)
+***********************************************************/
+
+#ifndef _H_NEURAL_QUANTIZED_NETWORK
+#define _H_NEURAL_QUANTIZED_NETWORK
+
+#include <stdexcept>   //std::runtime_error
+#include <stdio.h>     //FILE    fread()    fwrite()
+#include <string.h>    //memcmp()    memcpy()    memset()
+#include <stdint.h>    //int8_t    int32_t
+#include <vector>      //std::vector
+#include <cmath>       //std::fabs()    std::lrint()
+#include <algorithm>   //std::max()    std::min()
+
+#include "network.hpp"
+#include "kernels.hpp"
+#include "quantized_data.hpp"
+
+#define NEURAL_QUANTIZED_MAGIC     "NEURALQ8"
+#define NEURAL_QUANTIZED_VERSION   1
+//Rows are padded with zero weights to a whole number of AVX-512 registers
+#define NEURAL_QUANTIZED_ALIGNMENT 64
+//Largest magnitude of a quantized value, -128 is left out so the range is symmetric
+#define NEURAL_QUANTIZED_RANGE     127
+
+//One weight scale for each neuron's row of weights
+#define NEURAL_QUANTIZE_PER_ROW   0
+//One weight scale shared by every weight in a layer
+#define NEURAL_QUANTIZE_PER_LAYER 1
+
+namespace neural
+{
+  class QuantizedNetwork
+  {
+  private:
+    /* Activation function applied to each scaled sum */
+    double (*activationFunction)(double);
+
+    /* NEURAL_QUANTIZE_* the weight scales were chosen for */
+    unsigned granularity;
+
+    /* Flags if the output layer is a softmax over its sums instead of calling the activation function */
+    unsigned softmax;
+
+    /* Non-bias neurons in each layer */
+    std::vector<unsigned> topology;
+
+    /* Bytes in each padded row of weights for each layer */
+    std::vector<unsigned> strides;
+
+    /* Value of one step of each layer's 8 bit inputs */
+    std::vector<float> inputScales;
+
+    /* Row-major 8 bit weights of each layer */
+    std::vector<std::vector<int8_t> > weights;
+
+    /* Value of one step of each row's 8 bit weights */
+    std::vector<std::vector<float> > rowScales;
+
+    /* Sum of each row's bias connections */
+    std::vector<std::vector<float> > offsets;
+
+    /* Inputs of the layer being evaluated rounded to 8 bits, padded to the stride with zeros */
+    std::vector<int8_t> quantizedValues;
+
+    /* Outputs of the layer last evaluated */
+    std::vector<double> values;
+
+    /* Outputs of the layer being evaluated */
+    std::vector<double> nextValues;
+
+    /*****************
+    * Rounds values to 8 bit integers in steps of a scale, clamping to the quantized range
+    * @param values_in  values to round
+    * @param length_in  number of values
+    * @param scale_in   value of one step
+    * @param values_out location to store the rounded values
+    *****************/
+    static void quantize(const double* values_in, unsigned length_in, double scale_in, int8_t* values_out);
+
+    /*****************
+    * Returns the stride a row of inputs is padded to
+    * @param inputs_in non-bias inputs in the row
+    *****************/
+    static unsigned align(unsigned inputs_in);
+
+  public:
+    /*****************
+    * Quantizes a trained dense or sparse network
+    * @param network_in             network to quantize
+    * @param calibration_in         sample inputs whose largest values set the range of each layer's inputs
+    * @param activationFunction_in  activation function the network was trained with
+    * @param granularity_in         NEURAL_QUANTIZE_* to choose weight scales for
+    *****************/
+    QuantizedNetwork(Network* network_in, const std::vector<std::vector<double> > &calibration_in, double (*activationFunction_in)(double), unsigned granularity_in = NEURAL_QUANTIZE_PER_ROW);
+
+    /*****************
+    * Reads a quantized network written by write()
+    * @param file_in               file to read from
+    * @param activationFunction_in activation function the network was trained with
+    *****************/
+    QuantizedNetwork(FILE* file_in, double (*activationFunction_in)(double));
+
+    /*****************
+    * Writes the quantized network so it can be read back without the original network
+    * @param file_out file to write to
+    *****************/
+    void write(FILE* file_out);
+
+    /*****************
+    * Feeds values through the quantized network
+    * @param values_in values for the input neurons
+    *****************/
+    void feedForward(const std::vector<double> &values_in);
+
+    /*****************
+    * Returns the values of the output neurons from the last feed forward
+    * @param resultValues_in location to store the values
+    *****************/
+    void getResults(std::vector<double> &resultValues_in);
+
+    /*****************
+    * Returns the bytes held by the weights, row scales and offsets
+    *****************/
+    size_t weightBytes() const;
+
+    unsigned numLayers() const;
+    unsigned getGranularity() const;
+    float getInputScale(unsigned layer_in) const;
+  };
+}
+
+#endif
@@ -0,0 +1,26 @@
+//Simple structures describing a binary sample file and a batch of samples handed to a network
+
+#ifndef _H_NEURAL_SAMPLE_DATA
+#define _H_NEURAL_SAMPLE_DATA
+
+#include <stdint.h>   //uint32_t    uint64_t
+
+typedef struct {
+  char magic[8];          //Identifies the file as binary samples
+  uint32_t version;       //Version of the layout
+  uint32_t scalarSize;    //Bytes in each stored value, 4 for float or 8 for double
+  uint32_t inputs;        //Input values at the start of each sample
+  uint32_t targets;       //Target values following the inputs of each sample
+  uint64_t samples;       //Number of samples in the file
+  uint64_t stride;        //Bytes from the start of one sample to the next
+  uint64_t offset;        //Byte offset of the first sample from the start of the file
+  uint64_t reserved[2];   //Zero, pads the header to 64 bytes
+} sample_header;
+
+typedef struct {
+  const double* const* inputs;    //Location of each sample's input values
+  const double* const* targets;   //Location of each sample's target values
+  unsigned samples;               //Samples in the batch
+} sample_batch;
+
+#endif
@@ -0,0 +1,179 @@
+//Sequential reader of training samples
+#include "sample_reader.hpp"
+
+namespace neural
+{
+  //Creates a reader at the start of a file
+  SampleReader::SampleReader(FILE* file_in, unsigned format_in, unsigned inputs_in, unsigned targets_in)
+  {
+    if (file_in == NULL) {
+      throw std::runtime_error("Sample file is not open");
+    }
+    file = file_in;
+    format = format_in;
+    inputs = inputs_in;
+    targets = targets_in;
+    line = NULL;
+    lineSize = 0;
+    lineNumber = 0;
+    remaining = 0;
+    memset(&header, 0, sizeof(header));
+
+    //Csv lines do not say where the inputs end
+    if (format == NEURAL_SAMPLES_CSV) {
+      if (inputs == 0 || targets == 0) {
+        throw std::runtime_error("Csv samples need the number of inputs and targets");
+      }
+      return;
+    }
+
+    //Binary files describe their samples in the header
+    if (fread(&header, sizeof(header), 1, file) != 1) {
+      throw std::runtime_error("Unable to read the sample file header");
+    }
+    checkHeader(&header);
+    if ((inputs != 0 && inputs != header.inputs) || (targets != 0 && targets != header.targets)) {
+      throw std::runtime_error("Binary samples do not match the network's inputs and outputs");
+    }
+    inputs = header.inputs;
+    targets = header.targets;
+    record.resize((size_t) (inputs + targets) * header.scalarSize);
+    rewind();
+  }
+
+  //Frees the line buffer
+  SampleReader::~SampleReader()
+  {
+    free(line);
+  }
+
+  //Parses one csv line into the sample
+  unsigned SampleReader::parseLine(double* inputs_out, double* targets_out)
+  {
+    const char* cursor;
+    char* end;
+    unsigned valueIterator;
+    double value;
+
+    //Blank lines and comments hold no sample
+    cursor = line;
+    while (*cursor == ' ' || *cursor == '\t') {
+      ++cursor;
+    }
+    if (*cursor == '\0' || *cursor == '\n' || *cursor == '\r' || *cursor == '#') {
+      return 0;
+    }
+
+    //Every value is followed by a comma except the last
+    for (valueIterator = 0; valueIterator < inputs + targets; ++valueIterator) {
+      value = strtod(cursor, &end);
+      if (end == cursor) {
+        throw std::runtime_error("Csv line " + std::to_string(lineNumber) + " does not hold " + std::to_string(inputs + targets) + " numbers");
+      }
+      if (valueIterator < inputs) {
+        inputs_out[valueIterator] = value;
+      } else {
+        targets_out[valueIterator - inputs] = value;
+      }
+      cursor = end;
+      while (*cursor == ' ' || *cursor == '\t') {
+        ++cursor;
+      }
+      if (valueIterator + 1 < inputs + targets) {
+        if (*cursor != ',') {
+          throw std::runtime_error("Csv line " + std::to_string(lineNumber) + " does not hold " + std::to_string(inputs + targets) + " numbers");
+        }
+        ++cursor;
+      }
+    }
+    if (*cursor != '\0' && *cursor != '\n' && *cursor != '\r') {
+      throw std::runtime_error("Csv line " + std::to_string(lineNumber) + " holds more than " + std::to_string(inputs + targets) + " numbers");
+    }
+    return 1;
+  }
+
+  //Reads the next sample
+  unsigned SampleReader::read(double* inputs_out, double* targets_out)
+  {
+    unsigned valueIterator;
+    double* value;
+    float single;
+
+    if (format == NEURAL_SAMPLES_CSV) {
+      //Skip lines until one holds a sample
+      while (getline(&line, &lineSize, file) != -1) {
+        ++lineNumber;
+        if (parseLine(inputs_out, targets_out)) {
+          return 1;
+        }
+      }
+      return 0;
+    }
+
+    if (remaining == 0) {
+      return 0;
+    }
+    if (fread(record.data(), 1, record.size(), file) != record.size()) {
+      throw std::runtime_error("Binary sample file is shorter than its header says");
+    }
+    //Skip any padding after the sample
+    if (header.stride > record.size() && fseek(file, header.stride - record.size(), SEEK_CUR) != 0) {
+      throw std::runtime_error("Unable to seek in the sample file");
+    }
+    --remaining;
+
+    //Widen each stored value
+    for (valueIterator = 0; valueIterator < inputs + targets; ++valueIterator) {
+      value = valueIterator < inputs ? &inputs_out[valueIterator] : &targets_out[valueIterator - inputs];
+      if (header.scalarSize == sizeof(float)) {
+        memcpy(&single, &record[(size_t) valueIterator * sizeof(float)], sizeof(float));
+        *value = single;
+      } else {
+        memcpy(value, &record[(size_t) valueIterator * sizeof(double)], sizeof(double));
+      }
+    }
+    return 1;
+  }
+
+  //Goes back to the first sample
+  void SampleReader::rewind()
+  {
+    if (fseek(file, format == NEURAL_SAMPLES_CSV ? 0 : header.offset, SEEK_SET) != 0) {
+      throw std::runtime_error("Unable to seek in the sample file");
+    }
+    lineNumber = 0;
+    remaining = header.samples;
+  }
+
+  //Throws if a binary sample file header is not one this version reads
+  void SampleReader::checkHeader(const sample_header* header_in)
+  {
+    if (memcmp(header_in->magic, NEURAL_SAMPLES_MAGIC, sizeof(header_in->magic)) != 0) {
+      throw std::runtime_error("Not a binary sample file");
+    }
+    if (header_in->version != NEURAL_SAMPLES_VERSION) {
+      throw std::runtime_error("Unsupported binary sample file version");
+    }
+    //Every sample holds at least one value and the values of a sample can be counted in 32 bits, so the stride is never 0
+    if ((header_in->scalarSize != sizeof(float) && header_in->scalarSize != sizeof(double)) || header_in->offset < sizeof(sample_header) ||
+        (uint64_t) header_in->inputs + header_in->targets == 0 || (uint64_t) header_in->inputs + header_in->targets > UINT32_MAX ||
+        header_in->stride < ((uint64_t) header_in->inputs + header_in->targets) * header_in->scalarSize) {
+      throw std::runtime_error("Binary sample file header is corrupt");
+    }
+  }
+
+  //Picks the format from a file name
+  unsigned SampleReader::formatOf(const char* path_in)
+  {
+    size_t length;
+
+    length = strlen(path_in);
+    if (length > 4 && strcmp(path_in + length - 4, ".csv") == 0) {
+      return NEURAL_SAMPLES_CSV;
+    }
+    return NEURAL_SAMPLES_BINARY;
+  }
+
+  unsigned SampleReader::numInputs() const { return inputs; }
+  unsigned SampleReader::numTargets() const { return targets; }
+}
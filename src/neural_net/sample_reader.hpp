@@ -0,0 +1,118 @@
+/***********************************************************
+* Sequential reader of training samples
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*   - Shared the header check with mapped sample files
+*   - Refused headers whose sizes overflow
+*
+* Reads one sample at a time, its input values then its target
+*   values, from either format:
+*   NEURAL_SAMPLES_CSV    one sample per line, the inputs then
+*                         the targets separated by commas, blank
+*                         lines and lines starting with # skipped
+*   NEURAL_SAMPLES_BINARY a sample_header then every sample as
+*                         inputs + targets floats or doubles, one
+*                         sample every stride bytes from offset
+***********************************************************/
+
+#ifndef _H_NEURAL_SAMPLE_READER
+#define _H_NEURAL_SAMPLE_READER
+
+#include <stdio.h>     //FILE    fread()    getline()
+#include <stdlib.h>    //strtod()    free()
+#include <string.h>    //memcmp()    memcpy()
+#include <stdexcept>   //std::runtime_error
+#include <vector>      //std::vector
+#include <string>      //std::to_string()
+
+#include "sample_data.hpp"
+
+#define NEURAL_SAMPLES_CSV    0
+#define NEURAL_SAMPLES_BINARY 1
+
+#define NEURAL_SAMPLES_MAGIC     "NEURALSM"
+#define NEURAL_SAMPLES_VERSION   1
+#define NEURAL_SAMPLES_ALIGNMENT 64
+
+namespace neural
+{
+  class SampleReader
+  {
+  private:
+    /* File the samples are read from, owned by the caller */
+    FILE* file;
+    /* NEURAL_SAMPLES_* format of the file */
+    unsigned format;
+    /* Input values in each sample */
+    unsigned inputs;
+    /* Target values in each sample */
+    unsigned targets;
+    /* Header of a binary file */
+    sample_header header;
+    /* Samples of a binary file not yet read */
+    uint64_t remaining;
+    /* Bytes of the binary sample being read */
+    std::vector<char> record;
+    /* Line of the csv file being parsed, grown by getline() */
+    char* line;
+    /* Bytes allocated for line */
+    size_t lineSize;
+    /* Line number of the csv file, for errors */
+    unsigned long lineNumber;
+
+    /*****************
+    * Parses one csv line into the sample
+    * @return 1 if the line held a sample, 0 if it was blank or a comment
+    *****************/
+    unsigned parseLine(double* inputs_out, double* targets_out);
+
+  public:
+    /*****************
+    * Creates a reader at the start of a file
+    * @param file_in    file to read, opened by the caller and kept open while reading
+    * @param format_in  NEURAL_SAMPLES_* format of the file
+    * @param inputs_in  input values in each sample, read from the header of binary files (0 accepts any)
+    * @param targets_in target values in each sample, read from the header of binary files (0 accepts any)
+    *****************/
+    SampleReader(FILE* file_in, unsigned format_in, unsigned inputs_in = 0, unsigned targets_in = 0);
+
+    /*****************
+    * Frees the line buffer
+    *****************/
+    ~SampleReader();
+
+    /*****************
+    * Reads the next sample
+    * @param inputs_out  location to store the input values
+    * @param targets_out location to store the target values
+    * @return 1 if a sample was read, 0 at the end of the file
+    *****************/
+    unsigned read(double* inputs_out, double* targets_out);
+
+    /*****************
+    * Goes back to the first sample
+    *****************/
+    void rewind();
+
+    /*****************
+    * Throws if a binary sample file header is not one this version reads
+    * @param header_in header at the start of the file
+    *****************/
+    static void checkHeader(const sample_header* header_in);
+
+    /*****************
+    * Picks the format from a file name, .csv for csv and anything else for binary
+    * @param path_in name of the file
+    *****************/
+    static unsigned formatOf(const char* path_in);
+
+    unsigned numInputs() const;
+    unsigned numTargets() const;
+  };
+}
+
+#endif
@@ -0,0 +1,73 @@
+//Writer of binary training samples
+#include "sample_writer.hpp"
+
+namespace neural
+{
+  //Writes an empty header to the start of a file
+  SampleWriter::SampleWriter(FILE* file_in, unsigned inputs_in, unsigned targets_in, unsigned scalarSize_in)
+  {
+    if (file_in == NULL) {
+      throw std::runtime_error("Sample file is not open");
+    }
+    if (scalarSize_in != sizeof(float) && scalarSize_in != sizeof(double)) {
+      throw std::runtime_error("Samples are stored as floats or doubles");
+    }
+    file = file_in;
+
+    //Samples follow the header back to back
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, NEURAL_SAMPLES_MAGIC, sizeof(header.magic));
+    header.version = NEURAL_SAMPLES_VERSION;
+    header.scalarSize = scalarSize_in;
+    header.inputs = inputs_in;
+    header.targets = targets_in;
+    header.stride = (uint64_t) (inputs_in + targets_in) * scalarSize_in;
+    header.offset = NEURAL_SAMPLES_ALIGNMENT;
+    record.resize(header.stride);
+    writeHeader();
+  }
+
+  //Writes the header at the start of the file and returns to the end
+  void SampleWriter::writeHeader()
+  {
+    char padding[NEURAL_SAMPLES_ALIGNMENT - sizeof(sample_header) + 1];
+
+    memset(padding, 0, sizeof(padding));
+    if (fseek(file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(padding, 1, header.offset - sizeof(header), file) != header.offset - sizeof(header) || fseek(file, 0, SEEK_END) != 0) {
+      throw std::runtime_error("Unable to write the sample file header");
+    }
+  }
+
+  //Appends one sample
+  void SampleWriter::write(const double* inputs_in, const double* targets_in)
+  {
+    unsigned valueIterator;
+    double value;
+    float single;
+
+    //Narrow each value to the stored type
+    for (valueIterator = 0; valueIterator < header.inputs + header.targets; ++valueIterator) {
+      value = valueIterator < header.inputs ? inputs_in[valueIterator] : targets_in[valueIterator - header.inputs];
+      if (header.scalarSize == sizeof(float)) {
+        single = value;
+        memcpy(&record[(size_t) valueIterator * sizeof(float)], &single, sizeof(float));
+      } else {
+        memcpy(&record[(size_t) valueIterator * sizeof(double)], &value, sizeof(double));
+      }
+    }
+    if (fwrite(record.data(), 1, record.size(), file) != record.size()) {
+      throw std::runtime_error("Unable to write a sample");
+    }
+    ++header.samples;
+  }
+
+  //Records the number of samples written in the header
+  void SampleWriter::finish()
+  {
+    writeHeader();
+    fflush(file);
+  }
+
+  unsigned long long SampleWriter::numSamples() const { return header.samples; }
+}
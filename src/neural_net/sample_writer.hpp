@@ -0,0 +1,70 @@
+/***********************************************************
+* Writer of binary training samples
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*
+* Writes the NEURAL_SAMPLES_BINARY format read by SampleReader,
+*   a sample_header then each sample's inputs and targets stored
+*   as floats or doubles. The sample count in the header is
+*   filled in by finish().
+***********************************************************/
+
+#ifndef _H_NEURAL_SAMPLE_WRITER
+#define _H_NEURAL_SAMPLE_WRITER
+
+#include <stdio.h>     //FILE    fwrite()    fseek()
+#include <string.h>    //memcpy()    memset()
+#include <stdexcept>   //std::runtime_error
+#include <vector>      //std::vector
+
+#include "sample_data.hpp"
+#include "sample_reader.hpp"
+
+namespace neural
+{
+  class SampleWriter
+  {
+  private:
+    /* File the samples are written to, owned by the caller */
+    FILE* file;
+    /* Header written at the start of the file */
+    sample_header header;
+    /* Bytes of the sample being written */
+    std::vector<char> record;
+
+    /*****************
+    * Writes the header at the start of the file and returns to the end
+    *****************/
+    void writeHeader();
+
+  public:
+    /*****************
+    * Writes an empty header to the start of a file
+    * @param file_in       file to write, opened by the caller for binary writing
+    * @param inputs_in     input values in each sample
+    * @param targets_in    target values in each sample
+    * @param scalarSize_in bytes each value is stored in, sizeof(float) or sizeof(double)
+    *****************/
+    SampleWriter(FILE* file_in, unsigned inputs_in, unsigned targets_in, unsigned scalarSize_in = sizeof(float));
+
+    /*****************
+    * Appends one sample
+    * @param inputs_in  input values of the sample
+    * @param targets_in target values of the sample
+    *****************/
+    void write(const double* inputs_in, const double* targets_in);
+
+    /*****************
+    * Records the number of samples written in the header, call once every sample is written
+    *****************/
+    void finish();
+
+    unsigned long long numSamples() const;
+  };
+}
+
+#endif
@@ -0,0 +1,30 @@
+//Simple structures of the messages exchanged with the inference server and the counters it reports
+
+#ifndef _H_NEURAL_SERVER_DATA
+#define _H_NEURAL_SERVER_DATA
+
+#include <stdint.h>   //uint32_t    uint64_t
+
+typedef struct {
+  uint32_t kind;          //NEURAL_SERVER_PREDICT or NEURAL_SERVER_STATS
+  uint32_t bytes;         //Bytes following the header, the input values as doubles for a prediction
+} server_request;
+
+typedef struct {
+  uint32_t status;        //NEURAL_SERVER_OK or NEURAL_SERVER_ERROR
+  uint32_t bytes;         //Bytes following the header, the output values as doubles or a server_stats
+} server_response;
+
+typedef struct {
+  uint64_t requests;      //Predictions answered since the server started
+  uint64_t batches;       //Batched forward passes run since the server started
+  uint64_t rejected;      //Predictions refused for having the wrong number of inputs
+  uint64_t failed;        //Predictions whose batch could not run
+  double seconds;         //Time since the server started
+  double requestsPerSec;  //Predictions answered per second since the server started
+  double meanBatch;       //Predictions in the average batch
+  double p50Micros;       //Median microseconds from a prediction arriving to its outputs being ready
+  double p99Micros;       //99th percentile of the same, both over the latest NEURAL_SERVER_LATENCY_WINDOW predictions
+} server_stats;
+
+#endif
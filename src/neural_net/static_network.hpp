@@ -0,0 +1,288 @@
+/***********************************************
+* Dense Neural Network whose activation and optimizer are resolved at compile time.
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified:
+*   October 17, 2026 - Created Initially
+*   October 17, 2026 - Added fused softmax and cross-entropy output
+*   October 17, 2026 - Added training on a batch of sample rows
+*   October 17, 2026 - Refused empty batches
+*   October 17, 2026 - Drew the initial weights on the thread pool
+***********************************************/
+
+#ifndef _H_NEURAL_STATIC_NETWORK
+#define _H_NEURAL_STATIC_NETWORK
+
+#include <vector>   //std::vector
+#include <memory>   //std::shared_ptr
+
+#include "network.hpp"
+#include "activation.hpp"
+#include "optimizer.hpp"
+
+namespace neural
+{
+  /****************
+  * Network whose training passes are instantiated for an activation and optimizer policy so
+  * the per neuron and per weight calls are inlined into the dense loops
+  *   Used through a Network pointer it falls back to the policies' function pointers
+  * @param Activation policy from neural::activation
+  * @param Optimizer  policy from neural::optimizer
+  ****************/
+  template<class Activation, class Optimizer = optimizer::Momentum<> >
+  class StaticNetwork : public Network
+  {
+  public:
+    /***********************
+    * Constructs a dense Network from the specified topology
+    * @param topology_in  vector with each element pertaining to the amount of neurons at level index
+    * @param precision_in NEURAL_PRECISION_* of the weights
+    * @param initializer_in Distribution and seed the weights are drawn from
+    * @param threads_in   Threads the weights are drawn on and each layer is then split between
+    ***********************/
+    StaticNetwork(const std::vector<unsigned> &topology_in, unsigned precision_in = NEURAL_PRECISION_DOUBLE, const Initializer& initializer_in = Initializer(), unsigned threads_in = 1);
+
+    /***********************
+    * Constructs a dense Network whose weights are used in place from a mapped binary network
+    * @param model_in Mapped binary network, kept alive by the Network
+    ***********************/
+    StaticNetwork(std::shared_ptr<BinaryModel> model_in);
+
+    /***********************
+    * Sets all the neurons to forward their values for computation at the next layer
+    * @param values_in values for the input neurons
+    ***********************/
+    void feedForward(const std::vector<double> &values_in);
+
+    /***********************
+    * Sets the neurons values using back-propigation
+    * @param values_in values to test against
+    ***********************/
+    void backPropagation(const std::vector<double> &values_in);
+
+    /***********************
+    * Forwards a batch of samples through the network
+    * @param values_in  values for the input neurons of each sample, read in place
+    * @param samples_in number of samples in the batch
+    ***********************/
+    void feedForwardBatch(const double* const* values_in, unsigned samples_in);
+
+    /***********************
+    * Forwards a batch of samples through the network
+    * @param values_in  samples x inputs row-major matrix of input values
+    * @param samples_in number of samples in the batch
+    ***********************/
+    void feedForwardBatch(const std::vector<double> &values_in, unsigned samples_in);
+
+    /***********************
+    * Back-propagates the last forwarded batch and applies one weight update for the whole batch
+    * @param values_in values to test each sample against, read in place
+    ***********************/
+    void backPropagationBatch(const double* const* values_in);
+
+    /***********************
+    * Runs one mini-batch training step
+    * @param values_in  values for the input neurons of each sample
+    * @param targets_in values to test each sample against
+    * @param samples_in number of samples in the batch
+    ***********************/
+    void trainBatch(const double* const* values_in, const double* const* targets_in, unsigned samples_in);
+
+    /***********************
+    * Runs one mini-batch training step
+    * @param values_in  samples x inputs row-major matrix of input values
+    * @param targets_in samples x outputs row-major matrix of values to test against
+    * @param samples_in number of samples in the batch
+    ***********************/
+    void trainBatch(const std::vector<double> &values_in, const std::vector<double> &targets_in, unsigned samples_in);
+
+    /***********************
+    * Runs one mini-batch training step on a batch from a Dataset or MappedSamples
+    * @param batch_in rows of the batch's inputs and targets
+    ***********************/
+    void trainBatch(const sample_batch* batch_in);
+  };
+
+  //Constructs a dense Network from the specified topology
+  template<class Activation, class Optimizer> StaticNetwork<Activation, Optimizer>::StaticNetwork(const std::vector<unsigned> &topology_in, unsigned precision_in, const Initializer& initializer_in, unsigned threads_in)
+    : Network(topology_in, &Activation::value, &Activation::derivative, &Optimizer::delta, NEURAL_STORAGE_DENSE, precision_in, initializer_in, threads_in)
+  {
+  }
+
+  //Constructs a dense Network whose weights are used in place from a mapped binary network
+  template<class Activation, class Optimizer> StaticNetwork<Activation, Optimizer>::StaticNetwork(std::shared_ptr<BinaryModel> model_in)
+    : Network(model_in, &Activation::value, &Activation::derivative, &Optimizer::delta)
+  {
+  }
+
+  //Sets all the neurons to forward their values for computation at the next layer
+  template<class Activation, class Optimizer> void StaticNetwork<Activation, Optimizer>::feedForward(const std::vector<double> &values_in)
+  {
+    unsigned layerIterator;
+    std::chrono::steady_clock::time_point start;
+
+    //Assign the specified values into the input neurons
+    inputLayer()->setValues(values_in);
+
+    //Forward propigate
+    for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
+      layers[layerIterator].feedForward(&layers[layerIterator - 1], Activation(), pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_FORWARD, start, 0);
+      }
+    }
+  }
+
+  //Sets the neurons values using back-propigation
+  template<class Activation, class Optimizer> void StaticNetwork<Activation, Optimizer>::backPropagation(const std::vector<double> &values_in)
+  {
+    unsigned layerIterator;
+    std::chrono::steady_clock::time_point start;
+
+    //The output layer's error and gradients are its gradient phase
+    if (profiler) {
+      start = std::chrono::steady_clock::now();
+    }
+    //Softmax outputs find the cross-entropy and their gradients together
+    if (outputLayer()->isSoftmax()) {
+      error = outputLayer()->calculateSoftmaxGradients(values_in);
+    } else {
+      //Calculate overall error
+      error = outputLayer()->calculateError(values_in);
+
+      //Calculate output layer gradients
+      outputLayer()->calculateOutputGradients(values_in, Activation());
+    }
+    if (profiler) {
+      profile(layers.size() - 1, NEURAL_PHASE_GRADIENTS, start, 0);
+    }
+
+    //Calculate hidden layer gradients
+    for (layerIterator = layers.size() - 2; layerIterator > 0; --layerIterator) {
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
+      layers[layerIterator].calculateHiddenGradients(&layers[layerIterator + 1], Activation(), pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_GRADIENTS, start, 0);
+      }
+    }
+
+    //Update connection weights for neurons
+    for (layerIterator = layers.size() - 1; layerIterator > 0; --layerIterator) {
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
+      layers[layerIterator].updateInputWeights(&layers[layerIterator - 1], Optimizer(), pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_UPDATE, start, 0);
+      }
+    }
+  }
+
+  //Forwards a batch of samples through the network
+  template<class Activation, class Optimizer> void StaticNetwork<Activation, Optimizer>::feedForwardBatch(const double* const* values_in, unsigned samples_in)
+  {
+    unsigned layerIterator;
+    std::chrono::steady_clock::time_point start;
+
+    if (samples_in == 0) {
+      throw std::runtime_error("Batches need at least one sample");
+    }
+    //Read the input samples in place
+    inputLayer()->setBatchValues(values_in, samples_in);
+
+    //Forward propigate the whole batch one layer at a time
+    for (layerIterator = 1; layerIterator < layers.size(); ++layerIterator) {
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
+      layers[layerIterator].feedForwardBatch(&layers[layerIterator - 1], Activation(), pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_FORWARD, start, 1);
+      }
+    }
+  }
+
+  //Forwards a batch of samples through the network
+  template<class Activation, class Optimizer> void StaticNetwork<Activation, Optimizer>::feedForwardBatch(const std::vector<double> &values_in, unsigned samples_in)
+  {
+    makeBatchRows(values_in, inputLayer()->numNeurons() - inputLayer()->numBias(), samples_in, &batchRows);
+    feedForwardBatch(batchRows.data(), samples_in);
+  }
+
+  //Back-propagates the last forwarded batch and applies one weight update for the whole batch
+  template<class Activation, class Optimizer> void StaticNetwork<Activation, Optimizer>::backPropagationBatch(const double* const* values_in)
+  {
+    unsigned layerIterator;
+    std::chrono::steady_clock::time_point start;
+
+    //The output layer's error and gradients are its gradient phase
+    if (profiler) {
+      start = std::chrono::steady_clock::now();
+    }
+    //Softmax outputs find the cross-entropy and their gradients together
+    if (outputLayer()->isSoftmax()) {
+      error = outputLayer()->calculateSoftmaxGradientsBatch(values_in);
+    } else {
+      //Calculate overall error
+      error = outputLayer()->calculateBatchError(values_in);
+
+      //Calculate output layer gradients
+      outputLayer()->calculateOutputGradientsBatch(values_in, Activation());
+    }
+    if (profiler) {
+      profile(layers.size() - 1, NEURAL_PHASE_GRADIENTS, start, 1);
+    }
+
+    //Calculate hidden layer gradients
+    for (layerIterator = layers.size() - 2; layerIterator > 0; --layerIterator) {
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
+      layers[layerIterator].calculateHiddenGradientsBatch(&layers[layerIterator + 1], Activation(), pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_GRADIENTS, start, 1);
+      }
+    }
+
+    //Apply the accumulated update once per weight
+    for (layerIterator = layers.size() - 1; layerIterator > 0; --layerIterator) {
+      if (profiler) {
+        start = std::chrono::steady_clock::now();
+      }
+      layers[layerIterator].updateInputWeightsBatch(&layers[layerIterator - 1], Optimizer(), pool.get());
+      if (profiler) {
+        profile(layerIterator, NEURAL_PHASE_UPDATE, start, 1);
+      }
+    }
+  }
+
+  //Runs one mini-batch training step
+  template<class Activation, class Optimizer> void StaticNetwork<Activation, Optimizer>::trainBatch(const double* const* values_in, const double* const* targets_in, unsigned samples_in)
+  {
+    feedForwardBatch(values_in, samples_in);
+    backPropagationBatch(targets_in);
+  }
+
+  //Runs one mini-batch training step
+  template<class Activation, class Optimizer> void StaticNetwork<Activation, Optimizer>::trainBatch(const std::vector<double> &values_in, const std::vector<double> &targets_in, unsigned samples_in)
+  {
+    makeBatchRows(values_in, inputLayer()->numNeurons() - inputLayer()->numBias(), samples_in, &batchRows);
+    makeBatchRows(targets_in, outputLayer()->numNeurons() - outputLayer()->numBias(), samples_in, &targetRows);
+    trainBatch(batchRows.data(), targetRows.data(), samples_in);
+  }
+
+  //Runs one mini-batch training step on a batch of sample rows
+  template<class Activation, class Optimizer> void StaticNetwork<Activation, Optimizer>::trainBatch(const sample_batch* batch_in)
+  {
+    trainBatch(batch_in->inputs, batch_in->targets, batch_in->samples);
+  }
+}
+
+#endif
@@ -0,0 +1,307 @@
+//Reader that streams a json network straight into a Network
+
+#include "stream_reader.hpp"
+
+/* Keys recognized in each state */
+typedef struct {
+  unsigned state;
+  const char* name;
+  unsigned field;
+} stream_key;
+
+static const stream_key streamKeys[] = {
+  {STREAM_STATE_ROOT, "network", STREAM_FIELD_NETWORK},
+  {STREAM_STATE_NETWORK, "topology", STREAM_FIELD_TOPOLOGY},
+  {STREAM_STATE_NETWORK, "neurons", STREAM_FIELD_NEURONS},
+  {STREAM_STATE_NETWORK, "connections", STREAM_FIELD_CONNECTIONS},
+  {STREAM_STATE_NETWORK, "precision", STREAM_FIELD_PRECISION},
+  {STREAM_STATE_NEURON, "layer", STREAM_FIELD_LAYER},
+  {STREAM_STATE_NEURON, "neuron", STREAM_FIELD_NEURON},
+  {STREAM_STATE_NEURON, "bias", STREAM_FIELD_BIAS},
+  {STREAM_STATE_NEURON, "output", STREAM_FIELD_OUTPUT},
+  {STREAM_STATE_NEURON, "gradient", STREAM_FIELD_GRADIENT},
+  {STREAM_STATE_CONNECTION, "sourceLayer", STREAM_FIELD_SOURCE_LAYER},
+  {STREAM_STATE_CONNECTION, "sourceNeuron", STREAM_FIELD_SOURCE},
+  {STREAM_STATE_CONNECTION, "destLayer", STREAM_FIELD_DEST_LAYER},
+  {STREAM_STATE_CONNECTION, "destNeuron", STREAM_FIELD_DEST},
+  {STREAM_STATE_CONNECTION, "weight", STREAM_FIELD_WEIGHT},
+  {STREAM_STATE_CONNECTION, "deltaWeight", STREAM_FIELD_DELTA_WEIGHT}
+};
+
+#define NaN std::numeric_limits<double>::quiet_NaN()
+
+//Creates a handler that fills the specified network
+StreamHandler::StreamHandler(neural::Network* network_in, double (*activationFunction_in)(double), double (*activationFunctionDerivative_in)(double), double (*deltaInputWeight_in)(double, double, double, double), unsigned storage_in)
+{
+  network = network_in;
+  activationFunction = activationFunction_in;
+  activationFunctionDerivative = activationFunctionDerivative_in;
+  deltaInputWeight = deltaInputWeight_in;
+  storage = storage_in;
+  precision = NEURAL_PRECISION_DOUBLE;
+  built = 0;
+  state = STREAM_STATE_START;
+  field = STREAM_FIELD_UNKNOWN;
+  skipDepth = 0;
+  seen = 0;
+}
+
+//Records a problem and stops the parse
+bool StreamHandler::fail(const char* message_in)
+{
+  error = message_in;
+  return false;
+}
+
+//Handles a number value
+bool StreamHandler::number(double value_in)
+{
+  if (skipDepth > 0) {
+    return true;
+  }
+  seen |= 1u << field;
+
+  switch (state) {
+  case STREAM_STATE_TOPOLOGY:
+    //Json layers count their bias neurons
+    if (value_in < NEURAL_BIAS_NEURONS) {
+      return fail("Layer is smaller than its bias neurons");
+    }
+    topology.push_back((unsigned) value_in - NEURAL_BIAS_NEURONS);
+    break;
+  case STREAM_STATE_NEURON:
+    switch (field) {
+    case STREAM_FIELD_LAYER: neuron.neuron.layer = (unsigned) value_in - 1; break;
+    case STREAM_FIELD_NEURON: neuron.neuron.neuron = (unsigned) value_in - 1; break;
+    case STREAM_FIELD_BIAS: neuron.bias = (unsigned) value_in; break;
+    case STREAM_FIELD_OUTPUT: neuron.output = value_in; break;
+    case STREAM_FIELD_GRADIENT: neuron.gradient = value_in; break;
+    }
+    break;
+  case STREAM_STATE_CONNECTION:
+    switch (field) {
+    case STREAM_FIELD_SOURCE_LAYER: connection.source.layer = (unsigned) value_in - 1; break;
+    case STREAM_FIELD_SOURCE: connection.source.neuron = (unsigned) value_in - 1; break;
+    case STREAM_FIELD_DEST_LAYER: connection.destination.layer = (unsigned) value_in - 1; break;
+    case STREAM_FIELD_DEST: connection.destination.neuron = (unsigned) value_in - 1; break;
+    case STREAM_FIELD_WEIGHT: connection.weight = value_in; break;
+    case STREAM_FIELD_DELTA_WEIGHT: connection.deltaWeight = value_in; break;
+    }
+    break;
+  }
+  return true;
+}
+
+//Handles the start of an object or array
+bool StreamHandler::open(unsigned array_in)
+{
+  //Nested values inside a skipped value are skipped too
+  if (skipDepth > 0) {
+    ++skipDepth;
+    return true;
+  }
+
+  if (state == STREAM_STATE_START && ! array_in) {
+    state = STREAM_STATE_ROOT;
+  } else if (state == STREAM_STATE_ROOT && field == STREAM_FIELD_NETWORK && ! array_in) {
+    state = STREAM_STATE_NETWORK;
+  } else if (state == STREAM_STATE_NETWORK && field == STREAM_FIELD_TOPOLOGY && array_in) {
+    state = STREAM_STATE_TOPOLOGY;
+  } else if (state == STREAM_STATE_NETWORK && (field == STREAM_FIELD_NEURONS || field == STREAM_FIELD_CONNECTIONS) && array_in) {
+    //Neurons and connections are applied as they are read so the network must already exist
+    if (! built) {
+      return fail("Topology must come before neurons and connections");
+    }
+    state = field == STREAM_FIELD_NEURONS ? STREAM_STATE_NEURONS : STREAM_STATE_CONNECTIONS;
+  } else if (state == STREAM_STATE_NEURONS && ! array_in) {
+    state = STREAM_STATE_NEURON;
+    seen = 0;
+    neuron.output = NaN;
+    neuron.gradient = NaN;
+  } else if (state == STREAM_STATE_CONNECTIONS && ! array_in) {
+    state = STREAM_STATE_CONNECTION;
+    seen = 0;
+    connection.weight = NaN;
+    connection.deltaWeight = NaN;
+  } else {
+    //Anything else is not part of the network description
+    skipDepth = 1;
+  }
+  field = STREAM_FIELD_UNKNOWN;
+  return true;
+}
+
+//Handles the end of an object or array
+bool StreamHandler::close()
+{
+  unsigned layerSize;
+
+  if (skipDepth > 0) {
+    --skipDepth;
+    return true;
+  }
+
+  switch (state) {
+  case STREAM_STATE_ROOT:
+    state = STREAM_STATE_DONE;
+    break;
+  case STREAM_STATE_NETWORK:
+    state = STREAM_STATE_ROOT;
+    break;
+  case STREAM_STATE_TOPOLOGY:
+    if (topology.empty()) {
+      return fail("No topology data found");
+    }
+    //Construct the network now so everything after can be applied directly
+    try {
+      *network = neural::Network(topology, activationFunction, activationFunctionDerivative, deltaInputWeight, storage, precision);
+    } catch (std::runtime_error& problem) {
+      return fail(problem.what());
+    }
+    built = 1;
+    state = STREAM_STATE_NETWORK;
+    break;
+  case STREAM_STATE_NEURONS:
+  case STREAM_STATE_CONNECTIONS:
+    state = STREAM_STATE_NETWORK;
+    break;
+  case STREAM_STATE_NEURON:
+    //Ensure neuron is valid
+    if (! (seen & (1u << STREAM_FIELD_LAYER))) {
+      return fail("Neuron has no layer");
+    }
+    if (! (seen & (1u << STREAM_FIELD_NEURON))) {
+      return fail("Neuron has no index");
+    }
+    if (neuron.neuron.layer >= topology.size() || neuron.neuron.neuron >= topology[neuron.neuron.layer] + NEURAL_BIAS_NEURONS) {
+      return fail("Neuron is out of range");
+    }
+    //Bias neurons sit at the end of each layer when the file does not say
+    if (! (seen & (1u << STREAM_FIELD_BIAS))) {
+      neuron.bias = neuron.neuron.neuron >= topology[neuron.neuron.layer];
+    }
+    network->setNeuron(neuron);
+    state = STREAM_STATE_NEURONS;
+    break;
+  case STREAM_STATE_CONNECTION:
+    //Ensure connection is valid
+    if (! (seen & (1u << STREAM_FIELD_SOURCE_LAYER))) {
+      return fail("Source neuron has no layer");
+    }
+    if (! (seen & (1u << STREAM_FIELD_SOURCE))) {
+      return fail("Source neuron has no index");
+    }
+    if (! (seen & (1u << STREAM_FIELD_DEST_LAYER))) {
+      return fail("Destination neuron has no layer");
+    }
+    if (! (seen & (1u << STREAM_FIELD_DEST))) {
+      return fail("Destination neuron has no index");
+    }
+    if (connection.source.layer >= topology.size() || connection.destination.layer >= topology.size()) {
+      return fail("Connection layer is out of range");
+    }
+    layerSize = topology[connection.source.layer] + NEURAL_BIAS_NEURONS;
+    if (connection.source.neuron >= layerSize || connection.destination.neuron >= topology[connection.destination.layer]) {
+      return fail("Connection neuron is out of range");
+    }
+    try {
+      network->createConnection(connection);
+    } catch (std::runtime_error& problem) {
+      return fail(problem.what());
+    }
+    state = STREAM_STATE_CONNECTIONS;
+    break;
+  }
+  field = STREAM_FIELD_UNKNOWN;
+  return true;
+}
+
+//Scalars that are not numbers or the precision are never part of the network description
+bool StreamHandler::Null() { field = STREAM_FIELD_UNKNOWN; return true; }
+bool StreamHandler::Bool(bool value_in) { field = STREAM_FIELD_UNKNOWN; return true; }
+
+//Reads the precision of the dense weights
+bool StreamHandler::String(const char* value_in, rapidjson::SizeType length_in, bool copy_in)
+{
+  if (skipDepth > 0 || state != STREAM_STATE_NETWORK || field != STREAM_FIELD_PRECISION) {
+    field = STREAM_FIELD_UNKNOWN;
+    return true;
+  }
+  field = STREAM_FIELD_UNKNOWN;
+  //The network is constructed with its precision when the topology closes
+  if (built) {
+    return fail("Precision must come before the topology");
+  }
+  if (strcmp(value_in, "double") == 0) {
+    precision = NEURAL_PRECISION_DOUBLE;
+  } else if (strcmp(value_in, "float") == 0) {
+    precision = NEURAL_PRECISION_FLOAT;
+  } else if (strcmp(value_in, "mixed") == 0) {
+    precision = NEURAL_PRECISION_MIXED;
+  } else {
+    return fail("Unknown precision");
+  }
+  return true;
+}
+
+//Every kind of number is read as a double
+bool StreamHandler::Int(int value_in) { return number(value_in); }
+bool StreamHandler::Uint(unsigned value_in) { return number(value_in); }
+bool StreamHandler::Int64(int64_t value_in) { return number(value_in); }
+bool StreamHandler::Uint64(uint64_t value_in) { return number(value_in); }
+bool StreamHandler::Double(double value_in) { return number(value_in); }
+
+//Containers move the parser between states
+bool StreamHandler::StartObject() { return open(0); }
+bool StreamHandler::EndObject(rapidjson::SizeType members_in) { return close(); }
+bool StreamHandler::StartArray() { return open(1); }
+bool StreamHandler::EndArray(rapidjson::SizeType elements_in) { return close(); }
+
+//Remembers which member the next value belongs to
+bool StreamHandler::Key(const char* value_in, rapidjson::SizeType length_in, bool copy_in)
+{
+  unsigned keyIterator;
+
+  field = STREAM_FIELD_UNKNOWN;
+  if (skipDepth > 0) {
+    return true;
+  }
+  for (keyIterator = 0; keyIterator < sizeof(streamKeys) / sizeof(streamKeys[0]); ++keyIterator) {
+    if (streamKeys[keyIterator].state == state && strlen(streamKeys[keyIterator].name) == length_in && strncmp(streamKeys[keyIterator].name, value_in, length_in) == 0) {
+      field = streamKeys[keyIterator].field;
+      break;
+    }
+  }
+  return true;
+}
+
+const std::string& StreamHandler::getError() const { return error; }
+unsigned StreamHandler::isBuilt() const { return built; }
+
+//Creates a new reader from the specified file
+StreamReader::StreamReader(FILE* file_in)
+{
+  sourceFile = file_in;
+}
+
+//Constructs a network from the topology and applies each neuron and connection as it is parsed
+void StreamReader::read(neural::Network* network_in, double (*activationFunction_in)(double), double (*activationFunctionDerivative_in)(double), double (*deltaInputWeight_in)(double, double, double, double), unsigned storage_in)
+{
+  rapidjson::FileReadStream stream_in(sourceFile, readBuffer, sizeof(readBuffer));
+  rapidjson::Reader reader;
+  StreamHandler handler(network_in, activationFunction_in, activationFunctionDerivative_in, deltaInputWeight_in, storage_in);
+
+  //Iterative parsing keeps the parser's own stack bounded as well, full precision reads back every written weight exactly
+  reader.Parse<rapidjson::kParseIterativeFlag | rapidjson::kParseFullPrecisionFlag>(stream_in, handler);
+
+  //Report problems found by the handler before problems found by the parser
+  if (! handler.getError().empty()) {
+    throw std::runtime_error(handler.getError());
+  }
+  if (reader.HasParseError()) {
+    throw std::runtime_error(rapidjson::GetParseError_En(reader.GetParseErrorCode()));
+  }
+  if (! handler.isBuilt()) {
+    throw std::runtime_error("No topology data found");
+  }
+}
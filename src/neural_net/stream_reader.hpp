@@ -0,0 +1,188 @@
+/***********************************************************
+* Reader that streams a json network straight into a Network
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*   - Read the precision of dense weights
+***********************************************************/
+
+#ifndef _H_NEURAL_STREAM_READER
+#define _H_NEURAL_STREAM_READER
+
+#include <stdexcept>   //std::runtime_error
+#include <stdio.h>     //FILE
+#include <string.h>    //strncmp()    strcmp()
+#include <string>      //std::string
+#include <vector>      //std::vector
+#include <limits>      //std::numeric_limits<double>::quiet_NaN()
+
+#include "../lib/rapidjson/filereadstream.h"
+#include "../lib/rapidjson/reader.h"
+#include "../lib/rapidjson/error/en.h"
+
+#include "network.hpp"
+#include "neuron_data.hpp"
+#include "connection_data.hpp"
+
+#define STREAM_BUFFER_SIZE 65536
+
+//Position of the parser in the document
+#define STREAM_STATE_START       0
+#define STREAM_STATE_ROOT        1
+#define STREAM_STATE_NETWORK     2
+#define STREAM_STATE_TOPOLOGY    3
+#define STREAM_STATE_NEURONS     4
+#define STREAM_STATE_NEURON      5
+#define STREAM_STATE_CONNECTIONS 6
+#define STREAM_STATE_CONNECTION  7
+#define STREAM_STATE_DONE        8
+
+//Member most recently named by a key
+#define STREAM_FIELD_UNKNOWN      0
+#define STREAM_FIELD_NETWORK      1
+#define STREAM_FIELD_TOPOLOGY     2
+#define STREAM_FIELD_NEURONS      3
+#define STREAM_FIELD_CONNECTIONS  4
+#define STREAM_FIELD_LAYER        5
+#define STREAM_FIELD_NEURON       6
+#define STREAM_FIELD_BIAS         7
+#define STREAM_FIELD_OUTPUT       8
+#define STREAM_FIELD_GRADIENT     9
+#define STREAM_FIELD_SOURCE_LAYER 10
+#define STREAM_FIELD_SOURCE       11
+#define STREAM_FIELD_DEST_LAYER   12
+#define STREAM_FIELD_DEST         13
+#define STREAM_FIELD_WEIGHT       14
+#define STREAM_FIELD_DELTA_WEIGHT 15
+#define STREAM_FIELD_PRECISION    16
+
+//Receives parse events and applies each neuron and connection as soon as it is complete
+class StreamHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, StreamHandler>
+{
+private:
+  /* Network being filled */
+  neural::Network* network;
+
+  /* Arguments used to construct the network once the topology is known */
+  double (*activationFunction)(double);
+  double (*activationFunctionDerivative)(double);
+  double (*deltaInputWeight)(double, double, double, double);
+  unsigned storage;
+
+  /* NEURAL_PRECISION_* named by the file, double when it names none */
+  unsigned precision;
+
+  /* Non-bias neurons in each layer read so far */
+  std::vector<unsigned> topology;
+
+  /* Flags if the network has been constructed */
+  unsigned built;
+
+  /* Position of the parser in the document */
+  unsigned state;
+
+  /* Member most recently named by a key */
+  unsigned field;
+
+  /* Depth of the unrecognized value being skipped, 0 when not skipping */
+  unsigned skipDepth;
+
+  /* Fields seen in the current neuron or connection */
+  unsigned seen;
+
+  /* Neuron being read */
+  neuron_data neuron;
+
+  /* Connection being read */
+  connection_data connection;
+
+  /* Description of the first problem found */
+  std::string error;
+
+  /*****************
+  * Records a problem and stops the parse
+  * @param message_in description of the problem
+  *****************/
+  bool fail(const char* message_in);
+
+  /*****************
+  * Handles a number value
+  * @param value_in value read
+  *****************/
+  bool number(double value_in);
+
+  /*****************
+  * Handles the start of an object or array
+  * @param array_in 1 for an array, 0 for an object
+  *****************/
+  bool open(unsigned array_in);
+
+  /*****************
+  * Handles the end of an object or array
+  *****************/
+  bool close();
+
+public:
+  /*****************
+  * Creates a handler that fills the specified network
+  * @param network_in network to construct and fill
+  *****************/
+  StreamHandler(neural::Network* network_in, double (*activationFunction_in)(double), double (*activationFunctionDerivative_in)(double), double (*deltaInputWeight_in)(double, double, double, double), unsigned storage_in);
+
+  //rapidjson handler interface
+  bool Null();
+  bool Bool(bool value_in);
+  bool Int(int value_in);
+  bool Uint(unsigned value_in);
+  bool Int64(int64_t value_in);
+  bool Uint64(uint64_t value_in);
+  bool Double(double value_in);
+  bool String(const char* value_in, rapidjson::SizeType length_in, bool copy_in);
+  bool StartObject();
+  bool Key(const char* value_in, rapidjson::SizeType length_in, bool copy_in);
+  bool EndObject(rapidjson::SizeType members_in);
+  bool StartArray();
+  bool EndArray(rapidjson::SizeType elements_in);
+
+  /*****************
+  * Returns the first problem found, empty if there was none
+  *****************/
+  const std::string& getError() const;
+
+  /*****************
+  * Checks if the whole network was read
+  * @return 1 The network was constructed
+  *****************/
+  unsigned isBuilt() const;
+};
+
+class StreamReader
+{
+private:
+  /* File the network is read from */
+  FILE* sourceFile;
+
+  /* Buffer the file is read through, the only part of the document held in memory */
+  char readBuffer[STREAM_BUFFER_SIZE];
+
+public:
+  /*****************
+  * Creates a new reader from the specified file
+  * @param file_in file to read from
+  *****************/
+  StreamReader(FILE* file_in);
+
+  /*****************
+  * Constructs a network from the topology and applies each neuron and connection as it is parsed
+  *   The topology must come before the neurons and connections in the file
+  *   A precision named by the file must come before the topology and needs dense storage
+  * @param network_in network to construct and fill
+  * @param storage_in How the network stores connections (NEURAL_STORAGE_*)
+  *****************/
+  void read(neural::Network* network_in, double (*activationFunction_in)(double), double (*activationFunctionDerivative_in)(double), double (*deltaInputWeight_in)(double, double, double, double), unsigned storage_in = NEURAL_STORAGE_GRAPH);
+};
+
+#endif
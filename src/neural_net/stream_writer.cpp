@@ -0,0 +1,243 @@
+//Writer that streams a neural network to a json file as it is visited
+
+#include "stream_writer.hpp"
+
+//Creates a new writer to the specified file and starts the network object
+StreamWriter::StreamWriter(FILE* file_in) : stream(file_in, writeBuffer, sizeof(writeBuffer)), jsonWriter(stream)
+{
+  destinationFile = file_in;
+  section = STREAM_SECTION_NONE;
+
+  //Open the document and network objects
+  jsonWriter.StartObject();
+  jsonWriter.Key("network");
+  jsonWriter.StartObject();
+}
+
+//Closes the current array and opens the specified one
+void StreamWriter::openSection(unsigned section_in)
+{
+  //Already writing the requested array
+  if (section == section_in) {
+    return;
+  }
+  if (section > section_in) {
+    throw std::runtime_error("Topology, neurons and connections must be written in order");
+  }
+  //Close the previous array
+  if (section != STREAM_SECTION_NONE) {
+    jsonWriter.EndArray();
+  }
+  section = section_in;
+  switch (section) {
+  case STREAM_SECTION_TOPOLOGY:
+    jsonWriter.Key("topology");
+    break;
+  case STREAM_SECTION_NEURONS:
+    jsonWriter.Key("neurons");
+    break;
+  case STREAM_SECTION_CONNECTIONS:
+    jsonWriter.Key("connections");
+    break;
+  default:
+    return;
+  }
+  jsonWriter.StartArray();
+}
+
+//Writes the precision of the dense weights
+void StreamWriter::addPrecision(unsigned precision_in)
+{
+  if (section != STREAM_SECTION_NONE) {
+    throw std::runtime_error("Precision must be written before the topology");
+  }
+  switch (precision_in) {
+  case NEURAL_PRECISION_FLOAT:
+    jsonWriter.Key("precision");
+    jsonWriter.String("float");
+    break;
+  case NEURAL_PRECISION_MIXED:
+    jsonWriter.Key("precision");
+    jsonWriter.String("mixed");
+    break;
+  }
+}
+
+//Writes a layer to the topology
+void StreamWriter::addLayer(unsigned neurons_in)
+{
+  openSection(STREAM_SECTION_TOPOLOGY);
+  jsonWriter.Uint(neurons_in);
+}
+
+//Writes a neuron
+void StreamWriter::addNeuron(neuron_data& neuron_in)
+{
+  openSection(STREAM_SECTION_NEURONS);
+  jsonWriter.StartObject();
+  //Add the id of the neuron
+  jsonWriter.Key("layer");
+  jsonWriter.Uint(neuron_in.neuron.layer + 1);
+  jsonWriter.Key("neuron");
+  jsonWriter.Uint(neuron_in.neuron.neuron + 1);
+  jsonWriter.Key("bias");
+  jsonWriter.Uint(neuron_in.bias);
+  //If the specified neuron has an output store it
+  if (! std::isnan(neuron_in.output)) {
+    jsonWriter.Key("output");
+    jsonWriter.Double(neuron_in.output);
+  }
+  //If specified neuron has gradient store it
+  if (! std::isnan(neuron_in.gradient)) {
+    jsonWriter.Key("gradient");
+    jsonWriter.Double(neuron_in.gradient);
+  }
+  jsonWriter.EndObject();
+}
+
+//Writes a connection
+void StreamWriter::addConnection(connection_data& connection_in)
+{
+  openSection(STREAM_SECTION_CONNECTIONS);
+  jsonWriter.StartObject();
+  //Add id of source neuron
+  jsonWriter.Key("sourceLayer");
+  jsonWriter.Uint(connection_in.source.layer + 1);
+  jsonWriter.Key("sourceNeuron");
+  jsonWriter.Uint(connection_in.source.neuron + 1);
+  //Add id of destination neuron
+  jsonWriter.Key("destLayer");
+  jsonWriter.Uint(connection_in.destination.layer + 1);
+  jsonWriter.Key("destNeuron");
+  jsonWriter.Uint(connection_in.destination.neuron + 1);
+  //If specified connection has weight store it
+  if (! std::isnan(connection_in.weight)) {
+    jsonWriter.Key("weight");
+    jsonWriter.Double(connection_in.weight);
+  }
+  //If specified neuron has delta weight store it
+  if (! std::isnan(connection_in.deltaWeight)) {
+    jsonWriter.Key("deltaWeight");
+    jsonWriter.Double(connection_in.deltaWeight);
+  }
+  jsonWriter.EndObject();
+}
+
+//Finds where a graph connection starts from the neuron's place in its layer's neuron array
+void StreamWriter::findSource(neural::Network* network_in, const neural::Neuron* neuron_in, neuron_id* id_out)
+{
+  unsigned layerIterator;
+  neural::Layer* layer;
+  const neural::Neuron* first;
+  std::less<const neural::Neuron*> before;
+
+  //Each layer holds its neurons in one array, so the source is in the layer whose array spans it
+  for (layerIterator = 1; layerIterator <= network_in->numLayers(); ++layerIterator) {
+    layer = network_in->getLayer(layerIterator);
+    if (layer->numNeurons() == 0) {
+      continue;
+    }
+    first = layer->getNeuron(1);
+    if (! before(neuron_in, first) && before(neuron_in, first + layer->numNeurons())) {
+      id_out->layer = layerIterator - 1;
+      id_out->neuron = neuron_in - first;
+      return;
+    }
+  }
+  throw std::runtime_error("Connection starts outside the network");
+}
+
+//Closes the open array and the network object and flushes the file
+void StreamWriter::finish()
+{
+  if (section == STREAM_SECTION_FINISHED) {
+    return;
+  }
+  openSection(STREAM_SECTION_FINISHED);
+  //Close the network and document objects
+  jsonWriter.EndObject();
+  jsonWriter.EndObject();
+  stream.Flush();
+}
+
+//Writes the whole network one layer, neuron and connection at a time then finishes the document
+void StreamWriter::write(neural::Network* network_in)
+{
+  unsigned layerIterator;
+  unsigned neuronIterator;
+  unsigned inputIterator;
+  unsigned entryIterator;
+  neural::Layer* layer;
+  neuron_data neuron;
+  connection_data connection;
+  neural::Neuron* destination;
+  neural::Connection* input;
+
+  addPrecision(network_in->getPrecision());
+
+  //Hit each layer
+  for (layerIterator = 1; layerIterator <= network_in->numLayers(); ++layerIterator) {
+    addLayer(network_in->getLayer(layerIterator)->numNeurons());
+  }
+
+  //Hit each neuron in each layer
+  for (layerIterator = 1; layerIterator <= network_in->numLayers(); ++layerIterator) {
+    layer = network_in->getLayer(layerIterator);
+    neuron.neuron.layer = layerIterator - 1;
+    for (neuronIterator = 1; neuronIterator <= layer->numNeurons(); ++neuronIterator) {
+      neuron.neuron.neuron = neuronIterator - 1;
+      layer->getNeuron(neuronIterator)->getData(&neuron);
+      addNeuron(neuron);
+    }
+  }
+
+  //Hit each connection into each layer
+  for (layerIterator = 2; layerIterator <= network_in->numLayers(); ++layerIterator) {
+    layer = network_in->getLayer(layerIterator);
+    //Each input of each graph neuron is a connection
+    if (! layer->isDense()) {
+      connection.destination.layer = layerIterator - 1;
+      for (neuronIterator = 1; neuronIterator <= layer->numNeurons(); ++neuronIterator) {
+        destination = layer->getNeuron(neuronIterator);
+        connection.destination.neuron = neuronIterator - 1;
+        for (inputIterator = 0; inputIterator < destination->numInputs(); ++inputIterator) {
+          input = destination->getInput(inputIterator);
+          //Graph connections may start in any layer
+          findSource(network_in, input->getStart(), &connection.source);
+          connection.weight = input->getWeight();
+          connection.deltaWeight = input->getDeltaWeight();
+          addConnection(connection);
+        }
+      }
+      continue;
+    }
+    connection.source.layer = layerIterator - 2;
+    connection.destination.layer = layerIterator - 1;
+    //Only the entries of a sparse matrix are connections
+    if (layer->isSparse()) {
+      layer->compressSparse();
+      for (neuronIterator = 0; neuronIterator < layer->numNeurons() - layer->numBias(); ++neuronIterator) {
+        connection.destination.neuron = neuronIterator;
+        for (entryIterator = layer->sparseRowStarts()[neuronIterator]; entryIterator < layer->sparseRowStarts()[neuronIterator + 1]; ++entryIterator) {
+          connection.source.neuron = layer->sparseColumns()[entryIterator];
+          connection.weight = layer->weightData()[entryIterator];
+          connection.deltaWeight = layer->deltaWeightData()[entryIterator];
+          addConnection(connection);
+        }
+      }
+      continue;
+    }
+    //Every entry of the layer's matrix is a connection
+    for (neuronIterator = 0; neuronIterator < layer->numNeurons() - layer->numBias(); ++neuronIterator) {
+      connection.destination.neuron = neuronIterator;
+      for (inputIterator = 0; inputIterator < layer->numInputs(); ++inputIterator) {
+        connection.source.neuron = inputIterator;
+        connection.weight = layer->getWeight(neuronIterator, inputIterator);
+        connection.deltaWeight = layer->getDeltaWeight(neuronIterator, inputIterator);
+        addConnection(connection);
+      }
+    }
+  }
+
+  finish();
+}
@@ -0,0 +1,115 @@
+/***********************************************************
+* Writer that streams a neural network to a json file as it is visited
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified: October 17, 2026
+*   - Created Initially
+*   - Wrote the precision of dense weights
+*   - Wrote the connections of graph layers
+*   - Found graph connection sources without an index of every neuron
+***********************************************************/
+
+#ifndef _H_NEURAL_STREAM_WRITER
+#define _H_NEURAL_STREAM_WRITER
+
+#include <stdexcept>   //std::runtime_error
+#include <stdio.h>     //FILE
+#include <cmath>       //std::isnan()
+#include <functional>  //std::less
+
+#include "../lib/rapidjson/filewritestream.h"
+#include "../lib/rapidjson/writer.h"
+
+#include "network.hpp"
+#include "neuron_id.hpp"
+#include "neuron_data.hpp"
+#include "connection_data.hpp"
+
+#define STREAM_WRITE_BUFFER_SIZE 65536
+
+//Array of the network object currently being written
+#define STREAM_SECTION_NONE        0
+#define STREAM_SECTION_TOPOLOGY    1
+#define STREAM_SECTION_NEURONS     2
+#define STREAM_SECTION_CONNECTIONS 3
+#define STREAM_SECTION_FINISHED    4
+
+class StreamWriter
+{
+private:
+  /* File the network is written to */
+  FILE* destinationFile;
+
+  /* Buffer the file is written through, the only part of the document held in memory */
+  char writeBuffer[STREAM_WRITE_BUFFER_SIZE];
+
+  /* Stream over the destination file */
+  rapidjson::FileWriteStream stream;
+
+  /* Emits json tokens to the stream */
+  rapidjson::Writer<rapidjson::FileWriteStream> jsonWriter;
+
+  /* Array of the network object currently being written */
+  unsigned section;
+
+  /*****************
+  * Closes the current array and opens the specified one
+  * @param section_in STREAM_SECTION_* to open, sections must be opened in order
+  *****************/
+  void openSection(unsigned section_in);
+
+  /*****************
+  * Finds where a graph connection starts from the neuron's place in its layer's neuron array
+  * @param network_in Network the neuron belongs to
+  * @param neuron_in  Neuron the connection starts at
+  * @param id_out     Location to store the layer and neuron, both zero-based
+  *****************/
+  static void findSource(neural::Network* network_in, const neural::Neuron* neuron_in, neuron_id* id_out);
+
+public:
+  /*****************
+  * Creates a new writer to the specified file and starts the network object
+  * @param file_in file to write to
+  *****************/
+  StreamWriter(FILE* file_in);
+
+  /*****************
+  * Writes the precision of the dense weights, must come before the topology
+  *   Double precision is the default and is not written
+  * @param precision_in NEURAL_PRECISION_* of the weights
+  *****************/
+  void addPrecision(unsigned precision_in);
+
+  /*****************
+  * Writes a layer to the topology
+  * @param neurons_in amount of neurons (including bias) in new layer
+  *****************/
+  void addLayer(unsigned neurons_in);
+
+  /*****************
+  * Writes a neuron, every layer must already be written
+  * @param neuron_in neuron to be written
+  *****************/
+  void addNeuron(neuron_data& neuron_in);
+
+  /*****************
+  * Writes a connection, every neuron must already be written
+  * @param connection_in connection to be written
+  *****************/
+  void addConnection(connection_data& connection_in);
+
+  /*****************
+  * Closes the open array and the network object and flushes the file
+  *****************/
+  void finish();
+
+  /*****************
+  * Writes the whole network one layer, neuron and connection at a time then finishes the document
+  * @param network_in network to write
+  *****************/
+  void write(neural::Network* network_in);
+};
+
+#endif
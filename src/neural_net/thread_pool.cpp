@@ -0,0 +1,133 @@
+//Persistent pool of worker threads that split a range of work items
+#include "thread_pool.hpp"
+
+namespace neural
+{
+  //Creates a new pool
+  ThreadPool::ThreadPool(unsigned threads_in, unsigned threshold_in)
+  {
+    unsigned workerIterator;
+
+    task = NULL;
+    items = 0;
+    generation = 0;
+    pending = 0;
+    stopping = 0;
+    threshold = threshold_in;
+
+    //The calling thread always takes the first part
+    for (workerIterator = 1; workerIterator < threads_in; ++workerIterator) {
+      workers.push_back(std::thread(&ThreadPool::work, this, workerIterator));
+    }
+  }
+
+  //Stops and joins every worker
+  ThreadPool::~ThreadPool()
+  {
+    unsigned workerIterator;
+
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      stopping = 1;
+    }
+    wake.notify_all();
+    for (workerIterator = 0; workerIterator < workers.size(); ++workerIterator) {
+      workers[workerIterator].join();
+    }
+  }
+
+  //Loop run by each worker thread
+  void ThreadPool::work(unsigned worker_in)
+  {
+    unsigned seen;
+
+    seen = 0;
+    while (true) {
+      std::unique_lock<std::mutex> guard(lock);
+      //Sleep until there is a range this worker has not run yet
+      while (! stopping && generation == seen) {
+        wake.wait(guard);
+      }
+      if (stopping) {
+        return;
+      }
+      seen = generation;
+      guard.unlock();
+
+      runPart(worker_in);
+
+      //Let the calling thread know once the last part is done
+      guard.lock();
+      if (--pending == 0) {
+        done.notify_one();
+      }
+    }
+  }
+
+  //Runs one thread's share of the current range
+  void ThreadPool::runPart(unsigned worker_in)
+  {
+    unsigned threads;
+    unsigned begin;
+    unsigned end;
+
+    threads = workers.size() + 1;
+    begin = (unsigned long long) items * worker_in / threads;
+    end = (unsigned long long) items * (worker_in + 1) / threads;
+    if (begin == end) {
+      return;
+    }
+    try {
+      (*task)(begin, end);
+    } catch (...) {
+      //Keep the first failure to rethrow on the calling thread
+      std::unique_lock<std::mutex> guard(lock);
+      if (! failure) {
+        failure = std::current_exception();
+      }
+    }
+  }
+
+  //Splits a range of items into one contiguous part per thread and waits for every part
+  void ThreadPool::run(unsigned items_in, const std::function<void(unsigned, unsigned)> &task_in)
+  {
+    std::exception_ptr thrown;
+
+    //Small ranges cost more to hand out than to run
+    if (workers.empty() || items_in < threshold) {
+      if (items_in > 0) {
+        task_in(0, items_in);
+      }
+      return;
+    }
+
+    //Publish the range and wake the workers
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      task = &task_in;
+      items = items_in;
+      pending = workers.size();
+      failure = NULL;
+      ++generation;
+    }
+    wake.notify_all();
+
+    //Run the first part on this thread then wait for the rest
+    runPart(0);
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      while (pending != 0) {
+        done.wait(guard);
+      }
+      task = NULL;
+      thrown = failure;
+      failure = NULL;
+    }
+    if (thrown) {
+      std::rethrow_exception(thrown);
+    }
+  }
+
+  unsigned ThreadPool::numThreads() const { return workers.size() + 1; }
+  unsigned ThreadPool::getThreshold() const { return threshold; }
+}
@@ -0,0 +1,89 @@
+/***********************************************
+* Persistent pool of worker threads that split a range of work items.
+*
+* Created By: Nick DelBen
+* Created On: October 17, 2026
+*
+* Last Modified:
+*   October 17, 2026 - Created Initially
+***********************************************/
+
+#ifndef _H_NEURAL_THREAD_POOL
+#define _H_NEURAL_THREAD_POOL
+
+#include <vector>               //std::vector
+#include <thread>               //std::thread
+#include <mutex>                //std::mutex    std::unique_lock
+#include <condition_variable>   //std::condition_variable
+#include <functional>           //std::function
+#include <exception>            //std::exception_ptr
+
+//Ranges with fewer items than this are run on the calling thread
+#define NEURAL_PARALLEL_THRESHOLD 64
+
+namespace neural
+{
+  class ThreadPool
+  {
+  private:
+    /* Threads waiting for work, the calling thread is not included */
+    std::vector<std::thread> workers;
+    /* Guards every member below */
+    std::mutex lock;
+    /* Signals workers that a new range is ready or the pool is stopping */
+    std::condition_variable wake;
+    /* Signals the calling thread that every worker has finished its part */
+    std::condition_variable done;
+    /* Work currently being split between the threads */
+    const std::function<void(unsigned, unsigned)>* task;
+    /* Number of items in the current range */
+    unsigned items;
+    /* Incremented for every range so workers can tell new work from old */
+    unsigned generation;
+    /* Workers that have not yet finished the current range */
+    unsigned pending;
+    /* Flags the workers to exit */
+    unsigned stopping;
+    /* Smallest range worth splitting between threads */
+    unsigned threshold;
+    /* First exception thrown by a worker in the current range */
+    std::exception_ptr failure;
+
+    /****************
+    * Loop run by each worker thread
+    * @param worker_in Index of the worker, the calling thread is 0
+    ****************/
+    void work(unsigned worker_in);
+
+    /****************
+    * Runs one thread's share of the current range
+    * @param worker_in Index of the thread, the calling thread is 0
+    ****************/
+    void runPart(unsigned worker_in);
+
+  public:
+    /****************
+    * Creates a new pool
+    * @param threads_in   Threads to split work between, including the calling thread
+    * @param threshold_in Smallest range worth splitting between threads
+    ****************/
+    ThreadPool(unsigned threads_in, unsigned threshold_in);
+
+    /****************
+    * Stops and joins every worker
+    ****************/
+    ~ThreadPool();
+
+    /****************
+    * Splits a range of items into one contiguous part per thread and waits for every part
+    * @param items_in Number of items in the range
+    * @param task_in  Function called with the first and one past the last item of each part
+    ****************/
+    void run(unsigned items_in, const std::function<void(unsigned, unsigned)> &task_in);
+
+    unsigned numThreads() const;
+    unsigned getThreshold() const;
+  };
+}
+
+#endif
@@ -59,7 +59,7 @@ void Writer::addNeuron(neuron_data& neuron_in)
   }
   //If the specified neuron has an output store it
   if (! std::isnan(neuron_in.output)) {
-    neuron_new.AddMember("output", rapidjson::Value().SetDouble(neuron_in.bias), *allocator);
+    neuron_new.AddMember("output", rapidjson::Value().SetDouble(neuron_in.output), *allocator);
   }
   //If specified neuron has gradient store it
   if (! std::isnan(neuron_in.gradient)) {
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+#include <cmath>
+
+#include "neural_net/stream_reader.hpp"
+#include "neural_net/binary_model.hpp"
+#include "neural_net/network.hpp"
+#include "neural_net/inference_server.hpp"
+
+#define TRAINING_RATE     0.15
+#define TRAINING_MOMENTUM 0.5
+static double deltaInputWeight(double neuronGradient_in, double weight_in, double deltaWeight_in, double inputNeuronValue_in)
+{
+  return TRAINING_RATE * inputNeuronValue_in * neuronGradient_in + TRAINING_MOMENTUM * deltaWeight_in;
+}
+
+static double activation(double value_in)
+{
+  return tanh(value_in);
+}
+
+static double activationDerivative(double value_in)
+{
+  return 1.0 - value_in * value_in;
+}
+
+//Prints the server's counters as one json object
+static void printStats(const server_stats* stats_in)
+{
+  printf("{\"requests\":%llu,\"batches\":%llu,\"rejected\":%llu,\"failed\":%llu,\"seconds\":%.3f,\"requests_per_sec\":%.1f,\"mean_batch\":%.2f,\"p50_us\":%.1f,\"p99_us\":%.1f}\n",
+         (unsigned long long) stats_in->requests, (unsigned long long) stats_in->batches, (unsigned long long) stats_in->rejected, (unsigned long long) stats_in->failed,
+         stats_in->seconds, stats_in->requestsPerSec, stats_in->meanBatch, stats_in->p50Micros, stats_in->p99Micros);
+}
+
+/****************
+* Asks a running server for its counters or one prediction and prints the answer
+* @param argc Number of arguments
+* @param argv Program name, stats or predict, the socket and for a prediction its input values
+****************/
+static int query(int argc, char** argv)
+{
+  int client;
+  unsigned valueIterator;
+  server_request request;
+  server_response response;
+  server_stats stats;
+  std::vector<double> values;
+
+  try {
+    client = neural::InferenceServer::connectTo(argv[2]);
+  } catch (std::exception& error) {
+    fprintf(stderr, "%s\n", error.what());
+    return 1;
+  }
+
+  //Send the request
+  if (strcmp(argv[1], "stats") == 0) {
+    request.kind = NEURAL_SERVER_STATS;
+  } else {
+    request.kind = NEURAL_SERVER_PREDICT;
+    for (valueIterator = 3; valueIterator < (unsigned) argc; ++valueIterator) {
+      values.push_back(atof(argv[valueIterator]));
+    }
+  }
+  request.bytes = values.size() * sizeof(double);
+  if (! neural::InferenceServer::writeAll(client, &request, sizeof(request)) || ! neural::InferenceServer::writeAll(client, values.data(), request.bytes) ||
+      ! neural::InferenceServer::readAll(client, &response, sizeof(response))) {
+    fprintf(stderr, "Server closed the connection\n");
+    close(client);
+    return 1;
+  }
+  if (response.status != NEURAL_SERVER_OK) {
+    fprintf(stderr, "Server refused the request\n");
+    close(client);
+    return 1;
+  }
+
+  //Print the answer
+  if (request.kind == NEURAL_SERVER_STATS) {
+    if (response.bytes != sizeof(stats) || ! neural::InferenceServer::readAll(client, &stats, sizeof(stats))) {
+      fprintf(stderr, "Malformed stats from server\n");
+      close(client);
+      return 1;
+    }
+    printStats(&stats);
+  } else {
+    values.resize(response.bytes / sizeof(double));
+    if (! neural::InferenceServer::readAll(client, values.data(), response.bytes)) {
+      fprintf(stderr, "Server closed the connection\n");
+      close(client);
+      return 1;
+    }
+    for (valueIterator = 0; valueIterator < values.size(); ++valueIterator) {
+      printf(valueIterator + 1 < values.size() ? "%f " : "%f\n", values[valueIterator]);
+    }
+  }
+
+  close(client);
+  return 0;
+}
+
+//Serves predictions from a json or binary network over a Unix domain socket until interrupted, or queries a running server
+int main(int argc, char** argv)
+{
+  FILE* file_in;
+  size_t length;
+  sigset_t signals;
+  int received;
+  server_stats stats;
+  neural::Network net;
+
+  if (argc >= 3 && (strcmp(argv[1], "stats") == 0 || strcmp(argv[1], "predict") == 0)) {
+    return query(argc, argv);
+  }
+  if (argc < 3 || argc > 5) {
+    fprintf(stderr, "Usage: %s <network.json|network.bin> <socket> [batch] [latency_us]\n", argv[0]);
+    fprintf(stderr, "       %s stats <socket>\n", argv[0]);
+    fprintf(stderr, "       %s predict <socket> <input> ...\n", argv[0]);
+    return 1;
+  }
+
+  //Every thread the server starts leaves the stop signals to this one
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+  try {
+    //Json networks are parsed, anything else is mapped as a binary network
+    length = strlen(argv[1]);
+    if (length > 5 && strcmp(argv[1] + length - 5, ".json") == 0) {
+      file_in = fopen(argv[1], "r");
+      if (file_in == NULL) {
+        throw std::runtime_error("Unable to open network");
+      }
+      StreamReader reader(file_in);
+      reader.read(&net, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_DENSE);
+      fclose(file_in);
+    } else {
+      net = neural::Network(std::make_shared<BinaryModel>(argv[1]), activation, activationDerivative, deltaInputWeight);
+    }
+
+    neural::InferenceServer server(&net, argv[2], argc > 3 ? atoi(argv[3]) : NEURAL_SERVER_BATCH, argc > 4 ? atoi(argv[4]) : NEURAL_SERVER_LATENCY);
+    fprintf(stderr, "Serving %s on %s\n", argv[1], argv[2]);
+
+    //Serve until interrupted then report what was served
+    sigwait(&signals, &received);
+    server.stop();
+    server.getStats(&stats);
+    printStats(&stats);
+  } catch (std::exception& error) {
+    fprintf(stderr, "%s\n", error.what());
+    return 1;
+  }
+
+  return 0;
+}
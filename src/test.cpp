@@ -0,0 +1,885 @@
+//Correctness checks for the vector kernels against their scalar references and for the network against its reference paths
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>          //DBL_EPSILON    FLT_EPSILON
+#include <cmath>            //fabs()    tanh()
+#include <random>           //std::mt19937
+#include <vector>           //std::vector
+#include <algorithm>        //std::max()
+
+#include "neural_net/network.hpp"
+#include "neural_net/kernels.hpp"
+#include "neural_net/data_parallel_trainer.hpp"
+#include "neural_net/stream_writer.hpp"
+#include "neural_net/stream_reader.hpp"
+#include "neural_net/quantized_network.hpp"
+#include "neural_net/mapped_samples.hpp"
+
+//Seed for every array and sample so each run checks the same values
+#define TEST_SEED 1
+//Every length up to this is checked so each vector width's tail is hit with every remainder
+#define TEST_SHORT_LENGTHS 70
+//Longer lengths checked, odd so the tail is never empty
+#define TEST_LONG_LENGTH_A 257
+#define TEST_LONG_LENGTH_B 1001
+//Values written past the end of every output array, which no kernel may touch
+#define TEST_GUARD 8
+#define TEST_GUARD_VALUE -12345.0
+//Thread counts the data-parallel trainer must give the same weights on
+static const unsigned trainerThreads[] = {1, 2, 3, 5, 8, 13};
+//Samples in each trainer batch, not a multiple of the shards so the shards are uneven
+#define TEST_TRAINER_SAMPLES 37
+#define TEST_TRAINER_BATCHES 3
+//Step of the central differences a gradient is checked against, and how far apart the two may be
+#define TEST_GRADIENT_STEP      1e-5
+#define TEST_GRADIENT_TOLERANCE 1e-7
+//Samples in the softmax batch
+#define TEST_SOFTMAX_SAMPLES 9
+//Steps graph and dense storage train side by side, and how far apart their outputs may drift
+#define TEST_GRAPH_STEPS     200
+#define TEST_GRAPH_TOLERANCE 5e-10
+//Steps sparse and dense storage train side by side, and how far apart their outputs may drift, their sums run in different orders
+#define TEST_SPARSE_STEPS     100
+#define TEST_SPARSE_TOLERANCE 1e-10
+//Weights smaller in magnitude than this are pruned
+#define TEST_PRUNE_THRESHOLD 0.2
+//Calibration and checked samples of the int8 network, and how far its outputs may be from the double network's, 3% of the output range
+#define TEST_QUANTIZED_SAMPLES   32
+#define TEST_QUANTIZED_TOLERANCE 0.06
+//How far a frozen copy's outputs may be from the network's, its biases are added after the sum so the last bits differ
+#define TEST_FROZEN_TOLERANCE 1e-12
+//Passes over the xor table a graph network gets to learn it, and the error it must end below
+#define TEST_XOR_PASSES 2000
+#define TEST_XOR_ERROR  0.05
+
+#define TRAINING_RATE     0.15
+#define TRAINING_MOMENTUM 0.5
+static double deltaInputWeight(double neuronGradient_in, double weight_in, double deltaWeight_in, double inputNeuronValue_in)
+{
+  return TRAINING_RATE * inputNeuronValue_in * neuronGradient_in + TRAINING_MOMENTUM * deltaWeight_in;
+}
+
+static double activation(double value_in)
+{
+  return tanh(value_in);
+}
+
+static double activationDerivative(double value_in)
+{
+  return 1.0 - value_in * value_in;
+}
+
+//Moves each weight by its whole gradient, so one update reads back the gradient of the error
+static double gradientStep(double neuronGradient_in, double weight_in, double deltaWeight_in, double inputNeuronValue_in)
+{
+  return inputNeuronValue_in * neuronGradient_in;
+}
+
+/* Checks that failed */
+static unsigned failures = 0;
+
+//Prints the result of one check
+static void report(const char* check_in, const char* kernel_in, unsigned failed_in)
+{
+  printf("%-24s %-8s %s\n", check_in, kernel_in, failed_in ? "FAILED" : "ok");
+  if (failed_in) {
+    ++failures;
+  }
+}
+
+//Lengths every kernel is checked on
+static std::vector<unsigned> testLengths()
+{
+  std::vector<unsigned> lengths;
+  unsigned lengthIterator;
+
+  for (lengthIterator = 0; lengthIterator <= TEST_SHORT_LENGTHS; ++lengthIterator) {
+    lengths.push_back(lengthIterator);
+  }
+  lengths.push_back(TEST_LONG_LENGTH_A);
+  lengths.push_back(TEST_LONG_LENGTH_B);
+  return lengths;
+}
+
+//Checks a reordered sum against the reference, which it may differ from by the rounding of each addition
+static unsigned closeSum(double value_in, double reference_in, double magnitude_in, unsigned length_in, double epsilon_in)
+{
+  return fabs(value_in - reference_in) <= 2.0 * (length_in + 1) * epsilon_in * magnitude_in;
+}
+
+//Checks every kernel of the selected implementation against the scalar reference
+static void checkKernels(const char* kernel_in)
+{
+  std::mt19937 generator(TEST_SEED);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::vector<unsigned> lengths;
+  std::vector<double> a;
+  std::vector<double> b;
+  std::vector<double> y;
+  std::vector<double> expected;
+  std::vector<float> af;
+  std::vector<float> bf;
+  std::vector<float> yf;
+  std::vector<float> expectedf;
+  std::vector<unsigned> index;
+  std::vector<int8_t> a8;
+  std::vector<int8_t> b8;
+  std::vector<uint32_t> words;
+  std::vector<uint32_t> expectedWords;
+  unsigned lengthIterator;
+  unsigned valueIterator;
+  unsigned offset;
+  unsigned length;
+  double magnitude;
+  double scale;
+  unsigned failed[9];
+
+  memset(failed, 0, sizeof(failed));
+  lengths = testLengths();
+  for (lengthIterator = 0; lengthIterator < lengths.size(); ++lengthIterator) {
+    length = lengths[lengthIterator];
+    //Start one element in on odd lengths so unaligned loads are checked too
+    offset = length % 2;
+
+    a.resize(length + offset);
+    b.resize(length + offset);
+    af.resize(length + offset);
+    bf.resize(length + offset);
+    index.resize(length);
+    a8.resize(length);
+    b8.resize(length);
+    for (valueIterator = 0; valueIterator < length + offset; ++valueIterator) {
+      a[valueIterator] = uniform(generator);
+      b[valueIterator] = uniform(generator);
+      af[valueIterator] = (float) uniform(generator);
+      bf[valueIterator] = (float) uniform(generator);
+    }
+    for (valueIterator = 0; valueIterator < length; ++valueIterator) {
+      index[valueIterator] = generator() % (length + offset);
+      //The full signed range, -128 included, so the unsigned offset of the VNNI kernel is checked at its edge
+      a8[valueIterator] = (int8_t) (generator() % 256 - 128);
+      b8[valueIterator] = (int8_t) (generator() % 256 - 128);
+    }
+    scale = uniform(generator);
+
+    //Sums are reordered across lanes, so they are checked against the error bound of the reference
+    magnitude = 0.0;
+    for (valueIterator = 0; valueIterator < length; ++valueIterator) {
+      magnitude += fabs(a[offset + valueIterator] * b[offset + valueIterator]);
+    }
+    failed[0] |= ! closeSum(neural::kernels::dot(&a[offset], &b[offset], length), neural::kernels::dotScalar(&a[offset], &b[offset], length), magnitude, length, DBL_EPSILON);
+
+    magnitude = 0.0;
+    for (valueIterator = 0; valueIterator < length; ++valueIterator) {
+      magnitude += fabs((double) af[offset + valueIterator] * bf[offset + valueIterator]);
+    }
+    failed[1] |= ! closeSum(neural::kernels::dotFloat(&af[offset], &bf[offset], length), neural::kernels::dotFloatScalar(&af[offset], &bf[offset], length), magnitude, length, FLT_EPSILON);
+
+    magnitude = 0.0;
+    for (valueIterator = 0; valueIterator < length; ++valueIterator) {
+      magnitude += fabs(af[offset + valueIterator] * b[offset + valueIterator]);
+    }
+    failed[2] |= ! closeSum(neural::kernels::dotMixed(&af[offset], &b[offset], length), neural::kernels::dotMixedScalar(&af[offset], &b[offset], length), magnitude, length, DBL_EPSILON);
+
+    magnitude = 0.0;
+    for (valueIterator = 0; valueIterator < length; ++valueIterator) {
+      magnitude += fabs(a[offset + valueIterator] * b[index[valueIterator]]);
+    }
+    failed[3] |= ! closeSum(neural::kernels::dotSparse(&a[offset], index.data(), b.data(), length), neural::kernels::dotSparseScalar(&a[offset], index.data(), b.data(), length), magnitude, length, DBL_EPSILON);
+
+    //Integer sums are exact in any order
+    failed[4] |= neural::kernels::dotInt8(a8.data(), b8.data(), length) != neural::kernels::dotInt8Scalar(a8.data(), b8.data(), length);
+
+    //Fused multiply-adds round once where the reference rounds twice, and nothing past the end may be written
+    y.assign(b.begin(), b.end());
+    y.resize(length + offset + TEST_GUARD, TEST_GUARD_VALUE);
+    expected = y;
+    neural::kernels::axpy(scale, &a[offset], &y[offset], length);
+    neural::kernels::axpyScalar(scale, &a[offset], &expected[offset], length);
+    for (valueIterator = 0; valueIterator < y.size(); ++valueIterator) {
+      failed[5] |= fabs(y[valueIterator] - expected[valueIterator]) > 2.0 * DBL_EPSILON * (fabs(expected[valueIterator]) + fabs(scale));
+    }
+
+    yf.assign(bf.begin(), bf.end());
+    yf.resize(length + offset + TEST_GUARD, (float) TEST_GUARD_VALUE);
+    expectedf = yf;
+    neural::kernels::axpyFloat((float) scale, &af[offset], &yf[offset], length);
+    neural::kernels::axpyFloatScalar((float) scale, &af[offset], &expectedf[offset], length);
+    for (valueIterator = 0; valueIterator < yf.size(); ++valueIterator) {
+      failed[6] |= fabs(yf[valueIterator] - expectedf[valueIterator]) > 2.0 * FLT_EPSILON * (fabs(expectedf[valueIterator]) + fabs(scale));
+    }
+
+    y.assign(b.begin(), b.end());
+    y.resize(length + offset + TEST_GUARD, TEST_GUARD_VALUE);
+    expected = y;
+    neural::kernels::axpyMixed(scale, &af[offset], &y[offset], length);
+    neural::kernels::axpyMixedScalar(scale, &af[offset], &expected[offset], length);
+    for (valueIterator = 0; valueIterator < y.size(); ++valueIterator) {
+      failed[7] |= fabs(y[valueIterator] - expected[valueIterator]) > 2.0 * DBL_EPSILON * (fabs(expected[valueIterator]) + fabs(scale));
+    }
+
+    //Random numbers must match the reference bit for bit, including the guard after the four rows
+    words.resize(4 * length + TEST_GUARD);
+    for (valueIterator = 0; valueIterator < words.size(); ++valueIterator) {
+      words[valueIterator] = generator();
+    }
+    expectedWords = words;
+    neural::kernels::philox(words.data(), 0x243F6A88u, 0x85A308D3u, length);
+    neural::kernels::philoxScalar(expectedWords.data(), 0x243F6A88u, 0x85A308D3u, length);
+    failed[8] |= words != expectedWords;
+  }
+
+  report("kernel dot", kernel_in, failed[0]);
+  report("kernel dot_float", kernel_in, failed[1]);
+  report("kernel dot_mixed", kernel_in, failed[2]);
+  report("kernel dot_sparse", kernel_in, failed[3]);
+  report("kernel dot_int8", kernel_in, failed[4]);
+  report("kernel axpy", kernel_in, failed[5]);
+  report("kernel axpy_float", kernel_in, failed[6]);
+  report("kernel axpy_mixed", kernel_in, failed[7]);
+  report("kernel philox", kernel_in, failed[8]);
+}
+
+//Creates the network every trainer check starts from, the seeded initializer gives the same weights each time
+static neural::Network trainerNetwork()
+{
+  std::vector<unsigned> topology;
+
+  topology.push_back(6);
+  topology.push_back(12);
+  topology.push_back(3);
+  return neural::Network(topology, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_DENSE);
+}
+
+//Copies every weight and delta weight of a dense network
+static std::vector<double> trainerWeights(neural::Network* network_in)
+{
+  std::vector<double> weights;
+  neural::Layer* layer;
+  unsigned layerIterator;
+
+  for (layerIterator = 2; layerIterator <= network_in->numLayers(); ++layerIterator) {
+    layer = network_in->getLayer(layerIterator);
+    weights.insert(weights.end(), layer->weightData(), layer->weightData() + layer->numConnections());
+    weights.insert(weights.end(), layer->deltaWeightData(), layer->deltaWeightData() + layer->numConnections());
+  }
+  return weights;
+}
+
+//Checks the data-parallel trainer gives the same weights bit for bit on any number of threads
+static void checkTrainer()
+{
+  std::mt19937 generator(TEST_SEED);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::vector<double> values;
+  std::vector<double> targets;
+  std::vector<double> reference;
+  std::vector<double> weights;
+  unsigned valueIterator;
+  unsigned threadIterator;
+  unsigned batchIterator;
+  unsigned failed;
+  char name[32];
+
+  //One set of samples for every batch
+  values.resize(TEST_TRAINER_SAMPLES * 6);
+  targets.resize(TEST_TRAINER_SAMPLES * 3);
+  for (valueIterator = 0; valueIterator < values.size(); ++valueIterator) {
+    values[valueIterator] = uniform(generator);
+  }
+  for (valueIterator = 0; valueIterator < targets.size(); ++valueIterator) {
+    targets[valueIterator] = uniform(generator);
+  }
+
+  //Every thread count must match one thread
+  for (threadIterator = 0; threadIterator < sizeof(trainerThreads) / sizeof(trainerThreads[0]); ++threadIterator) {
+    neural::Network network = trainerNetwork();
+    neural::DataParallelTrainer trainer(&network, trainerThreads[threadIterator]);
+    for (batchIterator = 0; batchIterator < TEST_TRAINER_BATCHES; ++batchIterator) {
+      trainer.trainBatch(values, targets, TEST_TRAINER_SAMPLES);
+    }
+    weights = trainerWeights(&network);
+    if (threadIterator == 0) {
+      reference = weights;
+    }
+    snprintf(name, sizeof(name), "%u_threads", trainerThreads[threadIterator]);
+    report("data_parallel", name, weights.size() != reference.size() || memcmp(weights.data(), reference.data(), weights.size() * sizeof(double)) != 0);
+  }
+
+  //A single shard is the same update as the network's own batch training
+  {
+    neural::Network network = trainerNetwork();
+    neural::Network direct = trainerNetwork();
+    neural::DataParallelTrainer trainer(&network, 1, 1);
+    for (batchIterator = 0; batchIterator < TEST_TRAINER_BATCHES; ++batchIterator) {
+      trainer.trainBatch(values, targets, TEST_TRAINER_SAMPLES);
+      direct.trainBatch(values, targets, TEST_TRAINER_SAMPLES);
+    }
+    weights = trainerWeights(&network);
+    reference = trainerWeights(&direct);
+    failed = weights.size() != reference.size() || memcmp(weights.data(), reference.data(), weights.size() * sizeof(double)) != 0;
+    report("data_parallel", "1_shard", failed);
+  }
+}
+
+//Checks an empty batch is refused without touching the weights
+static void checkEmptyBatch()
+{
+  std::vector<double> empty;
+  std::vector<double> reference;
+  unsigned failed;
+
+  neural::Network network = trainerNetwork();
+  reference = trainerWeights(&network);
+  failed = 1;
+  try {
+    network.trainBatch(empty, empty, 0);
+  } catch (std::runtime_error& error) {
+    failed = 0;
+  }
+  failed |= trainerWeights(&network) != reference;
+  report("empty_batch", "network", failed);
+}
+
+//Finds the cross-entropy of a softmax network's outputs for one sample
+static double crossEntropy(neural::Network* network_in, const std::vector<double> &values_in, const std::vector<double> &targets_in)
+{
+  std::vector<double> results;
+  unsigned valueIterator;
+  double error;
+
+  network_in->feedForward(values_in);
+  network_in->getResults(results);
+  error = 0.0;
+  for (valueIterator = 0; valueIterator < targets_in.size(); ++valueIterator) {
+    error -= targets_in[valueIterator] * log(results[valueIterator]);
+  }
+  return error;
+}
+
+//Checks the fused softmax and cross-entropy gradients against central differences and the batched path against single samples
+static void checkSoftmax()
+{
+  std::mt19937 generator(TEST_SEED);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::vector<unsigned> topology;
+  std::vector<double> values;
+  std::vector<double> targets;
+  std::vector<double> batchValues;
+  std::vector<double> batchTargets;
+  std::vector<double> results;
+  std::vector<double> batchResults;
+  neural::Layer* layer;
+  neural::Layer* updated;
+  unsigned layerIterator;
+  unsigned neuronIterator;
+  unsigned inputIterator;
+  unsigned sampleIterator;
+  unsigned valueIterator;
+  double weight;
+  double numeric;
+  double error;
+  unsigned failed;
+
+  topology.push_back(4);
+  topology.push_back(5);
+  topology.push_back(3);
+  values.resize(4);
+  for (valueIterator = 0; valueIterator < values.size(); ++valueIterator) {
+    values[valueIterator] = uniform(generator);
+  }
+  targets.push_back(0.2);
+  targets.push_back(0.7);
+  targets.push_back(0.1);
+
+  //One update moving each weight by its gradient, made on a copy so the differences start from the same weights
+  neural::Network network(topology, activation, activationDerivative, gradientStep, NEURAL_STORAGE_DENSE);
+  neural::Network stepped(topology, activation, activationDerivative, gradientStep, NEURAL_STORAGE_DENSE);
+  network.setSoftmaxOutput(1);
+  stepped.setSoftmaxOutput(1);
+  stepped.feedForward(values);
+  stepped.backPropagation(targets);
+
+  //Both the softmax layer and the hidden layer below it
+  for (layerIterator = 2; layerIterator <= network.numLayers(); ++layerIterator) {
+    layer = network.getLayer(layerIterator);
+    updated = stepped.getLayer(layerIterator);
+    failed = 0;
+    for (neuronIterator = 0; neuronIterator < layer->numNeurons() - layer->numBias(); ++neuronIterator) {
+      for (inputIterator = 0; inputIterator < layer->numInputs(); ++inputIterator) {
+        weight = layer->getWeight(neuronIterator, inputIterator);
+        layer->setWeight(neuronIterator, inputIterator, weight + TEST_GRADIENT_STEP);
+        numeric = crossEntropy(&network, values, targets);
+        layer->setWeight(neuronIterator, inputIterator, weight - TEST_GRADIENT_STEP);
+        numeric -= crossEntropy(&network, values, targets);
+        numeric /= 2.0 * TEST_GRADIENT_STEP;
+        layer->setWeight(neuronIterator, inputIterator, weight);
+        //The update descends the error, so it is the negative of the numeric gradient
+        failed |= fabs(updated->getWeight(neuronIterator, inputIterator) - weight + numeric) > TEST_GRADIENT_TOLERANCE;
+      }
+    }
+    report("softmax_gradient", layerIterator == network.numLayers() ? "output" : "hidden", failed);
+  }
+
+  //A batch gives each sample the probabilities and the mean cross-entropy it gets alone
+  batchValues.resize(TEST_SOFTMAX_SAMPLES * 4);
+  batchTargets.assign(TEST_SOFTMAX_SAMPLES * 3, 0.0);
+  for (valueIterator = 0; valueIterator < batchValues.size(); ++valueIterator) {
+    batchValues[valueIterator] = uniform(generator);
+  }
+  error = 0.0;
+  failed = 0;
+  for (sampleIterator = 0; sampleIterator < TEST_SOFTMAX_SAMPLES; ++sampleIterator) {
+    batchTargets[sampleIterator * 3 + sampleIterator % 3] = 1.0;
+    values.assign(&batchValues[sampleIterator * 4], &batchValues[(sampleIterator + 1) * 4]);
+    targets.assign(&batchTargets[sampleIterator * 3], &batchTargets[(sampleIterator + 1) * 3]);
+    error += crossEntropy(&network, values, targets);
+    network.getResults(results);
+    batchResults.insert(batchResults.end(), results.begin(), results.end());
+  }
+  results = batchResults;
+  network.trainBatch(batchValues, batchTargets, TEST_SOFTMAX_SAMPLES);
+  network.getBatchResults(batchResults);
+  for (valueIterator = 0; valueIterator < results.size(); ++valueIterator) {
+    failed |= fabs(batchResults[valueIterator] - results[valueIterator]) > 1e-12;
+  }
+  failed |= fabs(network.getError() - error / TEST_SOFTMAX_SAMPLES) > 1e-12;
+  report("softmax_batch", "dense", failed);
+}
+
+//Checks graph storage trains the same as dense storage and learns xor
+static void checkGraph()
+{
+  std::mt19937 generator(TEST_SEED);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::vector<unsigned> topology;
+  std::vector<double> values;
+  std::vector<double> targets;
+  std::vector<double> graphResults;
+  std::vector<double> denseResults;
+  unsigned stepIterator;
+  unsigned valueIterator;
+  unsigned passIterator;
+  unsigned sampleIterator;
+  double largest;
+
+  //The same seed gives both storages the same weights, so every step must give the same outputs
+  topology.push_back(5);
+  topology.push_back(7);
+  topology.push_back(6);
+  topology.push_back(3);
+  neural::Network graph(topology, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_GRAPH);
+  neural::Network dense(topology, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_DENSE);
+  values.resize(5);
+  targets.resize(3);
+  largest = 0.0;
+  for (stepIterator = 0; stepIterator < TEST_GRAPH_STEPS; ++stepIterator) {
+    for (valueIterator = 0; valueIterator < values.size(); ++valueIterator) {
+      values[valueIterator] = uniform(generator);
+    }
+    for (valueIterator = 0; valueIterator < targets.size(); ++valueIterator) {
+      targets[valueIterator] = uniform(generator);
+    }
+    graph.feedForward(values);
+    dense.feedForward(values);
+    graph.getResults(graphResults);
+    dense.getResults(denseResults);
+    for (valueIterator = 0; valueIterator < graphResults.size(); ++valueIterator) {
+      largest = std::max(largest, fabs(graphResults[valueIterator] - denseResults[valueIterator]));
+    }
+    graph.backPropagation(targets);
+    dense.backPropagation(targets);
+  }
+  report("graph_vs_dense", "outputs", largest > TEST_GRAPH_TOLERANCE);
+
+  //Xor needs the hidden layer, so it is only learned if back propagation reads the weights it updates
+  topology.clear();
+  topology.push_back(2);
+  topology.push_back(4);
+  topology.push_back(1);
+  neural::Network xorNetwork(topology, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_GRAPH);
+  values.resize(2);
+  targets.resize(1);
+  largest = 0.0;
+  for (passIterator = 0; passIterator < TEST_XOR_PASSES; ++passIterator) {
+    largest = 0.0;
+    for (sampleIterator = 0; sampleIterator < 4; ++sampleIterator) {
+      values[0] = sampleIterator & 1;
+      values[1] = sampleIterator >> 1;
+      targets[0] = (sampleIterator & 1) ^ (sampleIterator >> 1);
+      xorNetwork.feedForward(values);
+      xorNetwork.getResults(graphResults);
+      largest = std::max(largest, fabs(graphResults[0] - targets[0]));
+      xorNetwork.backPropagation(targets);
+    }
+  }
+  report("graph_xor", "converged", largest > TEST_XOR_ERROR);
+}
+
+//Builds a network of sparse layers holding every connection of a dense network
+static void copySparse(neural::Network* dense_in, neural::Network* sparse_out)
+{
+  connection_data connection;
+  neural::Layer* layer;
+  unsigned layerIterator;
+  unsigned neuronIterator;
+  unsigned inputIterator;
+
+  for (layerIterator = 2; layerIterator <= dense_in->numLayers(); ++layerIterator) {
+    layer = dense_in->getLayer(layerIterator);
+    connection.source.layer = layerIterator - 2;
+    connection.destination.layer = layerIterator - 1;
+    for (neuronIterator = 0; neuronIterator < layer->numNeurons() - layer->numBias(); ++neuronIterator) {
+      connection.destination.neuron = neuronIterator;
+      for (inputIterator = 0; inputIterator < layer->numInputs(); ++inputIterator) {
+        connection.source.neuron = inputIterator;
+        connection.weight = layer->getWeight(neuronIterator, inputIterator);
+        connection.deltaWeight = layer->getDeltaWeight(neuronIterator, inputIterator);
+        sparse_out->createConnection(connection);
+      }
+    }
+  }
+}
+
+//Checks a sparse network holding every connection trains the same as the dense network
+static void checkSparse()
+{
+  std::mt19937 generator(TEST_SEED);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::vector<unsigned> topology;
+  std::vector<double> values;
+  std::vector<double> targets;
+  std::vector<double> sparseResults;
+  std::vector<double> denseResults;
+  unsigned stepIterator;
+  unsigned valueIterator;
+  double largest;
+
+  topology.push_back(5);
+  topology.push_back(8);
+  topology.push_back(4);
+  neural::Network dense(topology, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_DENSE);
+  neural::Network sparse(topology, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_SPARSE);
+  copySparse(&dense, &sparse);
+
+  //Each step runs the compressed rows forward and the transposed columns backward
+  values.resize(5);
+  targets.resize(4);
+  largest = 0.0;
+  for (stepIterator = 0; stepIterator < TEST_SPARSE_STEPS; ++stepIterator) {
+    for (valueIterator = 0; valueIterator < values.size(); ++valueIterator) {
+      values[valueIterator] = uniform(generator);
+    }
+    for (valueIterator = 0; valueIterator < targets.size(); ++valueIterator) {
+      targets[valueIterator] = uniform(generator);
+    }
+    sparse.feedForward(values);
+    dense.feedForward(values);
+    sparse.getResults(sparseResults);
+    dense.getResults(denseResults);
+    for (valueIterator = 0; valueIterator < sparseResults.size(); ++valueIterator) {
+      largest = std::max(largest, fabs(sparseResults[valueIterator] - denseResults[valueIterator]));
+    }
+    sparse.backPropagation(targets);
+    dense.backPropagation(targets);
+  }
+  report("sparse_vs_dense", "outputs", largest > TEST_SPARSE_TOLERANCE || sparse.getLayer(2)->numConnections() != dense.getLayer(2)->numConnections());
+}
+
+//Checks pruning reports what it removed and only the remaining connections are written
+static void checkPrune()
+{
+  std::vector<double> values;
+  std::vector<double> prunedResults;
+  std::vector<double> readResults;
+  unsigned long long total;
+  unsigned long long kept;
+  unsigned long long written;
+  unsigned long long offsets;
+  neural::Layer* layer;
+  unsigned layerIterator;
+  unsigned neuronIterator;
+  unsigned inputIterator;
+  unsigned valueIterator;
+  prune_data pruned;
+  FILE* file;
+  unsigned failed;
+
+  //Count what the threshold should keep before pruning
+  neural::Network network = trainerNetwork();
+  total = 0;
+  kept = 0;
+  offsets = 0;
+  for (layerIterator = 2; layerIterator <= network.numLayers(); ++layerIterator) {
+    layer = network.getLayer(layerIterator);
+    offsets += layer->numNeurons() - layer->numBias() + 1;
+    for (neuronIterator = 0; neuronIterator < layer->numNeurons() - layer->numBias(); ++neuronIterator) {
+      for (inputIterator = 0; inputIterator < layer->numInputs(); ++inputIterator) {
+        ++total;
+        kept += fabs(layer->getWeight(neuronIterator, inputIterator)) >= TEST_PRUNE_THRESHOLD;
+      }
+    }
+  }
+  network.prune(TEST_PRUNE_THRESHOLD, &pruned);
+  failed = kept == 0 || kept == total;
+  failed |= pruned.connectionsBefore != total || pruned.connectionsAfter != kept;
+  failed |= pruned.flopsBefore != 2 * total || pruned.flopsAfter != 2 * kept;
+  //Dense weights cost a double each, sparse entries a double and a column index plus each row's start
+  failed |= pruned.bytesBefore != total * sizeof(double) || pruned.bytesAfter != kept * (sizeof(double) + sizeof(unsigned)) + offsets * sizeof(unsigned);
+  failed |= network.getStorage() != NEURAL_STORAGE_SPARSE;
+  report("prune", "counts", failed);
+
+  //Write the pruned network and read it back into sparse storage
+  file = tmpfile();
+  if (file == NULL) {
+    throw std::runtime_error("Unable to create a temporary file");
+  }
+  {
+    StreamWriter writer(file);
+    writer.write(&network);
+  }
+  rewind(file);
+  neural::Network reread;
+  StreamReader reader(file);
+  reader.read(&reread, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_SPARSE);
+  fclose(file);
+
+  //Only the remaining connections are written, with their weights, counted once the forward pass has compressed them
+  values.resize(6);
+  for (valueIterator = 0; valueIterator < values.size(); ++valueIterator) {
+    values[valueIterator] = 0.1 * valueIterator - 0.25;
+  }
+  network.feedForward(values);
+  reread.feedForward(values);
+  network.getResults(prunedResults);
+  reread.getResults(readResults);
+  written = 0;
+  for (layerIterator = 2; layerIterator <= reread.numLayers(); ++layerIterator) {
+    written += reread.getLayer(layerIterator)->numConnections();
+  }
+  report("prune", "written", written != kept || prunedResults != readResults);
+}
+
+//Checks the int8 network stays close to the double network and reads back from its file unchanged
+static void checkQuantized()
+{
+  std::mt19937 generator(TEST_SEED);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::vector<std::vector<double> > samples;
+  std::vector<double> results;
+  std::vector<double> quantizedResults;
+  std::vector<double> readResults;
+  unsigned sampleIterator;
+  unsigned valueIterator;
+  unsigned granularity;
+  double largest;
+  unsigned failed;
+  FILE* file;
+
+  neural::Network network = trainerNetwork();
+  samples.resize(TEST_QUANTIZED_SAMPLES);
+  for (sampleIterator = 0; sampleIterator < samples.size(); ++sampleIterator) {
+    samples[sampleIterator].resize(6);
+    for (valueIterator = 0; valueIterator < 6; ++valueIterator) {
+      samples[sampleIterator][valueIterator] = uniform(generator);
+    }
+  }
+
+  for (granularity = NEURAL_QUANTIZE_PER_ROW; granularity <= NEURAL_QUANTIZE_PER_LAYER; ++granularity) {
+    neural::QuantizedNetwork quantized(&network, samples, activation, granularity);
+
+    //Write the int8 network and read it back
+    file = tmpfile();
+    if (file == NULL) {
+      throw std::runtime_error("Unable to create a temporary file");
+    }
+    quantized.write(file);
+    rewind(file);
+    neural::QuantizedNetwork reread(file, activation);
+    fclose(file);
+
+    //Every sample is close to the double network and the same after the round trip
+    largest = 0.0;
+    failed = 0;
+    for (sampleIterator = 0; sampleIterator < samples.size(); ++sampleIterator) {
+      network.feedForward(samples[sampleIterator]);
+      network.getResults(results);
+      quantized.feedForward(samples[sampleIterator]);
+      quantized.getResults(quantizedResults);
+      reread.feedForward(samples[sampleIterator]);
+      reread.getResults(readResults);
+      for (valueIterator = 0; valueIterator < results.size(); ++valueIterator) {
+        largest = std::max(largest, fabs(quantizedResults[valueIterator] - results[valueIterator]));
+      }
+      failed |= readResults != quantizedResults;
+    }
+    report("quantized", granularity == NEURAL_QUANTIZE_PER_ROW ? "per_row" : "per_layer", failed || largest > TEST_QUANTIZED_TOLERANCE);
+  }
+}
+
+//Checks a frozen copy gives the network's outputs, dense and once pruned to sparse
+static void checkFrozen()
+{
+  std::mt19937 generator(TEST_SEED);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::vector<double> values;
+  std::vector<double> results;
+  std::vector<double> frozenResults;
+  std::vector<double> scratch;
+  unsigned storageIterator;
+  unsigned sampleIterator;
+  unsigned valueIterator;
+  unsigned failed;
+
+  neural::Network network = trainerNetwork();
+  values.resize(6);
+  for (storageIterator = 0; storageIterator < 2; ++storageIterator) {
+    if (storageIterator == 1) {
+      network.prune(TEST_PRUNE_THRESHOLD);
+    }
+    neural::FrozenNetwork frozen = network.freeze();
+    failed = 0;
+    for (sampleIterator = 0; sampleIterator < TEST_QUANTIZED_SAMPLES; ++sampleIterator) {
+      for (valueIterator = 0; valueIterator < values.size(); ++valueIterator) {
+        values[valueIterator] = uniform(generator);
+      }
+      network.feedForward(values);
+      network.getResults(results);
+      frozen.feedForward(values, frozenResults, scratch);
+      failed |= frozenResults.size() != results.size();
+      for (valueIterator = 0; valueIterator < results.size() && ! failed; ++valueIterator) {
+        failed |= fabs(frozenResults[valueIterator] - results[valueIterator]) > TEST_FROZEN_TOLERANCE;
+      }
+    }
+    report("frozen", storageIterator == 0 ? "dense" : "sparse", failed);
+  }
+}
+
+//Checks weights drawn on threads while the network is built match a serial build, and unknown distributions are refused
+static void checkInitializer()
+{
+  std::vector<unsigned> topology;
+  std::vector<double> serial;
+  std::vector<double> threaded;
+  unsigned failed;
+
+  //Rows enough that every thread of the pool draws some
+  topology.push_back(300);
+  topology.push_back(400);
+  topology.push_back(200);
+  neural::Network single(topology, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_DENSE, NEURAL_PRECISION_DOUBLE, neural::Initializer(NEURAL_INIT_XAVIER, 42));
+  neural::Network pooled(topology, activation, activationDerivative, deltaInputWeight, NEURAL_STORAGE_DENSE, NEURAL_PRECISION_DOUBLE, neural::Initializer(NEURAL_INIT_XAVIER, 42), 4);
+  serial = trainerWeights(&single);
+  threaded = trainerWeights(&pooled);
+  report("initializer", "threads", pooled.numThreads() != 4 || serial.size() != threaded.size() || memcmp(serial.data(), threaded.data(), serial.size() * sizeof(double)) != 0);
+
+  failed = 1;
+  try {
+    neural::Initializer unknown(NEURAL_INIT_HE + 1);
+  } catch (std::runtime_error& error) {
+    failed = 0;
+  }
+  report("initializer", "unknown", failed);
+}
+
+//Writes a sample file of one header followed by two samples of a double input and a double target
+static void writeSamples(const char* path_in, uint64_t samples_in, uint64_t stride_in)
+{
+  sample_header header;
+  double values[4];
+  FILE* file;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, NEURAL_SAMPLES_MAGIC, sizeof(header.magic));
+  header.version = NEURAL_SAMPLES_VERSION;
+  header.scalarSize = sizeof(double);
+  header.inputs = 1;
+  header.targets = 1;
+  header.samples = samples_in;
+  header.stride = stride_in;
+  header.offset = sizeof(header);
+  values[0] = 0.25;
+  values[1] = 0.5;
+  values[2] = 0.75;
+  values[3] = 1.0;
+  file = fopen(path_in, "wb");
+  if (file == NULL) {
+    throw std::runtime_error("Unable to create a temporary file");
+  }
+  fwrite(&header, sizeof(header), 1, file);
+  fwrite(values, sizeof(values), 1, file);
+  fclose(file);
+}
+
+//Checks a mapped sample file is only accepted when every sample its header promises is inside it
+static void checkMappedSamples()
+{
+  char path[] = "/tmp/neural_test_XXXXXX";
+  unsigned failed;
+  int descriptor;
+
+  descriptor = mkstemp(path);
+  if (descriptor < 0) {
+    throw std::runtime_error("Unable to create a temporary file");
+  }
+  close(descriptor);
+
+  //Two samples fit
+  writeSamples(path, 2, 2 * sizeof(double));
+  {
+    neural::MappedSamples samples(path, 2);
+    report("mapped_samples", "valid", samples.numSamples() != 2 || samples.next()->samples != 2);
+  }
+
+  //A count and stride whose product wraps to a small offset must be refused, as must one sample too many
+  failed = 0;
+  writeSamples(path, (1ull << 61) + 1, 8 * sizeof(double));
+  try {
+    neural::MappedSamples samples(path, 2);
+    failed = 1;
+  } catch (std::runtime_error& error) {
+  }
+  writeSamples(path, 3, 2 * sizeof(double));
+  try {
+    neural::MappedSamples samples(path, 2);
+    failed = 1;
+  } catch (std::runtime_error& error) {
+  }
+  report("mapped_samples", "truncated", failed);
+  unlink(path);
+}
+
+int main()
+{
+  unsigned kernelIterator;
+
+  try {
+    //Every implementation this processor runs is checked through the same pointers the layers call
+    for (kernelIterator = NEURAL_KERNEL_SCALAR; kernelIterator <= neural::kernels::detect(); ++kernelIterator) {
+      neural::kernels::select(kernelIterator);
+      checkKernels(neural::kernels::name(kernelIterator));
+    }
+    for (; kernelIterator <= NEURAL_KERNEL_AVX512; ++kernelIterator) {
+      printf("%-24s %-8s skipped, not supported by this processor\n", "kernel", neural::kernels::name(kernelIterator));
+    }
+    neural::kernels::select(neural::kernels::detect());
+
+    checkTrainer();
+    checkEmptyBatch();
+    checkSoftmax();
+    checkGraph();
+    checkSparse();
+    checkPrune();
+    checkQuantized();
+    checkFrozen();
+    checkInitializer();
+    checkMappedSamples();
+  } catch (std::exception& error) {
+    fprintf(stderr, "%s\n", error.what());
+    return 1;
+  }
+
+  printf("%u failed\n", failures);
+  return failures > 0;
+}